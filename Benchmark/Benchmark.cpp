@@ -0,0 +1,617 @@
+
+#include "TinyJson.h"
+#include "LegacyTinyJson.h"
+#include "Corpus.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <sstream>
+
+using namespace std;
+using namespace TinyJson;
+
+// Every allocation in the process goes through these, so the counts include
+// the standard containers used by the code under test.
+static atomic<uint64_t> allocationCount(0);
+
+void *operator new(size_t size)
+{
+    allocationCount.fetch_add(1, memory_order_relaxed);
+
+    if( void *const pData = malloc(size ? size : 1) )
+        return pData;
+
+    throw bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *pData) noexcept
+{
+    free(pData);
+}
+
+void operator delete[](void *pData) noexcept
+{
+    free(pData);
+}
+
+void operator delete(void *pData, size_t) noexcept
+{
+    free(pData);
+}
+
+void operator delete[](void *pData, size_t) noexcept
+{
+    free(pData);
+}
+
+// Typed targets for the Convert and ReadAs cases
+struct User
+{
+    uint64_t id;
+    string name;
+    string screen_name;
+    int followers_count;
+};
+
+struct Status
+{
+    uint64_t id;
+    string text;
+    User user;
+    int retweet_count;
+    bool favorited;
+};
+
+struct Timeline
+{
+    vector<Status> statuses;
+};
+
+struct Geometry
+{
+    string type;
+    vector<vector<vector<double>>> coordinates;
+};
+
+struct Feature
+{
+    string type;
+    Geometry geometry;
+};
+
+struct FeatureCollection
+{
+    string type;
+    vector<Feature> features;
+};
+
+TinyJson_Fields(User, id, name, screen_name, followers_count)
+TinyJson_Fields(Status, id, text, user, retweet_count, favorited)
+TinyJson_Fields(Timeline, statuses)
+TinyJson_Fields(Geometry, type, coordinates)
+TinyJson_Fields(Feature, type, geometry)
+TinyJson_Fields(FeatureCollection, type, features)
+
+// One row of the report. speedup is against the legacy reader and only set
+// for the Read case when --compare is given.
+struct Result
+{
+    string corpus;
+    string name;
+    uint64_t bytes;
+    uint64_t documents;
+    uint64_t iterations;
+    double seconds;
+    double mbPerSecond;
+    double allocationsPerDocument;
+    double speedup;
+};
+
+struct Report
+{
+    string version;
+    vector<Result> results;
+};
+
+TinyJson_Fields(Result, corpus, name, bytes, documents, iterations, seconds, mbPerSecond, allocationsPerDocument, speedup)
+TinyJson_Fields(Report, version, results)
+
+struct Options
+{
+    string filter;
+    string baseline;
+    double minTime;
+    double scale;
+    double tolerance;
+    unsigned threads;
+    bool json;
+    bool compare;
+
+    Options() :
+        minTime(0.5),
+        scale(1.0),
+        tolerance(0.1),
+        threads(0),
+        json(false),
+        compare(false)
+    {
+    }
+};
+
+struct CorpusData
+{
+    string name;
+    string json;
+    vector<string> lines;
+
+    // Number of documents in one pass: one per line for JSON Lines.
+    size_t Documents() const
+    {
+        return lines.empty() ? 1 : lines.size();
+    }
+};
+
+struct Case
+{
+    string name;
+    function<void()> run;
+};
+
+struct NullHandler : public HandlerBase<NullHandler>
+{
+};
+
+// Keeps the optimizer from dropping results that are never read.
+static volatile size_t sink;
+
+static vector<string> SplitLines(const string &json)
+{
+    vector<string> lines;
+
+    istringstream stream(json);
+    for( string line; getline(stream, line); )
+    {
+        if( !line.empty() )
+            lines.push_back(line);
+    }
+
+    return lines;
+}
+
+static vector<CorpusData> MakeCorpora(const double scale)
+{
+    const auto scaled = [scale](const size_t count)
+    {
+        return max<size_t>(1, static_cast<size_t>(count * scale));
+    };
+
+    vector<CorpusData> corpora(4);
+
+    corpora[0].name = "twitter";
+    corpora[0].json = Corpus::Twitter(scaled(1000));
+
+    corpora[1].name = "canada";
+    corpora[1].json = Corpus::Canada(scaled(100000));
+
+    corpora[2].name = "nested";
+    corpora[2].json = Corpus::Nested(scaled(20000), 24);
+
+    corpora[3].name = "ndjson";
+    corpora[3].json = Corpus::Lines(scaled(20000));
+    corpora[3].lines = SplitLines(corpora[3].json);
+
+    return corpora;
+}
+
+// Calls fn on every document of the corpus.
+template <class Fn>
+static void ForEachDocument(const CorpusData &corpus, Fn fn)
+{
+    if( corpus.lines.empty() )
+    {
+        fn(corpus.json);
+        return;
+    }
+
+    for( const auto &line: corpus.lines )
+        fn(line);
+}
+
+// The legacy reader predates several fixes, e.g. it rejects empty arrays.
+static bool LegacyAccepts(const CorpusData &corpus)
+{
+    try
+    {
+        ForEachDocument(corpus, [](const string &json) { LegacyTinyJson::Read(json.c_str()); });
+        return true;
+    }
+    catch(const exception &e)
+    {
+        cerr << "Skipping Legacy Read on " << corpus.name << ": " << e.what() << endl;
+        return false;
+    }
+}
+
+static vector<Case> MakeCases(const CorpusData &corpus, const Options &options)
+{
+    const CorpusData *const pCorpus = &corpus;
+    vector<Case> cases;
+
+    cases.push_back({ "Read", [pCorpus]
+    {
+        ForEachDocument(*pCorpus, [](const string &json) { sink = Read(json)->IsNull(); });
+    } });
+
+    cases.push_back({ "Parse (SAX)", [pCorpus]
+    {
+        ForEachDocument(*pCorpus, [](const string &json)
+        {
+            NullHandler handler;
+            Parse(json, handler);
+        });
+    } });
+
+    cases.push_back({ "Validate", [pCorpus]
+    {
+        ForEachDocument(*pCorpus, [](const string &json) { sink = Validate(json).ok; });
+    } });
+
+    // The document is reused, as a long-running service would.
+    const auto pDocument = make_shared<Document>();
+
+    cases.push_back({ "Document::Parse", [pCorpus, pDocument]
+    {
+        ForEachDocument(*pCorpus, [&](const string &json) { pDocument->Parse(json); });
+    } });
+
+    cases.push_back({ "Document::ParseView", [pCorpus, pDocument]
+    {
+        ForEachDocument(*pCorpus, [&](const string &json) { pDocument->ParseView(json); });
+    } });
+
+    // The input is overwritten, so each pass parses a fresh copy of it.
+    const auto pBuffer = make_shared<string>();
+
+    cases.push_back({ "Document::ParseInSitu", [pCorpus, pDocument, pBuffer]
+    {
+        ForEachDocument(*pCorpus, [&](const string &json)
+        {
+            pBuffer->assign(json);
+            pDocument->ParseInSitu(*pBuffer);
+        });
+    } });
+
+    const auto pParser = make_shared<Parser>();
+
+    cases.push_back({ "Parser::Parse", [pCorpus, pParser]
+    {
+        ForEachDocument(*pCorpus, [&](const string &json) { sink = pParser->Parse(json).IsNull(); });
+    } });
+
+    const auto pTapeDocument = make_shared<TapeDocument>();
+
+    cases.push_back({ "TapeDocument::Parse", [pCorpus, pTapeDocument]
+    {
+        ForEachDocument(*pCorpus, [&](const string &json) { pTapeDocument->Parse(json); });
+    } });
+
+    if( corpus.name == "twitter" )
+    {
+        cases.push_back({ "Read+Convert", [pCorpus]
+        {
+            sink = Convert<Timeline>(Read(pCorpus->json)).statuses.size();
+        } });
+
+        cases.push_back({ "ReadAs", [pCorpus]
+        {
+            sink = ReadAs<Timeline>(pCorpus->json).statuses.size();
+        } });
+
+        cases.push_back({ "LazyDocument", [pCorpus]
+        {
+            const LazyDocument document(pCorpus->json);
+            sink = document["statuses"][0]["user"]["screen_name"].Get<string>().size();
+        } });
+    }
+    else if( corpus.name == "canada" )
+    {
+        cases.push_back({ "Read+Convert", [pCorpus]
+        {
+            sink = Convert<FeatureCollection>(Read(pCorpus->json)).features.size();
+        } });
+
+        cases.push_back({ "ReadAs", [pCorpus]
+        {
+            sink = ReadAs<FeatureCollection>(pCorpus->json).features.size();
+        } });
+
+        cases.push_back({ "LazyDocument", [pCorpus]
+        {
+            const LazyDocument document(pCorpus->json);
+            sink = document["features"][0]["geometry"]["type"].Get<string>().size();
+        } });
+    }
+    else if( corpus.name == "nested" )
+    {
+        const unsigned threads = options.threads;
+        const auto pArray = make_shared<ArrayDocument>();
+
+        cases.push_back({ "ArrayDocument", [pCorpus, pArray, threads]
+        {
+            BatchOptions batch;
+            batch.threadCount = threads;
+
+            pArray->Parse(pCorpus->json, batch);
+            sink = pArray->size();
+        } });
+    }
+    else if( corpus.name == "ndjson" )
+    {
+        const unsigned threads = options.threads;
+        const auto pLines = make_shared<LinesDocument>();
+
+        cases.push_back({ "LinesDocument", [pCorpus, pLines, threads]
+        {
+            BatchOptions batch;
+            batch.threadCount = threads;
+
+            pLines->Parse(pCorpus->json, batch);
+            sink = pLines->size();
+        } });
+    }
+
+    if( corpus.lines.empty() )
+    {
+        const auto pSource = make_shared<Document>();
+        pSource->Parse(corpus.json);
+
+        cases.push_back({ "ToString", [pSource]
+        {
+            sink = ToString(pSource->Root()).size();
+        } });
+
+        cases.push_back({ "Transcode", [pCorpus]
+        {
+            sink = Transcode(pCorpus->json).size();
+        } });
+
+        // Every pass after the first is a hit: a hash, a compare and a lookup.
+        const auto pCache = make_shared<DocumentCache>();
+
+        cases.push_back({ "DocumentCache", [pCorpus, pCache]
+        {
+            sink = pCache->Parse(pCorpus->json)->Root().IsNull();
+        } });
+    }
+
+    if( options.compare && LegacyAccepts(corpus) )
+    {
+        cases.push_back({ "Legacy Read", [pCorpus]
+        {
+            ForEachDocument(*pCorpus, [](const string &json) { sink = LegacyTinyJson::Read(json.c_str())->IsNull(); });
+        } });
+    }
+
+    return cases;
+}
+
+static Result Run(const CorpusData &corpus, const Case &benchmark, const Options &options)
+{
+    typedef chrono::steady_clock Clock;
+
+    // Warm up the caches and any pooled buffers.
+    benchmark.run();
+
+    const uint64_t allocationsBefore = allocationCount.load();
+    const auto start = Clock::now();
+
+    uint64_t iterations = 0;
+    double seconds = 0;
+
+    do
+    {
+        benchmark.run();
+        ++iterations;
+
+        seconds = chrono::duration<double>(Clock::now() - start).count();
+    }
+    while( seconds < options.minTime );
+
+    const uint64_t allocations = allocationCount.load() - allocationsBefore;
+
+    Result result;
+    result.corpus = corpus.name;
+    result.name = benchmark.name;
+    result.bytes = corpus.json.size();
+    result.documents = corpus.Documents();
+    result.iterations = iterations;
+    result.seconds = seconds;
+    result.mbPerSecond = static_cast<double>(corpus.json.size()) * iterations / seconds / (1024 * 1024);
+    result.allocationsPerDocument = static_cast<double>(allocations) / (iterations * corpus.Documents());
+    result.speedup = 0;
+
+    return result;
+}
+
+static void SetSpeedups(vector<Result> &results)
+{
+    for( const auto &legacy: results )
+    {
+        if( legacy.name != "Legacy Read" )
+            continue;
+
+        for( auto &result: results )
+        {
+            if( result.corpus == legacy.corpus && result.name == "Read" )
+                result.speedup = result.mbPerSecond / legacy.mbPerSecond;
+        }
+    }
+}
+
+static void PrintTable(const vector<Result> &results)
+{
+    printf("%-8s %-22s %10s %10s %12s %8s\n", "corpus", "case", "size KB", "MB/s", "allocs/doc", "speedup");
+
+    for( const auto &result: results )
+    {
+        printf("%-8s %-22s %10.1f %10.1f %12.1f ", result.corpus.c_str(), result.name.c_str(),
+            result.bytes / 1024.0, result.mbPerSecond, result.allocationsPerDocument);
+
+        if( result.speedup > 0 )
+            printf("%7.2fx\n", result.speedup);
+        else
+            printf("%8s\n", "-");
+    }
+}
+
+// Compares throughput against an earlier --json report; returns false when a
+// case got slower than the tolerance allows.
+static bool CheckBaseline(const vector<Result> &results, const Options &options)
+{
+    ifstream file(options.baseline, ios::binary);
+    if( !file )
+        throw runtime_error("Unable to open baseline: " + options.baseline);
+
+    const string json((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    const auto baseline = ReadAs<Report>(json);
+
+    bool passed = true;
+    for( const auto &result: results )
+    {
+        for( const auto &previous: baseline.results )
+        {
+            if( previous.corpus != result.corpus || previous.name != result.name )
+                continue;
+
+            const double ratio = result.mbPerSecond / previous.mbPerSecond;
+            if( ratio < 1 - options.tolerance )
+            {
+                fprintf(stderr, "Regression: %s %s %.1f MB/s, baseline %.1f MB/s\n", result.corpus.c_str(),
+                    result.name.c_str(), result.mbPerSecond, previous.mbPerSecond);
+                passed = false;
+            }
+        }
+    }
+
+    return passed;
+}
+
+static void PrintUsage()
+{
+    cout <<
+        "Usage: Benchmark [options]\n"
+        "  --filter <text>      Only run cases whose \"corpus/case\" contains text\n"
+        "  --min-time <sec>     Minimum measuring time per case (default 0.5)\n"
+        "  --scale <factor>     Corpus size factor (default 1)\n"
+        "  --threads <n>        Threads for LinesDocument and ArrayDocument (default all cores)\n"
+        "  --compare            Also run the legacy reader and report the speedup\n"
+        "  --json               Print the results as JSON\n"
+        "  --baseline <file>    Fail if slower than a previous --json report\n"
+        "  --tolerance <ratio>  Allowed slowdown against the baseline (default 0.1)\n"
+        "  --quick              Tiny corpora and short runs, for smoke testing\n";
+}
+
+static Options ParseArguments(const int argc, char **argv)
+{
+    Options options;
+
+    for( int i = 1; i < argc; ++i )
+    {
+        const string arg = argv[i];
+
+        const auto next = [&]() -> string
+        {
+            if( i + 1 >= argc )
+                throw runtime_error("Missing value for " + arg);
+
+            return argv[++i];
+        };
+
+        if( arg == "--filter" )
+            options.filter = next();
+        else if( arg == "--min-time" )
+            options.minTime = stod(next());
+        else if( arg == "--scale" )
+            options.scale = stod(next());
+        else if( arg == "--threads" )
+            options.threads = static_cast<unsigned>(stoul(next()));
+        else if( arg == "--compare" )
+            options.compare = true;
+        else if( arg == "--json" )
+            options.json = true;
+        else if( arg == "--baseline" )
+            options.baseline = next();
+        else if( arg == "--tolerance" )
+            options.tolerance = stod(next());
+        else if( arg == "--quick" )
+        {
+            options.scale = 0.02;
+            options.minTime = 0;
+            options.compare = true;
+        }
+        else
+        {
+            PrintUsage();
+            throw runtime_error("Unknown option: " + arg);
+        }
+    }
+
+    return options;
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        const Options options = ParseArguments(argc, argv);
+        const vector<CorpusData> corpora = MakeCorpora(options.scale);
+
+        Report report;
+        report.version = "1";
+
+        for( const auto &corpus: corpora )
+        {
+            for( const auto &benchmark: MakeCases(corpus, options) )
+            {
+                if( (corpus.name + "/" + benchmark.name).find(options.filter) == string::npos )
+                    continue;
+
+                report.results.push_back(Run(corpus, benchmark, options));
+            }
+        }
+
+        SetSpeedups(report.results);
+
+        if( options.json )
+        {
+            WriteOptions writeOptions;
+            writeOptions.pretty = true;
+
+            cout << ToString(report, writeOptions) << endl;
+        }
+        else
+            PrintTable(report.results);
+
+        if( !options.baseline.empty() && !CheckBaseline(report.results, options) )
+            return 1;
+    }
+    catch(const exception &e)
+    {
+        cerr << "Benchmark failed" << endl;
+        cerr << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
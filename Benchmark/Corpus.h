@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+
+// Deterministic generators for the benchmark corpora. The shapes follow the
+// usual public JSON benchmarks: twitter.json (string heavy, many keys),
+// canada.json (number heavy), deeply nested documents and JSON Lines logs.
+namespace Corpus
+{
+    inline std::string Number(const double value)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+        return buffer;
+    }
+
+    inline std::string Text(std::mt19937_64 &random, const std::size_t words)
+    {
+        static const char *const pWords[] =
+        {
+            "json", "parser", "fast", "tiny", "header", "stream", "value", "number", "string",
+            "caf\xc3\xa9", "\xe6\x97\xa5\xe6\x9c\xac", "quote \\\"this\\\"", "line\\nbreak", "tab\\t", "slash\\/"
+        };
+
+        std::string text;
+        for( std::size_t i = 0; i < words; ++i )
+        {
+            if( i )
+                text += ' ';
+
+            text += pWords[random() % (sizeof(pWords) / sizeof(pWords[0]))];
+        }
+
+        return text;
+    }
+
+    // {"statuses": [...]} with nested users and entities, mostly strings.
+    inline std::string Twitter(const std::size_t statuses)
+    {
+        std::mt19937_64 random(1);
+
+        std::string json = "{\"statuses\": [";
+        for( std::size_t i = 0; i < statuses; ++i )
+        {
+            const std::uint64_t id = 505874924095815681ull + i * 7919;
+
+            json += i ? ",\n" : "\n";
+            json += "{\"created_at\": \"Sun Aug 31 00:29:15 +0000 2014\", \"id\": " + std::to_string(id) +
+                ", \"id_str\": \"" + std::to_string(id) + "\", \"text\": \"" + Text(random, 12 + random() % 12) +
+                "\", \"source\": \"<a href=\\\"http://example.com\\\" rel=\\\"nofollow\\\">client</a>\", \"truncated\": false, " +
+                "\"in_reply_to_status_id\": null, \"user\": {\"id\": " + std::to_string(random() % 3000000000ull) +
+                ", \"name\": \"" + Text(random, 2) + "\", \"screen_name\": \"user" + std::to_string(i) +
+                "\", \"location\": \"" + Text(random, 3) + "\", \"description\": \"" + Text(random, 15) +
+                "\", \"url\": null, \"protected\": false, \"followers_count\": " + std::to_string(random() % 100000) +
+                ", \"friends_count\": " + std::to_string(random() % 5000) + ", \"verified\": false, \"lang\": \"ja\"}, " +
+                "\"entities\": {\"hashtags\": [{\"text\": \"" + Text(random, 1) + "\", \"indices\": [" + std::to_string(random() % 50) +
+                ", " + std::to_string(50 + random() % 50) + "]}], \"urls\": [], \"user_mentions\": []}, " +
+                "\"retweet_count\": " + std::to_string(random() % 1000) + ", \"favorite_count\": " + std::to_string(random() % 1000) +
+                ", \"favorited\": false, \"retweeted\": false, \"lang\": \"ja\"}";
+        }
+
+        json += "\n]}";
+        return json;
+    }
+
+    // A GeoJSON feature collection whose polygons hold most of the bytes.
+    inline std::string Canada(const std::size_t points)
+    {
+        std::mt19937_64 random(2);
+        std::uniform_real_distribution<double> longitude(-141.0, -52.0), latitude(41.0, 83.0);
+
+        std::string json = "{\"type\": \"FeatureCollection\", \"features\": [{\"type\": \"Feature\", "
+            "\"properties\": {\"name\": \"Canada\"}, \"geometry\": {\"type\": \"Polygon\", \"coordinates\": [";
+
+        for( std::size_t i = 0; i < points; ++i )
+        {
+            if( i % 1000 == 0 )
+                json += i ? "]],\n[[" : "\n[[";
+            else
+                json += "],[";
+
+            json += Number(longitude(random)) + "," + Number(latitude(random));
+        }
+
+        json += "]]]}}]}";
+        return json;
+    }
+
+    // Many small records, each a chain of alternating objects and arrays.
+    inline std::string Nested(const std::size_t records, const std::size_t depth)
+    {
+        std::string json = "[";
+        for( std::size_t i = 0; i < records; ++i )
+        {
+            if( i )
+                json += ",";
+
+            for( std::size_t level = 0; level < depth; ++level )
+                json += level % 2 ? "[" : "{\"k" + std::to_string(level) + "\": ";
+
+            json += std::to_string(i);
+
+            for( std::size_t level = depth; level-- > 0; )
+                json += level % 2 ? "]" : "}";
+        }
+
+        json += "]";
+        return json;
+    }
+
+    // One small event object per line.
+    inline std::string Lines(const std::size_t records)
+    {
+        std::mt19937_64 random(3);
+        static const char *const pEvents[] = { "click", "view", "purchase", "login", "logout" };
+
+        std::string json;
+        for( std::size_t i = 0; i < records; ++i )
+        {
+            json += "{\"id\": " + std::to_string(i) + ", \"event\": \"" + pEvents[random() % 5] +
+                "\", \"ts\": " + std::to_string(1400000000000ull + random() % 100000000) +
+                ", \"score\": " + Number(static_cast<double>(random() % 100000) / 1000) +
+                ", \"tags\": [\"a\", \"b\"], \"ok\": true}\n";
+        }
+
+        return json;
+    }
+}
@@ -16,6 +16,12 @@ void TestArray()
         CheckEqual(actual, vector<int>{10, 20, 30});
     }
 
+    // Empty arrays
+    {
+        auto value = Read(" [[], [ ]] ");
+        CheckEqual(Convert<vector<vector<int>>>(value), vector<vector<int>>{ {}, {} });
+    }
+
     // Array of arrays
     {
         auto value = Read(" [[1, 2], [3, 4]] ");
@@ -50,4 +56,30 @@ void TestArray()
         const auto actual = Convert<pair<string, int>>(value);
         CheckEqual(actual, make_pair(string("hello"), 10));
     }
+
+    // Moving out of the tree keeps the string buffers
+    {
+        auto value = Read(R"( [["a long string that is not stored inline", "b"], ["c"]] )");
+        const char *const pData = value->AsArray()[0]->AsArray()[0]->AsString().data();
+
+        const auto actual = Convert<vector<vector<string>>>(std::move(value));
+        Check(!value);
+        CheckEqual(actual, vector<vector<string>>{ { "a long string that is not stored inline", "b" }, { "c" } });
+        CheckEqual(actual[0][0].data(), pData);
+    }
+
+    // The tree's own containers are taken over whole
+    {
+        auto value = Read(R"( [1, [2], {"k" : "v"}] )");
+        const ValuePtr *const pItems = value->AsArray().data();
+
+        auto items = Convert<Array>(std::move(value));
+        CheckEqual(static_cast<const ValuePtr *>(items.data()), pItems);
+
+        const auto pair = Convert<std::pair<int, vector<int>>>(Read("[3, [4, 5]]"));
+        CheckEqual(pair.second.size(), size_t(2));
+
+        CheckEqual(Convert<map<string, string>>(std::move(items[2])).at("k"), string("v"));
+        CheckThrows([&] { Convert<Array>(std::move(items[0])); });
+    }
 }
@@ -0,0 +1,164 @@
+
+#include "TinyJson.h"
+#include "TestUtil.h"
+
+using namespace std;
+using namespace TinyJson;
+
+void TestArrayDocument()
+{
+    // Strings full of separators and escapes cross block boundaries
+    string data = "[";
+    for( int i = 0; i < 3000; ++i )
+    {
+        data += i ? ",\n " : "\n ";
+        data += "{\"id\": " + to_string(i) + ", \"text\": \"" + string(i % 70, 'x') + ",]}\\\"[{\\\\\", \"tags\": [[" + to_string(i % 7) + "], {}]}";
+    }
+    data += "\n] ";
+
+    BatchOptions options;
+    options.threadCount = 4;
+
+    // Elements come back in input order
+    {
+        ArrayDocument doc;
+        doc.Parse(data, options);
+
+        CheckEqual(doc.size(), size_t(3000));
+        for( size_t i = 0; i < doc.size(); ++i )
+        {
+            const auto obj = doc[i].AsObject();
+            CheckEqual(obj.at("id").AsInt64(), int64_t(i));
+            CheckEqual(obj.at("text").AsString().str(), string(i % 70, 'x') + ",]}\"[{\\");
+            CheckEqual(obj.at("tags").AsArray()[0].AsArray()[0].AsInt64(), int64_t(i % 7));
+        }
+
+        CheckEqual(doc.Root().AsArray().size(), size_t(3000));
+        CheckEqual(doc.Root().AsArray()[2999].AsObject().at("id").AsInt64(), int64_t(2999));
+    }
+
+    // Each thread converts its own slice
+    {
+        ArrayDocument doc;
+        doc.Parse(data.data(), data.size(), options);
+        CheckEqual(doc.size(), size_t(3000));
+
+        typedef map<string, int> Ids;
+        Check(Convert<vector<Ids>>(ArrayDocument(), options).empty());
+
+        string ids = "[";
+        for( int i = 0; i < 1000; ++i )
+            ids += (i ? ", " : "") + to_string(i * 3);
+        ids += "]";
+
+        doc.Parse(ids, options);
+        const auto values = Convert<vector<int>>(doc, options);
+        CheckEqual(values, Convert<vector<int>>(doc.Root()));
+        CheckEqual(values[999], 2997);
+
+        doc.Parse(R"([{"a" : 1}, {"b" : 2}])", options);
+        CheckEqual(Convert<vector<Ids>>(doc, options)[1].at("b"), 2);
+
+        doc.Parse(R"([1, 2, "three"])", options);
+        CheckThrows([&] { Convert<vector<int>>(doc, options); });
+    }
+
+    // Empty and nested arrays
+    {
+        ArrayDocument doc;
+        doc.Parse("[]");
+        Check(doc.empty());
+
+        doc.Parse(" [ \n ] ");
+        Check(doc.empty());
+        Check(doc.Root().AsArray().empty());
+
+        doc.Parse("[[]]");
+        CheckEqual(doc.size(), size_t(1));
+        Check(doc[0].AsArray().empty());
+    }
+
+    // Malformed input is rejected as Read would
+    {
+        ArrayDocument doc;
+        CheckThrows([&] { doc.Parse(" {}"); });
+        CheckThrows([&] { doc.Parse("1"); });
+
+        const char *const pInvalid[] =
+        {
+            "", "[1, 2", "[1,,2]", "[1,]", "[,1]", "[1 2]", "[1] x", "[\"a]", "[1}", "[{\"a\" : 1]}", "[[1}]"
+        };
+
+        for( const char *const pJson: pInvalid )
+        {
+            CheckThrows([&] { Read(pJson); });
+            CheckThrows([&] { doc.Parse(pJson, options); });
+            Check(doc.empty());
+        }
+
+        // Errors name the first failing element
+        try
+        {
+            doc.Parse("[1, 2, tru, [}]");
+            Check(false);
+        }
+        catch( const runtime_error &e )
+        {
+            CheckEqual(string(e.what()).substr(0, 10), string("element 2:"));
+        }
+
+        doc.Parse("[true]", options);
+        CheckEqual(doc[0].AsBoolean(), true);
+    }
+
+    // Parse limits count the enclosing array as Read does
+    {
+        ArrayDocument doc;
+        BatchOptions limited;
+        limited.threadCount = 2;
+        limited.parseOptions.maxDepth = 3;
+
+        const string nested = "[[1], [[2]], {\"a\": [3]}]";
+        doc.Parse(nested, limited);
+        CheckEqual(doc.size(), size_t(3));
+
+        limited.parseOptions.maxDepth = 2;
+        CheckThrows([&] { Read(nested, limited.parseOptions); });
+        CheckThrows([&] { doc.Parse(nested, limited); });
+
+        limited.parseOptions.maxDepth = 0;
+        CheckThrows([&] { doc.Parse("[]", limited); });
+
+        limited.parseOptions = ParseOptions();
+        limited.parseOptions.maxStringLength = 3;
+        CheckThrows([&] { doc.Parse("[\"abc\", \"abcd\"]", limited); });
+
+        // maxNodes bounds the whole array, not each element
+        string wide = "[";
+        for( int i = 0; i < 1000; ++i )
+            wide += (i ? ", " : "") + string("[1, 2]");
+        wide += "]";
+
+        limited.parseOptions = ParseOptions();
+        limited.parseOptions.maxNodes = 3001;
+        doc.Parse(wide, limited);
+        CheckEqual(doc.size(), size_t(1000));
+
+        limited.parseOptions.maxNodes = 3000;
+        CheckThrows([&] { Read(wide, limited.parseOptions); });
+        CheckThrows([&] { doc.Parse(wide, limited); });
+
+        limited.parseOptions.maxNodes = 1000;
+        CheckThrows([&] { doc.Parse(wide, limited); });
+        Check(doc.empty());
+
+        limited.parseOptions = ParseOptions();
+        limited.parseOptions.maxInputBytes = data.size() - 1;
+        CheckThrows([&] { doc.Parse(data, limited); });
+        CheckThrows([&] { doc.Parse(data.data(), data.size(), limited); });
+
+        limited.parseOptions.maxInputBytes = data.size();
+        doc.Parse(data.data(), data.size(), limited);
+        CheckEqual(doc.size(), size_t(3000));
+    }
+}
@@ -0,0 +1,163 @@
+
+#include "TinyJson.h"
+#include "TestUtil.h"
+
+using namespace std;
+using namespace TinyJson;
+
+namespace
+{
+    void TestHits()
+    {
+        DocumentCache cache;
+
+        const string text = R"({"name": "cached", "escaped": "a\nb", "values": [1, 2, 3]})";
+        const auto first = cache.Parse(text);
+        const auto second = cache.Parse(string(text));
+
+        // Equal inputs share one document
+        CheckEqual(first.get(), second.get());
+        CheckEqual(first->Root().AsObject().at("name").AsString(), StringView("cached"));
+        CheckEqual(first->Root().AsObject().at("escaped").AsString(), StringView("a\nb"));
+
+        // Inputs of equal length but different content do not
+        const auto other = cache.Parse(R"({"name": "cachee", "escaped": "a\nb", "values": [1, 2, 3]})");
+        CheckNotEqual(first.get(), other.get());
+        CheckEqual(other->Root().AsObject().at("name").AsString(), StringView("cachee"));
+
+        CacheStats stats = cache.Stats();
+        CheckEqual(stats.hits, size_t(1));
+        CheckEqual(stats.misses, size_t(2));
+        CheckEqual(stats.entries, size_t(2));
+        Check(stats.bytes > 2 * text.size());
+
+        // Failed parses are not cached
+        CheckThrows([&] { cache.Parse("[1,"); });
+        CheckThrows([&] { cache.Parse("[1,"); });
+        CheckEqual(cache.Stats().entries, size_t(2));
+
+        // The byte limit is checked before the input is copied
+        ParseOptions options;
+        options.maxInputBytes = text.size() - 1;
+        cache.SetParseOptions(options);
+        CheckThrows([&] { cache.Parse(text + " "); });
+
+        // Tighter limits drop the entries parsed under the old ones
+        CheckEqual(cache.Stats().entries, size_t(0));
+        CheckThrows([&] { cache.Parse(text); });
+
+        cache.SetParseOptions(ParseOptions());
+        CheckEqual(cache.Parse(text)->Root().AsObject().at("name").AsString(), StringView("cached"));
+        CheckNotEqual(cache.Parse(text).get(), first.get());
+
+        options = ParseOptions();
+        options.maxDepth = 1;
+        cache.SetParseOptions(options);
+        CheckThrows([&] { cache.Parse(text); });
+        cache.SetParseOptions(ParseOptions());
+
+        cache.Clear();
+        stats = cache.Stats();
+        CheckEqual(stats.hits + stats.misses + stats.entries + stats.bytes, size_t(0));
+
+        // A cleared cache parses again; held documents stay valid
+        CheckNotEqual(cache.Parse(text).get(), first.get());
+        CheckEqual(first->Root().AsObject().at("values").AsArray().size(), size_t(3));
+    }
+
+    void TestEviction()
+    {
+        DocumentCache cache(numeric_limits<size_t>::max(), 2);
+
+        const auto a = cache.Parse("[\"a\"]");
+        cache.Parse("[\"b\"]");
+
+        // Using a makes b the least recently used entry
+        CheckEqual(cache.Parse("[\"a\"]").get(), a.get());
+        cache.Parse("[\"c\"]");
+
+        CacheStats stats = cache.Stats();
+        CheckEqual(stats.entries, size_t(2));
+        CheckEqual(stats.evictions, size_t(1));
+
+        CheckEqual(cache.Parse("[\"a\"]").get(), a.get());
+        CheckEqual(cache.Stats().hits, size_t(2));
+
+        cache.Parse("[\"b\"]");
+        CheckEqual(cache.Stats().misses, size_t(4));
+
+        // Shrinking the budget evicts at once
+        cache.SetLimits(numeric_limits<size_t>::max(), 1);
+        CheckEqual(cache.Stats().entries, size_t(1));
+
+        cache.SetLimits(0, 1);
+        CheckEqual(cache.Stats().entries, size_t(0));
+        CheckEqual(cache.Stats().bytes, size_t(0));
+
+        // Inputs larger than the byte budget are parsed but not kept
+        cache.SetLimits(64 * 1024, 16);
+        const string large = "[\"" + string(100000, 'x') + "\"]";
+        const auto first = cache.Parse(large);
+        const auto second = cache.Parse(large);
+
+        CheckNotEqual(first.get(), second.get());
+        CheckEqual(second->Root().AsArray()[0].AsString().size(), size_t(100000));
+        CheckEqual(cache.Stats().entries, size_t(0));
+
+        // The byte budget bounds the total
+        for( int i = 0; i < 100; ++i )
+            cache.Parse("[\"" + string(1000, 'a' + i % 26) + to_string(i) + "\"]");
+
+        stats = cache.Stats();
+        Check(stats.bytes <= size_t(64 * 1024));
+        Check(stats.entries < 16);
+        Check(stats.evictions > 0);
+    }
+
+    void TestThreads()
+    {
+        DocumentCache cache;
+
+        vector<string> inputs;
+        for( int i = 0; i < 8; ++i )
+            inputs.push_back("{\"id\": " + to_string(i) + ", \"tags\": [\"x\", \"y\"]}");
+
+        const size_t threadCount = 4;
+        const size_t rounds = 500;
+        vector<int> failures(threadCount, 0);
+        vector<thread> threads;
+
+        for( size_t t = 0; t < threadCount; ++t )
+        {
+            threads.emplace_back([&, t]
+            {
+                for( size_t i = 0; i < rounds; ++i )
+                {
+                    const size_t n = (i * 7 + t) % inputs.size();
+                    const auto document = cache.Parse(inputs[n]);
+
+                    if( document->Root().AsObject().at("id").AsInt64() != int64_t(n) )
+                        ++failures[t];
+                }
+            });
+        }
+
+        for( auto &thread: threads )
+            thread.join();
+
+        for( const int failure: failures )
+            CheckEqual(failure, 0);
+
+        const CacheStats stats = cache.Stats();
+        CheckEqual(stats.hits + stats.misses, threadCount * rounds);
+        CheckEqual(stats.entries, inputs.size());
+        Check(stats.misses >= inputs.size());
+    }
+}
+
+void TestCache()
+{
+    TestHits();
+    TestEviction();
+    TestThreads();
+}
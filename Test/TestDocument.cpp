@@ -0,0 +1,73 @@
+
+#include "TinyJson.h"
+#include "TestUtil.h"
+
+using namespace std;
+using namespace TinyJson;
+
+void TestDocument()
+{
+    // Scalar values
+    {
+        Document doc;
+
+        doc.Parse(" -12.5 ");
+        CheckEqual(doc.Root().AsNumber(), -12.5);
+
+        doc.Parse(" true ");
+        CheckEqual(doc.Root().AsBoolean(), true);
+
+        doc.Parse(" null ");
+        Check(doc.Root().IsNull());
+    }
+
+    // Nested containers
+    {
+        Document doc;
+        doc.Parse(R"( {"name" : "tiny", "list" : [1, [2, 3], {}], "empty" : [], "flag" : false} )");
+        Check(doc.Root().IsObject());
+
+        const auto obj = doc.Root().AsObject();
+        CheckEqual(obj.size(), size_t(4));
+        CheckEqual(obj.at("name").AsString(), StringView("tiny"));
+        CheckEqual(obj.at("flag").AsBoolean(), false);
+        Check(obj.at("empty").AsArray().empty());
+
+        const auto list = obj.at("list").AsArray();
+        CheckEqual(list.size(), size_t(3));
+        CheckEqual(list[0].AsNumber(), 1.0);
+        CheckEqual(list[1].AsArray()[1].AsNumber(), 3.0);
+        Check(list[2].AsObject().empty());
+
+        CheckEqual(obj.count("missing"), size_t(0));
+        CheckThrows([&] { obj.at("missing"); });
+    }
+
+    // Iterator input and moving documents
+    {
+        const string data = R"( ["first", "second\tline"] )";
+
+        Document doc;
+        doc.Parse(data.begin(), data.end());
+
+        const Document moved(std::move(doc));
+        Check(doc.Root().IsNull());
+
+        const auto arr = moved.Root().AsArray();
+        CheckEqual(arr[0].AsString(), StringView("first"));
+        CheckEqual(arr[1].AsString().str(), string("second\tline"));
+    }
+
+    // Duplicate keys
+    {
+        Document doc;
+        CheckThrows([&] { doc.Parse(R"( {"a" : 1, "b" : 2, "a" : 3} )"); });
+
+        string data = "{";
+        for( int i = 0; i < 100; ++i )
+            data += "\"key" + to_string(i) + "\" : " + to_string(i) + ", ";
+        data += "\"key50\" : 0}";
+
+        CheckThrows([&] { doc.Parse(data.c_str()); });
+    }
+}
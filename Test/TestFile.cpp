@@ -0,0 +1,94 @@
+
+#include "TinyJson.h"
+#include "TestUtil.h"
+
+#include <cstdio>
+
+using namespace std;
+using namespace TinyJson;
+
+namespace
+{
+    const char *const pPath = "TinyJson_TestFile.json";
+
+    void WriteFile(const string &contents)
+    {
+        FILE *const pFile = fopen(pPath, "wb");
+        CheckNotNull(pFile);
+
+        fwrite(contents.data(), 1, contents.size(), pFile);
+        fclose(pFile);
+    }
+
+    string ReadFileError(const char *const pFile, const ParseOptions &options)
+    {
+        try
+        {
+            ReadFile(pFile, options);
+        }
+        catch( const runtime_error &e )
+        {
+            return e.what();
+        }
+
+        return string();
+    }
+}
+
+void TestFile()
+{
+    WriteFile(R"({"name": "mapped", "escaped": "a\nb", "values": [1, 2, 3]})");
+
+    const auto value = ReadFile(pPath);
+    CheckEqual(value->AsObject().at("name")->AsString(), string("mapped"));
+    CheckEqual(Convert<vector<int>>(value->AsObject().at("values")), vector<int>({ 1, 2, 3 }));
+
+    {
+        Document doc;
+        doc.ParseFile(pPath);
+
+        Document moved(std::move(doc));
+        CheckEqual(moved.Root().AsObject().at("name").AsString(), StringView("mapped"));
+        CheckEqual(moved.Root().AsObject().at("escaped").AsString(), StringView("a\nb"));
+    }
+
+    // Sizes that end exactly on a page boundary still see a terminator
+    for( const size_t size: { size_t(4096), size_t(16384), size_t(65536) } )
+    {
+        string contents = "[\"" + string(size - 6, 'x') + "\",1]";
+        WriteFile(contents);
+
+        const auto arr = ReadFile(pPath);
+        CheckEqual(arr->AsArray().size(), size_t(2));
+        CheckEqual(arr->AsArray()[0]->AsString().size(), size - 6);
+    }
+
+    // The byte limit applies before the file is mapped or read
+    {
+        WriteFile("[1, 2, 3]");
+
+        ParseOptions options;
+        options.maxInputBytes = 8;
+        CheckEqual(ReadFileError(pPath, options), string("input too large"));
+
+        Document doc;
+        doc.SetParseOptions(options);
+        CheckThrows([&] { doc.ParseFile(pPath); });
+
+        options.maxInputBytes = 9;
+        CheckEqual(ReadFile(pPath, options)->AsArray().size(), size_t(3));
+
+#ifdef __linux__
+        // procfs reports no size, so the file is read like a pipe
+        options.maxInputBytes = 16;
+        CheckEqual(ReadFileError("/proc/self/status", options), string("input too large"));
+        CheckNotEqual(ReadFileError("/proc/self/status", ParseOptions()), string("input too large"));
+#endif
+    }
+
+    WriteFile("");
+    CheckThrows([] { ReadFile(pPath); });
+
+    remove(pPath);
+    CheckThrows([] { ReadFile(pPath); });
+}
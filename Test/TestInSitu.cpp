@@ -0,0 +1,122 @@
+#include "TinyJson.h"
+#include "TestUtil.h"
+
+using namespace std;
+using namespace TinyJson;
+
+namespace
+{
+    struct TransientHandler : public HandlerBase<TransientHandler>
+    {
+        string strings;
+        size_t transient = 0;
+
+        void String(const StringView &str, const bool isTransient) { strings += str.str() + ","; transient += isTransient; }
+        void Key(const StringView &key, const bool isTransient) { String(key, isTransient); }
+    };
+
+    bool Inside(const string &buffer, const StringView &str)
+    {
+        return str.data() >= buffer.data() && str.data() + str.size() <= buffer.data() + buffer.size();
+    }
+}
+
+void TestInSitu()
+{
+    // Escapes are decoded inside the buffer and every string views it
+    {
+        string buffer = R"( {"plain" : "text", "esc\"key" : "a\tb\\c)" "\xc3\xa9\xf0\x9f\x98\x80" R"(!", "list" : ["\n", "", "x\/y"]} )";
+        const string original = buffer;
+
+        Document doc;
+        doc.ParseInSitu(buffer);
+
+        const auto obj = doc.Root().AsObject();
+        CheckEqual(obj.at("plain").AsString(), StringView("text"));
+        CheckEqual(obj.at("esc\"key").AsString().str(), string("a\tb\\c\xc3\xa9\xf0\x9f\x98\x80!"));
+        CheckEqual(obj.at("list").AsArray()[0].AsString(), StringView("\n"));
+        Check(obj.at("list").AsArray()[1].AsString().empty());
+        CheckEqual(obj.at("list").AsArray()[2].AsString(), StringView("x/y"));
+
+        // Strings are null-terminated in place
+        for( const auto &member: obj )
+        {
+            Check(Inside(buffer, member.key.AsString()));
+            CheckEqual(member.key.AsString().data()[member.key.AsString().size()], '\0');
+        }
+
+        const StringView escaped = obj.at("esc\"key").AsString();
+        Check(Inside(buffer, escaped));
+        CheckEqual(escaped.data()[escaped.size()], '\0');
+        Check(buffer != original);
+
+        Document copy;
+        copy.Parse(original);
+        CheckEqual(ToString(doc.Root()), ToString(copy.Root()));
+    }
+
+    // Escapes at every offset give the same values as Parse
+    {
+        const string text(40, 'x');
+        for( size_t i = 0; i <= text.size(); i += 3 )
+        {
+            string json = "[\"" + text + "\", \"" + text + "\"]";
+            json.insert(2 + i, "\\u0041\\\"");
+            json.insert(json.size() - 2 - i, "\\n");
+
+            string buffer = json;
+
+            Parser parser;
+            const Value &root = parser.ParseInSitu(&buffer[0], buffer.size());
+            CheckEqual(Convert<vector<string>>(root), Convert<vector<string>>(Read(json)));
+        }
+    }
+
+    // A reused parser keeps no string of its own
+    {
+        string json = "[";
+        for( int i = 0; i < 500; ++i )
+            json += (i ? ", " : "") + string(R"({"name\t" : "value\n)") + to_string(i) + R"("})";
+        json += "]";
+
+        Parser parser;
+        string buffer = json;
+        parser.ParseInSitu(buffer);
+        const size_t retained = parser.RetainedBytes();
+
+        buffer = json;
+        const auto arr = parser.ParseInSitu(buffer).AsArray();
+        CheckEqual(parser.RetainedBytes(), retained);
+        CheckEqual(arr[499].AsObject().at("name\t").AsString(), StringView("value\n499"));
+        Check(Inside(buffer, arr[499].AsObject().begin()->key.AsString()));
+    }
+
+    // Handlers only ever see strings that stay valid
+    {
+        char buffer[] = R"(["a\nb", {"k\"" : "plain"}])";
+
+        TransientHandler handler;
+        ParseInSitu(buffer, handler);
+        CheckEqual(handler.strings, string("a\nb,k\",plain,"));
+        CheckEqual(handler.transient, size_t(0));
+    }
+
+    // Malformed input is rejected as Parse would
+    {
+        for( const char *const pJson: { R"("abc)", R"("a\x")", R"("\ud83d")", "\"\xc3(\"", "[\"a\" 1]", "\"a\" x" } )
+        {
+            string buffer = pJson;
+
+            Document doc;
+            CheckThrows([&] { doc.ParseInSitu(buffer); });
+            Check(doc.Root().IsNull());
+        }
+
+        ParseOptions options;
+        options.maxStringLength = 2;
+
+        char buffer[] = R"(["aAB"])";
+        TransientHandler handler;
+        CheckThrows([&] { ParseInSitu(buffer, handler, options); });
+    }
+}
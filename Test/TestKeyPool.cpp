@@ -0,0 +1,58 @@
+
+#include "TinyJson.h"
+#include "TestUtil.h"
+
+using namespace std;
+using namespace TinyJson;
+
+void TestKeyPool()
+{
+    auto pool = make_shared<KeyPool>(3);
+
+    // Equal keys in different documents share one pooled copy
+    Document doc1, doc2;
+    doc1.SetKeyPool(pool);
+    doc2.SetKeyPool(pool);
+
+    doc1.Parse(R"({"id": 1, "name": "a", "nested": {"id": 2}})");
+    doc2.Parse(R"({"name": "b", "id": 3})");
+
+    const auto obj1 = doc1.Root().AsObject();
+    const auto obj2 = doc2.Root().AsObject();
+
+    CheckEqual(obj1.begin()[0].key.AsString().data(), obj2.begin()[1].key.AsString().data());
+    CheckEqual(obj1.begin()[1].key.AsString().data(), obj2.begin()[0].key.AsString().data());
+    CheckEqual(obj1.begin()[2].value.AsObject().begin()[0].key.AsString().data(), obj1.begin()[0].key.AsString().data());
+    CheckEqual(obj1.begin()[0].key.AsString().data(), pool->Find("id"));
+
+    // The pool is bounded; further keys are stored in the document
+    CheckEqual(pool->size(), size_t(3));
+    doc1.Parse(R"({"other": 1})");
+    CheckEqual(doc1.Root().AsObject().at("other").AsInt64(), int64_t(1));
+    CheckEqual(pool->Find("other"), static_cast<const char *>(nullptr));
+
+    // A frozen pool is shared by parallel readers
+    {
+        auto shared = make_shared<KeyPool>();
+        shared->Intern("id");
+        shared->Intern("tags");
+
+        BatchOptions options;
+        options.threadCount = 4;
+        options.keyPool = shared;
+
+        string data;
+        for( int i = 0; i < 500; ++i )
+            data += R"({"id": 1, "tags": [], "new": true})" "\n";
+
+        LinesDocument lines;
+        CheckThrows([&] { lines.Parse(data, options); });
+
+        shared->Freeze();
+        lines.Parse(data, options);
+
+        CheckEqual(shared->size(), size_t(2));
+        CheckEqual(lines[0].AsObject().begin()[0].key.AsString().data(), lines[499].AsObject().begin()[0].key.AsString().data());
+        CheckNotEqual(lines[0].AsObject().begin()[2].key.AsString().data(), lines[499].AsObject().begin()[2].key.AsString().data());
+    }
+}
@@ -0,0 +1,37 @@
+
+#include "TinyJson.h"
+#include "TestUtil.h"
+
+using namespace std;
+using namespace TinyJson;
+
+void TestLazy()
+{
+    const string json = R"( {
+        "skipped" : {"a" : [1, {"b" : "]}\"["}], "c" : "\\"},
+        "user" : {"name" : "lazy", "id" : 12345678901234, "tags" : ["x", "y\nz"]},
+        "values" : [1.5, 2.5, 3.5],
+        "bad" : [1, 2,
+    )";
+
+    const LazyDocument doc(json);
+
+    CheckEqual(doc["user"]["id"].Get<int64_t>(), int64_t(12345678901234));
+    CheckEqual(doc["user"]["name"].Get<string>(), string("lazy"));
+    CheckEqual(doc["user"]["tags"][1].Get<string>(), string("y\nz"));
+    CheckEqual(Convert<vector<double>>(doc["values"]), vector<double>({ 1.5, 2.5, 3.5 }));
+    CheckEqual(doc["values"][2].Get<double>(), 3.5);
+    CheckEqual(doc["user"]["tags"].Raw(), StringView(R"(["x", "y\nz"])"));
+
+    Check(doc["user"].IsObject());
+    Check(doc["values"].IsArray());
+    CheckEqual(doc["user"].count("missing"), size_t(0));
+
+    CheckThrows([&] { doc["missing"]; });
+    CheckThrows([&] { doc["values"][3]; });
+    CheckThrows([&] { doc["user"][0]; });
+
+    // Malformed parts only fail when they are reached
+    CheckThrows([&] { doc["bad"].Get<vector<int>>(); });
+    CheckThrows([&] { doc["after"]; });
+}
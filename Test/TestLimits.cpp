@@ -0,0 +1,152 @@
+
+#include "TinyJson.h"
+#include "TestUtil.h"
+
+using namespace std;
+using namespace TinyJson;
+
+namespace
+{
+    template <class Func>
+    void CheckFails(const Func &func, const string &message)
+    {
+        try
+        {
+            func();
+        }
+        catch(const runtime_error &e)
+        {
+            CheckEqual(string(e.what()), message);
+            return;
+        }
+
+        throw runtime_error("CheckFails failed");
+    }
+
+    struct DepthHandler : public HandlerBase<DepthHandler>
+    {
+        size_t depth = 0;
+        size_t maxDepth = 0;
+
+        void StartArray() { maxDepth = max(maxDepth, ++depth); }
+        void EndArray(size_t) { --depth; }
+    };
+}
+
+void TestLimits()
+{
+    // Depth is bounded by options, not by the thread's stack
+    {
+        const size_t levels = 200000;
+        const string deep = string(levels, '[') + string(levels, ']');
+
+        DepthHandler handler;
+        CheckFails([&] { Parse(deep, handler); }, "nesting too deep");
+
+        ParseOptions options;
+        options.maxDepth = levels;
+
+        handler = DepthHandler();
+        Parse(deep, handler, options);
+        CheckEqual(handler.maxDepth, levels);
+        CheckEqual(handler.depth, size_t(0));
+    }
+
+    // Empty containers count toward the depth; scalars do not
+    {
+        ParseOptions options;
+        options.maxDepth = 2;
+
+        CheckEqual(Convert<vector<vector<int>>>(Read("[[1], []]", options)).size(), size_t(2));
+        CheckFails([&] { Read("[[[]]]", options); }, "nesting too deep");
+        CheckFails([&] { Read("[{\"a\" : {}}]", options); }, "nesting too deep");
+
+        options.maxDepth = 0;
+        CheckEqual(Read("7", options)->AsInt64(), int64_t(7));
+        CheckFails([&] { Read("{}", options); }, "nesting too deep");
+    }
+
+    // Strings and keys are measured after unescaping
+    {
+        ParseOptions options;
+        options.maxStringLength = 3;
+
+        Read(R"({"abc" : "a\nb"})", options);
+        CheckFails([&] { Read(R"({"abcd" : 1})", options); }, "string too long");
+        CheckFails([&] { Read(R"(["a\\bcd"])", options); }, "string too long");
+    }
+
+    // Every value counts as a node, containers included
+    {
+        ParseOptions options;
+        options.maxNodes = 4;
+
+        Read("[1, [2]]", options);
+        CheckFails([&] { Read("[1, 2, 3, 4]", options); }, "too many values");
+        CheckFails([&] { Read(R"({"a" : [1, 2, 3]})", options); }, "too many values");
+    }
+
+    // Contiguous input is measured up front, iterator input as it is read
+    {
+        const string data = " [1, 2] ";
+
+        ParseOptions options;
+        options.maxInputBytes = data.size();
+
+        Read(data, options);
+        Read(data.begin(), data.end(), options);
+
+        options.maxInputBytes = data.size() - 1;
+        CheckFails([&] { Read(data, options); }, "input too large");
+        CheckFails([&] { Read(data.data(), data.size(), options); }, "input too large");
+        CheckFails([&] { Read(data.begin(), data.end(), options); }, "input too large");
+
+        DepthHandler handler;
+        CheckFails([&] { Parse(data.begin(), data.end(), handler, options); }, "input too large");
+
+        // A stream is limited from its position onwards
+        const string two = "[1] [2]";
+        auto stream = MakeStream(two.begin(), two.end());
+        options.maxInputBytes = 4;
+
+        CheckEqual(Convert<vector<int>>(Read(stream, options)), vector<int>{ 1 });
+        CheckEqual(Convert<vector<int>>(Read(stream, options)), vector<int>{ 2 });
+    }
+
+    // Documents keep their options across parses
+    {
+        ParseOptions options;
+        options.maxDepth = 1;
+
+        Document doc;
+        doc.SetParseOptions(options);
+        CheckEqual(doc.GetParseOptions().maxDepth, size_t(1));
+
+        doc.Parse("[1, 2]");
+        CheckFails([&] { doc.Parse("[[1]]"); }, "nesting too deep");
+        const string nested = R"({"a" : []})";
+        CheckFails([&] { doc.ParseView(nested); }, "nesting too deep");
+
+        Document moved(std::move(doc));
+        CheckFails([&] { moved.Parse("[[]]"); }, "nesting too deep");
+    }
+
+    // Buffers are checked against the byte limit before they are copied
+    {
+        const string data = "12345678";
+
+        ParseOptions options;
+        options.maxInputBytes = data.size() - 1;
+
+        Document doc;
+        doc.SetParseOptions(options);
+        CheckFails([&] { doc.Parse(data.data(), data.size()); }, "input too large");
+        doc.Parse(data.data(), data.size() - 1);
+        CheckEqual(doc.Root().AsInt64(), int64_t(1234567));
+
+        TapeDocument tape;
+        tape.SetParseOptions(options);
+        CheckFails([&] { tape.Parse(data.data(), data.size()); }, "input too large");
+        tape.Parse(data.data(), 1);
+    }
+}
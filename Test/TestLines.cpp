@@ -0,0 +1,107 @@
+
+#include "TinyJson.h"
+#include "TestUtil.h"
+
+using namespace std;
+using namespace TinyJson;
+
+void TestLines()
+{
+    string data;
+    for( int i = 0; i < 1000; ++i )
+    {
+        data += "{\"id\": " + to_string(i) + ", \"name\": \"record " + to_string(i) + "\", \"tags\": [1, 2, 3]}\n";
+        if( i % 100 == 0 )
+            data += "\r\n  \n";
+    }
+
+    BatchOptions options;
+    options.threadCount = 4;
+
+    // Records come back in input order, blank lines are skipped
+    {
+        LinesDocument doc;
+        doc.Parse(data, options);
+
+        CheckEqual(doc.size(), size_t(1000));
+        for( size_t i = 0; i < doc.size(); ++i )
+        {
+            CheckEqual(doc[i].AsObject().at("id").AsInt64(), int64_t(i));
+            CheckEqual(doc[i].AsObject().at("name").AsString().str(), "record " + to_string(i));
+        }
+    }
+
+    // Streaming in small windows
+    {
+        options.windowSize = 300;
+
+        size_t expected = 0;
+        LinesDocument doc;
+        doc.ParseEach(data, [&](const size_t index, const Value &root)
+        {
+            CheckEqual(index, expected++);
+            CheckEqual(root.AsObject().at("id").AsInt64(), int64_t(index));
+        }, options);
+
+        CheckEqual(expected, size_t(1000));
+    }
+
+    // Last line without a newline, single thread
+    {
+        options.threadCount = 1;
+
+        LinesDocument doc;
+        doc.Parse("[1]\n\"two\"\n3", options);
+
+        CheckEqual(doc.size(), size_t(3));
+        CheckEqual(doc[1].AsString(), StringView("two"));
+        CheckEqual(doc[2].AsInt64(), int64_t(3));
+    }
+
+    // Errors report the line, and the document stays usable
+    {
+        LinesDocument doc;
+
+        string message;
+        try
+        {
+            doc.Parse(data + "{\"id\": 1} 2\n", options);
+        }
+        catch( const runtime_error &e )
+        {
+            message = e.what();
+        }
+
+        CheckEqual(message.compare(0, 10, "line 1021:"), 0);
+
+        CheckThrows([&] { doc.Parse("{}\n[1,\n2]\n"); });
+
+        doc.Parse("{}\n[]\n");
+        CheckEqual(doc.size(), size_t(2));
+    }
+
+    // Parse limits apply to every record, the byte limit to the whole input
+    {
+        LinesDocument doc;
+        BatchOptions limited;
+        limited.threadCount = 2;
+        limited.parseOptions.maxDepth = 2;
+
+        doc.Parse("[[1]]\n{\"a\": []}\n", limited);
+        CheckEqual(doc.size(), size_t(2));
+        CheckThrows([&] { doc.Parse("[[1]]\n[[[1]]]\n", limited); });
+
+        limited.parseOptions = ParseOptions();
+        limited.parseOptions.maxStringLength = 3;
+        CheckThrows([&] { doc.Parse("\"abc\"\n\"abcd\"\n", limited); });
+
+        limited.parseOptions = ParseOptions();
+        limited.parseOptions.maxInputBytes = data.size() - 1;
+        CheckThrows([&] { doc.Parse(data, limited); });
+        CheckThrows([&] { doc.ParseEach(data, [](size_t, const Value &) {}, limited); });
+
+        limited.parseOptions.maxInputBytes = data.size();
+        doc.Parse(data, limited);
+        CheckEqual(doc.size(), size_t(1000));
+    }
+}
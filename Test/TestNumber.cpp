@@ -20,4 +20,72 @@ void TestNumber()
     Test(" -10.5 ", -10.5);
     Test(" 10e2 ", 1000);
     Test(" -123e-3 ", -0.123);
+
+    // Correct rounding
+    Test(" 0.1 ", 0.1);
+    Test(" 3.14159265358979323846264338327950288 ", 3.141592653589793);
+    Test(" 0.000000000012345678901 ", 1.2345678901e-11);
+    Test(" 2.2250738585072014e-308 ", 2.2250738585072014e-308);
+    Test(" 4.9406564584124654e-324 ", 4.9406564584124654e-324);
+    Test(" 1.7976931348623157e308 ", 1.7976931348623157e308);
+    Test(" 9007199254740993.0 ", 9007199254740992.0);
+    Test(" 1e-400 ", 0.0);
+    CheckThrows([] { Read(" 1e400 "); });
+
+    // Number grammar is strict
+    Test(" 0 ", 0);
+    Test(" -0.5 ", -0.5);
+    Test(" 0e1 ", 0);
+    for( const char *const pData: { "01", "-01", "-", "1.", "1.e5", ".5", "1e", "1e+", "00", "-x" } )
+        CheckThrows([&] { Read(pData); });
+
+    // Integral literals are exact
+    {
+        auto value = Read(" 1234567890123456789 ");
+        Check(value->IsInt64());
+        CheckEqual(Convert<long long>(value), 1234567890123456789LL);
+
+        CheckEqual(Convert<unsigned long long>(Read("18446744073709551615")), 18446744073709551615ULL);
+        CheckEqual(Convert<long long>(Read("-9223372036854775808")), (-9223372036854775807LL - 1));
+        CheckEqual(Convert<int>(Read("-42")), -42);
+
+        Document doc;
+        doc.Parse("[9007199254740993, 1.0, 2.5]");
+
+        const auto arr = doc.Root().AsArray();
+        CheckEqual(Convert<long long>(arr[0]), 9007199254740993LL);
+        CheckEqual(arr[1].AsInt64(), int64_t(1));
+        CheckThrows([&] { arr[2].AsInt64(); });
+    }
+
+    // Conversions check the range of the target instead of wrapping
+    {
+        CheckEqual(Convert<int>(Read("2147483647")), 2147483647);
+        CheckEqual(Convert<int>(Read("-2147483648")), -2147483647 - 1);
+        CheckEqual(Convert<unsigned short>(Read("65535")), static_cast<unsigned short>(65535));
+        CheckEqual(Convert<int>(Read("1e3")), 1000);
+        CheckEqual(Convert<float>(Read("0.5")), 0.5f);
+
+        CheckThrows([] { Convert<int>(Read("3000000000")); });
+        CheckThrows([] { Convert<int>(Read("-2147483649")); });
+        CheckThrows([] { Convert<unsigned int>(Read("-1")); });
+        CheckThrows([] { Convert<short>(Read("18446744073709551615")); });
+        CheckThrows([] { Convert<long long>(Read("9223372036854775808")); });
+        CheckThrows([] { Convert<int>(Read("1e20")); });
+        CheckThrows([] { Convert<unsigned long long>(Read("1.8446744073709552e19")); });
+        CheckThrows([] { Convert<int>(Read("2.5")); });
+        CheckThrows([] { Convert<float>(Read("1e300")); });
+
+        Document doc;
+        doc.Parse("[3000000000, 0.5]");
+        CheckThrows([&] { Convert<int>(doc.Root().AsArray()[0]); });
+        CheckThrows([&] { Convert<long>(doc.Root().AsArray()[1]); });
+
+        // The typed reader converts the same way
+        CheckEqual(ReadAs<vector<short>>("[-32768, 32767]")[0], static_cast<short>(-32768));
+        CheckThrows([] { ReadAs<vector<int>>("[1, 3000000000]"); });
+        CheckThrows([] { ReadAs<vector<unsigned int>>("[-1]"); });
+        CheckThrows([] { ReadAs<vector<int>>("[1.5]"); });
+        CheckThrows([] { ReadAs<vector<float>>("[1e39]"); });
+    }
 }
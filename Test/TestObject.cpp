@@ -41,4 +41,68 @@ void TestObject()
         CheckEqual(obj.at("c")->AsBoolean(), true);
         Check(obj.at("d")->IsNull());
     }
+
+    // Members keep their input order
+    {
+        auto value = Read(R"( {"z" : 1, "a" : 2, "m" : 3} )");
+
+        string keys;
+        for( const auto &entry: value->AsObject() )
+            keys += entry.first;
+
+        CheckEqual(keys, string("zam"));
+    }
+
+    // Large objects are indexed
+    {
+        string json = "{";
+        for( int i = 0; i < 100; ++i )
+            json += (i ? ",\"k" : "\"k") + to_string(i) + "\":" + to_string(i);
+        json += "}";
+
+        auto value = Read(json);
+        const auto &obj = value->AsObject();
+
+        CheckEqual(obj.size(), size_t(100));
+        for( int i = 0; i < 100; ++i )
+            CheckEqual(obj.at("k" + to_string(i))->AsInt64(), int64_t(i));
+
+        Check(obj.find("k100") == obj.end());
+        CheckEqual(obj.count("k42"), size_t(1));
+        CheckThrows([&] { obj.at("missing"); });
+
+        CheckThrows([&] { Read(json.substr(0, json.size() - 1) + ",\"k7\":0}"); });
+    }
+
+    // Map-style editing
+    {
+        Object obj;
+        for( int i = 0; i < 40; ++i )
+            obj["k" + to_string(i)] = ValuePtr(new NullValue());
+
+        CheckEqual(obj.erase("k3"), size_t(1));
+        CheckEqual(obj.erase("k3"), size_t(0));
+        CheckEqual(obj.size(), size_t(39));
+        CheckEqual(obj.begin()[3].first, string("k4"));
+        Check(obj.find("k39") != obj.end());
+
+        Check(!obj.emplace("k0", ValuePtr()).second);
+
+        // Shrinking below the index threshold and growing past it again
+        for( int i = 4; i < 35; ++i )
+            obj.erase("k" + to_string(i));
+
+        CheckEqual(obj.size(), size_t(8));
+        Check(obj.find("k35") != obj.end());
+        Check(obj.find("k4") == obj.end());
+
+        for( int i = 100; i < 130; ++i )
+            Check(obj.emplace("k" + to_string(i), ValuePtr()).second);
+
+        CheckEqual(obj.size(), size_t(38));
+        Check(!obj.emplace("k2", ValuePtr()).second);
+        Check(!obj.emplace("k129", ValuePtr()).second);
+        Check(obj.find("k36") != obj.end());
+        CheckEqual(obj.begin()[8].first, string("k100"));
+    }
 }
@@ -0,0 +1,113 @@
+
+#include "TinyJson.h"
+#include "TestUtil.h"
+
+using namespace std;
+using namespace TinyJson;
+
+namespace
+{
+    // Sums every "amount" member without building a tree
+    struct SumHandler : public HandlerBase<SumHandler>
+    {
+        double sum = 0;
+        bool isAmount = false;
+
+        void Key(const StringView &key, bool)
+        {
+            isAmount = key == "amount";
+        }
+
+        void Number(const double value)
+        {
+            if( isAmount )
+                sum += value;
+
+            isAmount = false;
+        }
+    };
+
+    struct EventHandler : public HandlerBase<EventHandler>
+    {
+        string events;
+
+        void Null() { events += "n"; }
+        void Bool(const bool value) { events += value ? "t" : "f"; }
+        void Int64(const int64_t value) { events += "i" + to_string(value); }
+        void Number(const double) { events += "d"; }
+        void String(const StringView &str, const bool transient) { events += (transient ? "S" : "s") + str.str(); }
+        void Key(const StringView &key, bool) { events += "k" + key.str(); }
+        void StartArray() { events += "["; }
+        void EndArray(const size_t count) { events += "]" + to_string(count); }
+        void StartObject() { events += "{"; }
+        void EndObject(const size_t count) { events += "}" + to_string(count); }
+    };
+}
+
+void TestParse()
+{
+    // Selective handler
+    {
+        SumHandler handler;
+        Parse(R"( [{"id" : 1, "amount" : 2.5}, {"amount" : 4, "note" : "x"}, {}] )", handler);
+
+        CheckEqual(handler.sum, 6.5);
+    }
+
+    // Event sequence
+    {
+        EventHandler handler;
+        Parse(string(R"( {"a" : [1, 2.5, "x\ty", "z"], "b" : {}, "c" : [true, false, null]} )"), handler);
+
+        CheckEqual(handler.events, string("{ka[i1dSx\ty" "sz]4kb{}0kc[tfn]3}3"));
+    }
+
+    // Iterator input reports every string as transient
+    {
+        const string data = R"( ["plain"] )";
+
+        EventHandler handler;
+        Parse(data.begin(), data.end(), handler);
+
+        CheckEqual(handler.events, string("[Splain]1"));
+    }
+
+    // A copied buffer reports every string as transient, so a builder that
+    // references its input copies them and keeps them past the call
+    {
+        const string text = R"(["plain", {"key": "value"}])";
+
+        Arena arena;
+        DocumentBuilder builder(arena, true);
+        Parse(text.data(), text.size(), builder);
+
+        const auto arr = builder.Root().AsArray();
+        CheckEqual(arr[0].AsString(), StringView("plain"));
+        CheckEqual(arr[1].AsObject().at("key").AsString(), StringView("value"));
+    }
+
+    // Errors are reported by exceptions
+    {
+        EventHandler handler;
+        CheckThrows([&] { Parse("[1, 2", handler); });
+        CheckThrows([&] { Parse("{\"a\" 1}", handler); });
+        CheckThrows([&] { Parse("[1] x", handler); });
+    }
+
+    // Whole inputs must end after the root value
+    {
+        CheckThrows([] { Read("1 2"); });
+        CheckThrows([] { Read(string("{} }")); });
+        CheckThrows([] { Read("[1]\f"); });
+
+        Document doc;
+        CheckThrows([&] { doc.Parse("[true]]"); });
+        doc.Parse(" [true] \r\n");
+        CheckEqual(doc.Root().AsArray().size(), size_t(1));
+
+        // A stream is left after the value for the caller to continue.
+        auto stream = MakeStream("1 2");
+        CheckEqual(Read(stream)->AsInt64(), int64_t(1));
+        CheckEqual(Read(stream)->AsInt64(), int64_t(2));
+    }
+}
@@ -0,0 +1,89 @@
+#include "TinyJson.h"
+#include "TestUtil.h"
+
+using namespace std;
+using namespace TinyJson;
+
+namespace
+{
+    string MakeRecords(const size_t count)
+    {
+        string json = "[";
+        for( size_t i = 0; i < count; ++i )
+            json += (i ? ", " : "") + string(R"({"id" : )") + to_string(i) + R"(, "name" : "record\tname", "tags" : [1, [2], {}]})";
+
+        return json + "]";
+    }
+}
+
+void TestParser()
+{
+    // Values are the same as Document's
+    {
+        Parser parser;
+        Check(parser.Root().IsNull());
+
+        const Value &root = parser.Parse(R"( {"name" : "tiny", "list" : [1, [2, 3]], "flag" : false} )");
+        CheckEqual(root.AsObject().at("name").AsString(), StringView("tiny"));
+        CheckEqual(root.AsObject().at("list").AsArray()[1].AsArray()[1].AsInt64(), int64_t(3));
+        Check(parser.Root().IsObject());
+
+        const string data = R"( ["a", "b"] )";
+        CheckEqual(parser.Parse(data.begin(), data.end()).AsArray().size(), size_t(2));
+        CheckEqual(parser.Parse(data.data(), data.size()).AsArray()[1].AsString(), StringView("b"));
+
+        // Views point into the input
+        CheckEqual(parser.ParseView(data).AsArray()[0].AsString().data(), data.data() + 3);
+    }
+
+    // Buffers are kept, so a repeated document reuses the same memory
+    {
+        const string json = MakeRecords(2000);
+
+        Parser parser;
+        const char *const pFirst = parser.Parse(json).AsArray()[1999].AsObject().at("name").AsString().data();
+        const size_t retained = parser.RetainedBytes();
+        Check(retained > json.size());
+
+        for( int i = 0; i < 3; ++i )
+        {
+            const char *const pName = parser.Parse(json).AsArray()[1999].AsObject().at("name").AsString().data();
+            CheckEqual(pName, pFirst);
+            CheckEqual(parser.RetainedBytes(), retained);
+        }
+    }
+
+    // A failed parse leaves no root, and the parser stays usable
+    {
+        Parser parser;
+        parser.Parse("[1]");
+
+        CheckThrows([&] { parser.Parse("[1] x"); });
+        Check(parser.Root().IsNull());
+
+        CheckThrows([&] { parser.Parse(R"({"a" : [1, {"b" : )"); });
+        CheckEqual(parser.Parse(R"({"c" : [2]})").AsObject().at("c").AsArray()[0].AsInt64(), int64_t(2));
+
+        ParseOptions options;
+        options.maxDepth = 1;
+        parser.SetParseOptions(options);
+        CheckThrows([&] { parser.Parse("[[1]]"); });
+    }
+
+    // Memory past the trim threshold is released before the next parse
+    {
+        Parser parser;
+        parser.SetTrimThreshold(64 * 1024);
+        CheckEqual(parser.GetTrimThreshold(), size_t(64 * 1024));
+
+        parser.Parse(MakeRecords(5000));
+        Check(parser.RetainedBytes() > parser.GetTrimThreshold());
+
+        parser.Parse(MakeRecords(10));
+        Check(parser.RetainedBytes() <= parser.GetTrimThreshold());
+
+        parser.Trim();
+        Check(parser.RetainedBytes() < 1024);
+        CheckEqual(parser.Parse("[true]").AsArray()[0].AsBoolean(), true);
+    }
+}
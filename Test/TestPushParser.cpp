@@ -0,0 +1,143 @@
+
+#include "TinyJson.h"
+#include "TestUtil.h"
+
+using namespace std;
+using namespace TinyJson;
+
+namespace
+{
+    struct RecordingHandler : public HandlerBase<RecordingHandler>
+    {
+        string events;
+
+        void Null() { events += "n,"; }
+        void Bool(const bool value) { events += value ? "t," : "f,"; }
+        void Int64(const int64_t value) { events += "i" + to_string(value) + ","; }
+        void UInt64(const uint64_t value) { events += "u" + to_string(value) + ","; }
+        void Number(const double value) { events += "d" + to_string(value) + ","; }
+        void String(const StringView &str, bool) { events += "s" + str.str() + ","; }
+        void Key(const StringView &key, bool) { events += "k" + key.str() + ","; }
+        void StartArray() { events += "[,"; }
+        void EndArray(const size_t count) { events += "]" + to_string(count) + ","; }
+        void StartObject() { events += "{,"; }
+        void EndObject(const size_t count) { events += "}" + to_string(count) + ","; }
+    };
+}
+
+void TestPushParser()
+{
+    const string data = R"( {"name" : "push \"parser\"", "values" : [1, -2.5e3, 18446744073709551615, true, false, null],
+        "nested" : {"empty" : [], "obj" : {}}, "long" : "0123456789abcdefghijklmnopqrstuvwxyz0123456789",
+        "text" : "caf\u00e9 \ud83d\ude00 )" "caf\xc3\xa9 \xf0\x9f\x98\x80\"} ";
+
+    RecordingHandler expected;
+    Parse(data, expected);
+
+    // Every chunk size produces the same events
+    for( size_t chunk = 1; chunk <= data.size(); chunk += (chunk < 8 ? 1 : 13) )
+    {
+        RecordingHandler handler;
+        PushParser<RecordingHandler> parser(handler);
+
+        FeedResult result = FeedResult::NeedMoreData;
+        for( size_t i = 0; i < data.size(); i += chunk )
+            result = parser.Feed(data.data() + i, min(chunk, data.size() - i));
+
+        CheckEqual(result, FeedResult::Complete);
+        parser.Finish();
+        CheckEqual(handler.events, expected.events);
+    }
+
+    // Top-level numbers complete on Finish
+    {
+        RecordingHandler handler;
+        PushParser<RecordingHandler> parser(handler);
+
+        CheckEqual(parser.Feed("12", 2), FeedResult::NeedMoreData);
+        CheckEqual(parser.Feed("34", 2), FeedResult::NeedMoreData);
+        parser.Finish();
+        CheckEqual(handler.events, string("i1234,"));
+    }
+
+    // Building a document from chunks
+    {
+        Arena arena;
+        DocumentBuilder builder(arena);
+        PushParser<DocumentBuilder> parser(builder);
+
+        parser.Feed("[\"a", 3);
+        parser.Feed("bc\", {\"k\"", 9);
+        parser.Feed(": 2}]", 5);
+        parser.Finish();
+
+        const auto arr = builder.Root().AsArray();
+        CheckEqual(arr[0].AsString(), StringView("abc"));
+        CheckEqual(arr[1].AsObject().at("k").AsInt64(), int64_t(2));
+    }
+
+    // Malformed and truncated input
+    {
+        RecordingHandler handler;
+
+        CheckThrows([&] { PushParser<RecordingHandler> parser(handler); parser.Feed("[1}", 3); });
+        CheckThrows([&] { PushParser<RecordingHandler> parser(handler); parser.Feed("{\"a\" 1}", 7); });
+        CheckThrows([&] { PushParser<RecordingHandler> parser(handler); parser.Feed("[tru", 4); parser.Feed("x]", 2); });
+        CheckThrows([&] { PushParser<RecordingHandler> parser(handler); parser.Feed("[1, 2", 5); parser.Finish(); });
+        CheckThrows([&] { PushParser<RecordingHandler> parser(handler); parser.Feed("[\"\\ud83d", 8); parser.Feed("\\u0041\"]", 8); });
+        CheckThrows([&] { PushParser<RecordingHandler> parser(handler); parser.Feed("[\"\xc3", 3); parser.Feed("(\"]", 3); });
+    }
+
+    // Limits from ParseOptions
+    {
+        RecordingHandler handler;
+        ParseOptions options;
+
+        // The default depth stops unbounded nesting
+        const string deep(100000, '[');
+        CheckThrows([&] { PushParser<RecordingHandler> parser(handler); parser.Feed(deep.data(), deep.size()); });
+
+        options.maxDepth = 2;
+        {
+            PushParser<RecordingHandler> parser(handler, options);
+            parser.Feed("[[1]]", 5);
+            parser.Finish();
+        }
+        CheckThrows([&] { PushParser<RecordingHandler> parser(handler, options); parser.Feed("[[", 2); parser.Feed("[1]]]", 5); });
+
+        // Over-long strings fail while still being buffered, escapes count decoded
+        options = ParseOptions();
+        options.maxStringLength = 4;
+        {
+            PushParser<RecordingHandler> parser(handler, options);
+            parser.Feed("{\"abcd\": \"a\\", 12);
+            parser.Feed("u00e9b\"}", 8);
+            parser.Finish();
+        }
+        CheckThrows([&] { PushParser<RecordingHandler> parser(handler, options); parser.Feed("[\"abcde\"]", 9); });
+        CheckThrows([&] { PushParser<RecordingHandler> parser(handler, options); parser.Feed("{\"abcde\": 1}", 12); });
+        CheckThrows([&] { PushParser<RecordingHandler> parser(handler, options); parser.Feed("[\"ab", 4); parser.Feed("cde", 3); });
+
+        options = ParseOptions();
+        options.maxNodes = 3;
+        {
+            PushParser<RecordingHandler> parser(handler, options);
+            parser.Feed("[1, ", 4);
+            parser.Feed("2]", 2);
+            parser.Finish();
+        }
+        CheckThrows([&] { PushParser<RecordingHandler> parser(handler, options); parser.Feed("[1, {\"a\": 2}]", 13); });
+
+        // The byte budget covers every chunk; Reset starts a new one
+        options = ParseOptions();
+        options.maxInputBytes = 6;
+        {
+            PushParser<RecordingHandler> parser(handler, options);
+            parser.Feed("[1, ", 4);
+            CheckThrows([&] { parser.Feed("2, 3]", 5); });
+
+            parser.Reset();
+            CheckEqual(parser.Feed("[1, 2]", 6), FeedResult::Complete);
+        }
+    }
+}
@@ -14,9 +14,84 @@ void TestString()
 
         const auto actual = Convert<string>(value);
         CheckEqual(actual, expected);
+
+        CheckEqual(Convert<string>(Read(data)), expected);
+        CheckEqual(Convert<string>(Read(data.c_str())), expected);
+
+        const string padded = data + "garbage";
+        CheckEqual(Convert<string>(Read(padded.data(), data.size())), expected);
     };
 
     Test(R"( "hello world!" )", "hello world!");
     Test(R"( "\"quoted text\"" )", "\"quoted text\"");
     Test(R"( "first line.\nsecond line." )", "first line.\nsecond line.");
+
+    // Long strings with escapes at block boundaries
+    {
+        const string text(100, 'x');
+        for( size_t i = 0; i < text.size(); i += 7 )
+        {
+            string data = "\"" + text + "\"";
+            data.insert(i + 1, "\\t");
+
+            string expected = text;
+            expected.insert(i, "\t");
+
+            Test(data, expected);
+        }
+    }
+
+    const auto Fails = [] (const string &data)
+    {
+        CheckThrows([&] { Read(data.begin(), data.end()); });
+        CheckThrows([&] { Read(data); });
+    };
+
+    // \u escapes decode to UTF-8; a surrogate pair is one code point
+    Test(R"( "\u0041\u00e9\u20AC" )", "A\xc3\xa9\xe2\x82\xac");
+    Test(R"( "\ud83d\ude00!" )", "\xf0\x9f\x98\x80!");
+    Test(R"( "a\u0000b" )", string("a\0b", 3));
+    Test(R"( "\\ud83d" )", "\\ud83d");
+
+    for( const char *const pData: { R"("\ud83d")", R"("\ude00\ud83d")", R"("\ud83d\u0041")", R"("\ud83dx")", R"("\u12")", R"("\u12g4")" } )
+        Fails(pData);
+
+    // Raw bytes must be well-formed UTF-8, wherever they fall in a block
+    {
+        const string text(70, 'x');
+        for( size_t i = 0; i < text.size(); i += 3 )
+        {
+            string data = "\"" + text + "\"";
+
+            data.insert(i + 1, "\xe6\x97\xa5\xf0\x9f\x98\x80");
+            Test(data, data.substr(1, data.size() - 2));
+
+            for( const char *const pInvalid: { "\x80", "\xc3(", "\xc0\xaf", "\xed\xa0\x80", "\xf4\x90\x80\x80", "\xf0\x9f\x98" } )
+            {
+                string invalid = data;
+                invalid.insert(i + 1, pInvalid);
+                Fails(invalid);
+            }
+
+            // A sequence cut off by an escape
+            Fails("\"" + text.substr(0, i) + "\xe6\x97\\n\"");
+        }
+    }
+
+    // Control characters must be escaped
+    CheckThrows([] { Read("\"tab\tinside\""); });
+    CheckThrows([] { Read(string("\"0123456789abcdefghij\nklmnopqrstuvwxyz0123456789\"")); });
+    CheckThrows([] { Read(string("\"unterminated")); });
+
+    // Unescaped strings view the input buffer
+    {
+        const string data = R"( ["plain", "esc\"aped"] )";
+
+        Document doc;
+        doc.ParseView(data);
+
+        const auto arr = doc.Root().AsArray();
+        CheckEqual(arr[0].AsString().data(), data.data() + data.find("plain"));
+        CheckEqual(arr[1].AsString(), StringView("esc\"aped"));
+    }
 }
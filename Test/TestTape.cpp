@@ -0,0 +1,106 @@
+#include "TinyJson.h"
+#include "TestUtil.h"
+
+using namespace std;
+using namespace TinyJson;
+
+void TestTape()
+{
+    // Scalar values
+    {
+        TapeDocument doc;
+        Check(doc.Root().IsNull());
+
+        doc.Parse(" -12.5 ");
+        CheckEqual(doc.Root().AsNumber(), -12.5);
+        CheckEqual(doc.TapeSize(), size_t(2));
+
+        doc.Parse("-7");
+        Check(doc.Root().IsInt64());
+        CheckEqual(doc.Root().AsInt64(), int64_t(-7));
+        CheckThrows([&] { doc.Root().AsUInt64(); });
+
+        doc.Parse("18446744073709551615");
+        Check(doc.Root().IsUInt64());
+        CheckEqual(doc.Root().AsUInt64(), UINT64_MAX);
+        CheckThrows([&] { doc.Root().AsInt64(); });
+
+        doc.Parse(" true ");
+        CheckEqual(doc.Root().AsBoolean(), true);
+        CheckThrows([&] { doc.Root().AsString(); });
+
+        doc.Parse(R"("a\"b")");
+        CheckEqual(doc.Root().AsString(), StringView("a\"b"));
+    }
+
+    // Nested containers
+    {
+        TapeDocument doc;
+        doc.Parse(R"( {"name" : "tiny", "list" : [1, [2, 3], {}], "empty" : [], "flag" : false} )");
+        Check(doc.Root().IsObject());
+        CheckEqual(doc.Root().Type(), ValueType::Object);
+
+        const auto obj = doc.Root().AsObject();
+        CheckEqual(obj.size(), size_t(4));
+        CheckEqual(obj.at("name").AsString(), StringView("tiny"));
+        CheckEqual(obj.at("flag").AsBoolean(), false);
+        Check(obj.at("empty").AsArray().empty());
+
+        const auto list = obj.at("list").AsArray();
+        CheckEqual(list.size(), size_t(3));
+        CheckEqual(list[0].AsNumber(), 1.0);
+        CheckEqual(list[1].AsArray()[1].AsNumber(), 3.0);
+        Check(list[2].AsObject().empty());
+        CheckThrows([&] { list.at(3); });
+
+        CheckEqual(obj.count("missing"), size_t(0));
+        CheckThrows([&] { obj.at("missing"); });
+    }
+
+    // Iteration skips nested containers whole
+    {
+        TapeDocument doc;
+        doc.Parse(R"( [[1, [2, [3]]], {"a" : {"b" : [4]}, "c" : 5}, "x"] )");
+
+        string types;
+        for( const auto value: doc.Root().AsArray() )
+            types += value.IsArray() ? 'a' : value.IsObject() ? 'o' : 's';
+
+        CheckEqual(types, string("aos"));
+
+        string keys;
+        for( const auto member: doc.Root().AsArray()[1].AsObject() )
+            keys += member.key.str();
+
+        CheckEqual(keys, string("ac"));
+        CheckEqual(doc.Root().AsArray()[1].AsObject().at("c").AsInt64(), int64_t(5));
+    }
+
+    // Containers past the stored count limit are counted by walking
+    {
+        string json = "[";
+        for( size_t i = 0; i < Tape::MaxCount + 2; ++i )
+            json += i ? ",0" : "0";
+
+        json += "]";
+
+        TapeDocument doc;
+        doc.Parse(json);
+        CheckEqual(doc.Root().AsArray().size(), size_t(Tape::MaxCount + 2));
+    }
+
+    // Failed parses leave an empty document; options apply as for Document
+    {
+        ParseOptions options;
+        options.maxDepth = 1;
+
+        TapeDocument doc;
+        doc.SetParseOptions(options);
+        doc.Parse("[1]");
+
+        CheckThrows([&] { doc.Parse("[[1]]"); });
+        Check(doc.Root().IsNull());
+        CheckEqual(doc.TapeSize(), size_t(0));
+        CheckEqual(doc.StringsSize(), size_t(0));
+    }
+}
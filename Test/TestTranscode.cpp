@@ -0,0 +1,189 @@
+
+#include "TinyJson.h"
+#include "TestUtil.h"
+
+#include <cstdio>
+
+using namespace std;
+using namespace TinyJson;
+
+namespace
+{
+    WriteOptions Pretty(const unsigned indent = 4)
+    {
+        WriteOptions options;
+        options.pretty = true;
+        options.indent = indent;
+        return options;
+    }
+
+    // Feeds the input in chunks of the given size.
+    string TranscodeChunked(const string &data, const size_t chunk, const WriteOptions &options = WriteOptions())
+    {
+        string result;
+        StringSink sink(result);
+        Transcoder transcoder(sink, options);
+
+        for( size_t i = 0; i < data.size(); i += chunk )
+            transcoder.Feed(data.data() + i, min(chunk, data.size() - i));
+
+        transcoder.Finish();
+        return result;
+    }
+
+    void TestLayout()
+    {
+        const string data = " {\"name\" : \"tiny\", \"values\" : [ 1, -2, 18446744073709551615, true, false, null ],\n"
+            "\t\"nested\" : {\"empty\" : [ ], \"obj\" : { }, \"deep\" : [[[\"x\"]]]}, \"text\" : \"caf\xc3\xa9 \xf0\x9f\x98\x80\"}\r\n";
+
+        // The layout is the one Writer produces for the same tree
+        CheckEqual(Transcode(data), ToString(Read(data)));
+        CheckEqual(Transcode(data, Pretty()), ToString(Read(data), Pretty()));
+        CheckEqual(Transcode(data, Pretty(2)), ToString(Read(data), Pretty(2)));
+
+        // Re-indenting and minifying round-trip
+        CheckEqual(Transcode(Transcode(data, Pretty())), Transcode(data));
+        CheckEqual(Transcode(Transcode(data, Pretty(2)), Pretty()), Transcode(data, Pretty()));
+
+        CheckEqual(Transcode("  42 "), string("42"));
+        CheckEqual(Transcode("\"top\""), string("\"top\""));
+        CheckEqual(Transcode("[]", Pretty()), string("[]"));
+        CheckEqual(Transcode("[1]", Pretty()), string("[\n    1\n]"));
+    }
+
+    void TestVerbatim()
+    {
+        // Numbers keep their digits and strings their escapes
+        CheckEqual(Transcode("[ 1.50E+2 , -0.0, 1e-7 ]"), string("[1.50E+2,-0.0,1e-7]"));
+        CheckEqual(Transcode("[ 1e400, 123456789012345678901234567890 ]"), string("[1e400,123456789012345678901234567890]"));
+        CheckEqual(Transcode(R"( "a\/b\u00E9\ud83d\ude00\n" )"), string(R"("a\/b\u00E9\ud83d\ude00\n")"));
+
+        // Whitespace inside strings is content
+        CheckEqual(Transcode("{ \" k \" : \" v \\t \" }"), string("{\" k \":\" v \\t \"}"));
+    }
+
+    void TestChunks()
+    {
+        const string data = R"( {"name" : "chunked \"text\"", "values" : [12345, -2.5e3, true, false, null],
+            "nested" : {"empty" : [], "obj" : {}}, "long" : "0123456789abcdefghijklmnopqrstuvwxyz0123456789",
+            "text" : "caf\u00e9 \ud83d\ude00 )" "caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80\", \"last\": 7} ";
+
+        const string compact = Transcode(data);
+        const string pretty = Transcode(data, Pretty());
+
+        // Tokens, escapes and characters split at every position
+        for( size_t chunk = 1; chunk <= data.size(); ++chunk )
+        {
+            CheckEqual(TranscodeChunked(data, chunk), compact);
+            CheckEqual(TranscodeChunked(data, chunk, Pretty()), pretty);
+        }
+
+        // A top-level number completes on Finish
+        {
+            string result;
+            StringSink sink(result);
+            Transcoder transcoder(sink);
+
+            CheckEqual(transcoder.Feed(" 12", 3), FeedResult::NeedMoreData);
+            CheckEqual(transcoder.Feed("34", 2), FeedResult::NeedMoreData);
+            transcoder.Finish();
+            CheckEqual(result, string("1234"));
+        }
+
+        // Reset starts a new document
+        {
+            string result;
+            StringSink sink(result);
+            Transcoder transcoder(sink);
+
+            CheckEqual(transcoder.Feed("[1, {\"a\"", 8), FeedResult::NeedMoreData);
+            transcoder.Reset();
+            CheckEqual(transcoder.Feed("[ 2 ] ", 6), FeedResult::Complete);
+            transcoder.Finish();
+            CheckEqual(result, string("[2]"));
+        }
+    }
+
+    void TestWhitespace()
+    {
+        // Runs of every length and offset on the vector paths
+        for( size_t length = 0; length < 80; ++length )
+        {
+            const string spaces = string(length, ' ') + string(length % 7, '\n') + string(length % 5, '\t') + string(length % 3, '\r');
+            const string data = spaces + "[" + spaces + "1" + spaces + "," + spaces + "\"" + string(length, ' ') + "\"" + spaces + "]" + spaces;
+
+            CheckEqual(Transcode(data), "[1,\"" + string(length, ' ') + "\"]");
+        }
+
+        CheckEqual(Transcode(string(1000, ' ') + "null" + string(1000, '\n')), string("null"));
+    }
+
+    void TestMalformed()
+    {
+        const char *const inputs[] =
+        {
+            "", "  ", "[", "[1,]", "[1 2]", "{\"a\" 1}", "{\"a\":1,}", "{1:2}", "[}", "{]", "[1]]", "[1] x",
+            "tru", "nul", "-", "01", "1.", "1e", "1e+", "-a", "0x1", "\"abc", "\"a\\x\"", "\"\\u12G4\"", "\"\\ud800\"",
+            "\"\\ud800\\u0041\"", "\"\\udc00\"", "\"a\tb\"", "\"\xc3\"", "\"\xc3\x28\"", "\"\xed\xa0\x80\"", "\"\xf5\x80\x80\x80\""
+        };
+
+        for( const char *const pInput: inputs )
+        {
+            const string data(pInput);
+
+            for( size_t chunk = 1; chunk <= max<size_t>(data.size(), 1); ++chunk )
+                CheckThrows([&] { TranscodeChunked(data, chunk); });
+        }
+
+        ParseOptions options;
+        options.maxDepth = 2;
+
+        string result;
+        StringSink sink(result);
+        CheckThrows([&] { Transcode("[[[1]]]", 7, sink, WriteOptions(), options); });
+
+        options.maxInputBytes = 4;
+        CheckThrows([&] { Transcode("[1,2]", 5, sink, WriteOptions(), options); });
+    }
+
+    void TestSources()
+    {
+        string data = "[";
+        for( int i = 0; i < 20000; ++i )
+            data += (i != 0 ? ",\n    " : "\n    ") + string("{\"id\": ") + to_string(i) + ", \"name\": \"item \xc3\xa9\"}";
+        data += "\n]";
+
+        FILE *const pFile = tmpfile();
+        if( pFile )
+        {
+            fwrite(data.data(), 1, data.size(), pFile);
+
+            // Larger than a chunk, so tokens are split between reads
+            rewind(pFile);
+            string result;
+            StringSink sink(result);
+            FileSource source(pFile);
+            Transcode(source, sink);
+            CheckEqual(result, ToString(Read(data)));
+
+            rewind(pFile);
+            string pretty;
+            StringSink prettySink(pretty);
+            FdSource fdSource(fileno(pFile));
+            Transcode(fdSource, prettySink, Pretty());
+            CheckEqual(pretty, ToString(Read(data), Pretty()));
+
+            fclose(pFile);
+        }
+    }
+}
+
+void TestTranscode()
+{
+    TestLayout();
+    TestVerbatim();
+    TestChunks();
+    TestWhitespace();
+    TestMalformed();
+    TestSources();
+}
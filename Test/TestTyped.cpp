@@ -0,0 +1,138 @@
+
+#include "TinyJson.h"
+#include "TestUtil.h"
+
+using namespace std;
+using namespace TinyJson;
+
+namespace Config
+{
+    struct Endpoint
+    {
+        string host;
+        int port;
+    };
+
+    TinyJson_Fields(Endpoint, host, port)
+
+    struct Service
+    {
+        string name;
+        vector<Endpoint> endpoints;
+        map<string, double> limits;
+        pair<int, bool> flags;
+        bool enabled;
+        uint64_t id;
+    };
+
+    TinyJson_Fields(Service, name, endpoints, limits, flags, enabled, id)
+
+    struct Node
+    {
+        vector<Node> kids;
+    };
+
+    TinyJson_Fields(Node, kids)
+}
+
+void TestTyped()
+{
+    const char *const pJson = R"( {
+        "name" : "api",
+        "unknown" : {"nested" : [1, 2, {"deep" : null}]},
+        "endpoints" : [{"host" : "a", "port" : 80}, {"port" : 443, "host" : "b\tc"}],
+        "limits" : {"rps" : 1.5, "burst" : 10},
+        "flags" : [7, true],
+        "id" : 18446744073709551615
+    } )";
+
+    // Straight from the text
+    const auto service = ReadAs<Config::Service>(pJson);
+
+    CheckEqual(service.name, string("api"));
+    CheckEqual(service.endpoints.size(), size_t(2));
+    CheckEqual(service.endpoints[1].host, string("b\tc"));
+    CheckEqual(service.endpoints[1].port, 443);
+    CheckEqual(service.limits.at("burst"), 10.0);
+    CheckEqual(service.flags, make_pair(7, true));
+    CheckEqual(service.enabled, false);
+    CheckEqual(service.id, numeric_limits<uint64_t>::max());
+
+    // Through the trees and the lazy cursor
+    const auto fromTree = Convert<Config::Service>(Read(pJson));
+    CheckEqual(fromTree.endpoints[0].host, string("a"));
+    CheckEqual(fromTree.id, service.id);
+
+    Document doc;
+    doc.Parse(pJson);
+    CheckEqual(Convert<Config::Service>(doc.Root()).limits.at("rps"), 1.5);
+    CheckEqual(Convert<vector<Config::Endpoint>>(LazyDocument(pJson)["endpoints"])[1].port, 443);
+
+    // Writing and reading back
+    CheckEqual(ToString(service.endpoints[0]), string(R"({"host":"a","port":80})"));
+    const auto copy = ReadAs<map<string, Config::Service>>("{\"x\":" + ToString(service) + "}");
+    CheckEqual(copy.at("x").endpoints[1].host, service.endpoints[1].host);
+
+    CheckThrows([] { ReadAs<Config::Endpoint>(R"({"host" : 1})"); });
+    CheckThrows([] { ReadAs<Config::Endpoint>(R"({"port" : "80"})"); });
+    CheckThrows([] { ReadAs<pair<int, int>>("[1, 2, 3]"); });
+    CheckThrows([] { ReadAs<vector<int>>("[1, 2"); });
+
+    // Limits apply as in Read; depth is checked before recursing
+    {
+        string deep;
+        for( int i = 0; i < 200000; ++i )
+            deep += "{\"kids\":[";
+
+        CheckThrows([&] { ReadAs<Config::Node>(deep); });
+
+        ParseOptions options;
+        options.maxDepth = 4;
+
+        CheckEqual(ReadAs<Config::Node>(R"({"kids" : [{"kids" : []}]})", options).kids.size(), size_t(1));
+        CheckThrows([&] { ReadAs<Config::Node>(R"({"kids" : [{"kids" : [{}]}]})", options); });
+
+        // Skipped and untyped values count from the depth they start at
+        CheckEqual(ReadAs<vector<Config::Endpoint>>(R"([{"x" : [[1]]}])", options).size(), size_t(1));
+        CheckThrows([&] { ReadAs<vector<Config::Endpoint>>(R"([{"x" : [[[1]]]}])", options); });
+        CheckThrows([&] { ReadAs<vector<vector<ValuePtr>>>("[[[[[1]]]]]", options); });
+        CheckEqual(ReadAs<vector<vector<ValuePtr>>>("[[[[1]]]]", options).size(), size_t(1));
+
+        options = ParseOptions();
+        options.maxStringLength = 4;
+
+        CheckEqual(ReadAs<Config::Endpoint>(R"({"host" : "a\tbc", "port" : 1})", options).host, string("a\tbc"));
+        CheckThrows([&] { ReadAs<Config::Endpoint>(R"({"host" : "abcde"})", options); });
+        CheckThrows([&] { ReadAs<Config::Endpoint>(R"({"unknown" : 1})", options); });
+        CheckThrows([&] { ReadAs<Config::Endpoint>(R"({"x" : ["abcde"]})", options); });
+
+        options = ParseOptions();
+        options.maxInputBytes = 5;
+
+        CheckEqual(ReadAs<vector<int>>("[1,2]", options).size(), size_t(2));
+        CheckThrows([&] { ReadAs<vector<int>>("[1, 2]", options); });
+    }
+
+    // Duplicate keys are rejected as Read rejects them
+    {
+        const char *const pDuplicates[] =
+        {
+            R"({"port" : 1, "host" : "a", "port" : 2})",
+            R"({"x" : 1, "host" : "a", "x" : [2]})",
+            R"({"x" : 1, "\u0078" : 2})"
+        };
+
+        for( const char *const pJson: pDuplicates )
+        {
+            CheckThrows([&] { Read(pJson); });
+            CheckThrows([&] { ReadAs<Config::Endpoint>(pJson); });
+        }
+
+        CheckThrows([] { ReadAs<map<string, int>>(R"({"a" : 1, "a" : 2})"); });
+
+        // Sibling and nested objects may reuse the keys
+        const auto endpoints = ReadAs<vector<Config::Endpoint>>(R"([{"x" : {"x" : 1}, "port" : 1}, {"x" : 2, "port" : 2}])");
+        CheckEqual(endpoints[1].port, 2);
+        CheckEqual(ReadAs<map<string, map<string, int>>>(R"({"a" : {"a" : 1}, "b" : {"a" : 2}})").at("b").at("a"), 2);
+    }
+}
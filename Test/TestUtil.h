@@ -28,3 +28,18 @@ void CheckNotNull(const T *const ptr)
     if( ptr == nullptr )
         throw std::runtime_error("CheckNotNull failed");
 }
+
+template <class Func>
+void CheckThrows(const Func &func)
+{
+    try
+    {
+        func();
+    }
+    catch(const std::exception &)
+    {
+        return;
+    }
+
+    throw std::runtime_error("CheckThrows failed");
+}
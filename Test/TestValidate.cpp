@@ -0,0 +1,89 @@
+
+#include "TinyJson.h"
+#include "TestUtil.h"
+
+using namespace std;
+using namespace TinyJson;
+
+void TestValidate()
+{
+    // Well-formed documents
+    for( const char *const pData: { " 0 ", "-1.5e+10", "\"\"", "[]", "{ }", "[[], {}, [[]]]", " true", "null\n",
+        R"({"a" : [1, "x\ty", {"b" : null}], "c" : "\/"})", "\"caf\xc3\xa9 \xf0\x9f\x98\x80\"" } )
+    {
+        Check(bool(Validate(pData)));
+        Read(pData);
+    }
+
+    // Malformed documents agree with Read and report where they go wrong
+    const auto Fails = [] (const string &data, const size_t offset)
+    {
+        const auto result = Validate(data);
+        Check(!result);
+        CheckEqual(result.offset, offset);
+        CheckNotNull(result.pMessage);
+    };
+
+    Fails("", 0);
+    Fails("  ", 2);
+    Fails("01", 1);
+    Fails("-", 1);
+    Fails("1.", 2);
+    Fails("1e+", 3);
+    Fails("[1,]", 3);
+    Fails("[1 2]", 3);
+    Fails("{\"a\" 1}", 5);
+    Fails("{\"a\":1,}", 7);
+    Fails("{1:2}", 1);
+    Fails("[1]]", 3);
+    Fails("{} x", 3);
+    Fails("tru", 3);
+    Fails("[\"abc", 5);
+    Fails("\"a\\x\"", 3);
+    Fails("\"\\u12g4\"", 5);
+    Check(bool(Validate("\"\\u00E9\"")));
+    Check(bool(Validate(R"("\ud83d\ude00 \uD83D\uDE00")")));
+    Fails(R"("\ud83d")", 1);
+    Fails(R"("x\ud83d\u0041")", 2);
+    Fails(R"("\ude00\ud83d")", 1);
+    Check(bool(Validate(R"("\\ude00")")));
+    Fails("\"a\nb\"", 2);
+    Fails("[\f]", 1);
+
+    for( const char *const pData: { "01", "[1,]", "{} x", "[1]]" } )
+        CheckThrows([&] { Read(pData); });
+
+    // Strings must be valid UTF-8
+    Fails("\"\x80\"", 1);
+    Fails("\"ab\xc3\"", 3);
+    Fails("\"\xc0\xaf\"", 1);
+    Fails("\"\xed\xa0\x80\"", 1);
+    Fails("\"\xf4\x90\x80\x80\"", 1);
+    Fails("\"0123456789abcdef0123456789\xff\"", 27);
+
+    // Embedded nulls are not the end of input
+    Fails(string("[1]\0", 4), 3);
+    Fails(string("\"a\0\"", 4), 2);
+
+    // Depth is bounded by the fixed stack
+    {
+        const string deep = string(Validator::MaxDepth, '[') + string(Validator::MaxDepth, ']');
+        Check(bool(Validate(deep)));
+
+        Fails("[" + deep + "]", Validator::MaxDepth);
+    }
+
+    // Long string-heavy input takes the vectorized paths
+    {
+        string json = "[";
+        for( int i = 0; i < 1000; ++i )
+            json += (i ? ",\"" : "\"") + string(i % 70, 'x') + "\xe6\x97\xa5\xe6\x9c\xac\"";
+        json += "]";
+
+        Check(bool(Validate(json)));
+        Check(bool(Validate(json.data(), json.data() + json.size())));
+
+        json[json.size() - 5] = '\xff';
+        Check(!Validate(json));
+    }
+}
@@ -0,0 +1,45 @@
+
+#include "TinyJson.h"
+#include "TestUtil.h"
+
+using namespace std;
+using namespace TinyJson;
+
+void TestValue()
+{
+    // Compact representation
+    {
+        Check(sizeof(Value) <= 16);
+        Check(is_trivially_copyable<Value>::value);
+    }
+
+    // Type checks
+    {
+        Document doc;
+        doc.Parse(R"( [1, "two", true, null, [], {}] )");
+
+        const auto arr = doc.Root().AsArray();
+        Check(arr[0].IsNumber());
+        Check(arr[1].IsString());
+        Check(arr[2].IsBoolean());
+        Check(arr[3].IsNull());
+        Check(arr[4].IsArray());
+        Check(arr[5].IsObject());
+
+        CheckThrows([&] { arr[0].AsString(); });
+        CheckThrows([&] { arr[1].AsNumber(); });
+    }
+
+    // Conversions
+    {
+        Document doc;
+        doc.Parse(R"( {"ints" : [1, 2, 3], "words" : ["a", "b"], "pair" : ["x", 2.5], "nested" : {"k" : [true]}} )");
+
+        const auto obj = doc.Root().AsObject();
+        CheckEqual(Convert<vector<int>>(obj.at("ints")), vector<int>{ 1, 2, 3 });
+        CheckEqual(Convert<deque<long>>(obj.at("ints")), deque<long>{ 1, 2, 3 });
+        CheckEqual(Convert<list<string>>(obj.at("words")), list<string>{ "a", "b" });
+        CheckEqual(Convert<pair<string, double>>(obj.at("pair")), make_pair(string("x"), 2.5));
+        CheckEqual(Convert<map<string, vector<bool>>>(obj.at("nested")), map<string, vector<bool>>{ { "k", { true } } });
+    }
+}
@@ -0,0 +1,134 @@
+
+#include "TinyJson.h"
+#include "TestUtil.h"
+
+#include <cstdio>
+#include <map>
+#include <vector>
+
+using namespace std;
+using namespace TinyJson;
+
+namespace
+{
+    void TestNumbers()
+    {
+        CheckEqual(ToString(Read("0.1")), string("0.1"));
+        CheckEqual(ToString(Read("-2.5e-7")), string("-2.5e-7"));
+        CheckEqual(ToString(Read("1e300")), string("1e300"));
+        CheckEqual(ToString(Read("100.0")), string("100.0"));
+        CheckEqual(ToString(Read("-9223372036854775808")), string("-9223372036854775808"));
+        CheckEqual(ToString(Read("18446744073709551615")), string("18446744073709551615"));
+        CheckEqual(ToString(-0.0), string("-0.0"));
+        CheckEqual(ToString(5e-324), string("5e-324"));
+
+        // Shortest output reads back to the same double
+        const double values[] = { 1.0 / 3, 2.0 / 3, 1.7976931348623157e308, 2.2250738585072014e-308, 123456.789, 0.3 };
+        for( const double value: values )
+            CheckEqual(Convert<double>(Read(ToString(value))), value);
+
+        CheckThrows([] { ToString(HUGE_VAL); });
+
+        // Floats get the digits a float needs, not a double's
+        CheckEqual(ToString(0.1f), string("0.1"));
+        CheckEqual(ToString(3.4028235e38f), string("3.4028235e38"));
+        CheckEqual(ToString(1e-45f), string("1e-45"));
+        CheckEqual(ToString(vector<float>{ 16777216.0f, -0.0f }), string("[16777216.0,-0.0]"));
+
+        const float floats[] = { 1.0f / 3, 2.0f / 3, 1.17549435e-38f, 123456.79f, 0.3f, 7.006492e-45f };
+        for( const float value: floats )
+            CheckEqual(Convert<float>(Read(ToString(value))), value);
+
+        CheckThrows([] { ToString(HUGE_VALF); });
+    }
+
+    void TestStrings()
+    {
+        CheckEqual(ToString(string("a\"b\\c\n\t\x01")), string("\"a\\\"b\\\\c\\n\\t\\u0001\""));
+
+        // Long strings go through the vectorized scan
+        const string text(5000, 'x');
+        CheckEqual(ToString(text + "\"" + text), "\"" + text + "\\\"" + text + "\"");
+
+        // Only well-formed UTF-8 is written, as the reader only accepts that
+        CheckEqual(ToString(string("caf\xc3\xa9 \xf0\x9f\x98\x80")), string("\"caf\xc3\xa9 \xf0\x9f\x98\x80\""));
+        CheckThrows([] { ToString(string("caf\xc3")); });
+        CheckThrows([] { ToString(string("\xc0\xaf")); });
+        CheckThrows([] { ToString(string("\xed\xa0\x80")); });
+        CheckThrows([&] { ToString(text + "\xff" + text); });
+
+        map<string, int> badKey;
+        badKey["\x80"] = 1;
+        CheckThrows([&] { ToString(badKey); });
+    }
+
+    void TestTrees()
+    {
+        const char *const pJson = R"({"a":[1,2.5,"x",true,false,null],"b":{},"c":[]})";
+
+        Document doc;
+        doc.Parse(pJson);
+        CheckEqual(ToString(doc.Root()), string(pJson));
+        CheckEqual(ToString(Read(pJson)), string(pJson));
+
+        WriteOptions options;
+        options.pretty = true;
+        options.indent = 2;
+        CheckEqual(ToString(Read(R"({"a":[1,{"b":null}],"c":[]})"), options),
+            string("{\n  \"a\": [\n    1,\n    {\n      \"b\": null\n    }\n  ],\n  \"c\": []\n}"));
+
+        // The writer is a handler, so it can re-serialize straight from input
+        string minified;
+        StringSink sink(minified);
+        Writer writer(sink);
+        Parse(" [ 1 , { \"k\" : \"v\" } ] ", writer);
+        writer.Flush();
+        CheckEqual(minified, string(R"([1,{"k":"v"}])"));
+    }
+
+    void TestConvertFrom()
+    {
+        map<string, vector<int>> m;
+        m["x"] = { 1, -2 };
+        m["y"] = { };
+        CheckEqual(ToString(m), string(R"({"x":[1,-2],"y":[]})"));
+        CheckEqual(ToString(make_pair(string("a"), 1.5)), string(R"(["a",1.5])"));
+        CheckEqual(ToString(vector<bool>{ true, false }), string("[true,false]"));
+
+        const auto back = Convert<map<string, vector<int>>>(Read(ToString(m)));
+        CheckEqual(back == m, true);
+    }
+
+    void TestSinks()
+    {
+        char buffer[8];
+        BufferSink small(buffer, sizeof(buffer));
+        Write(vector<int>{ 1, 2, 3 }, small);
+        CheckEqual(string(small.data(), small.size()), string("[1,2,3]"));
+
+        BufferSink tiny(buffer, 4);
+        CheckThrows([&] { Write(vector<int>{ 1, 2, 3 }, tiny); });
+
+        FILE *const pFile = tmpfile();
+        if( pFile )
+        {
+            FileSink fileSink(pFile);
+            Write(string("file"), fileSink);
+
+            rewind(pFile);
+            char text[16] = { };
+            CheckEqual(fread(text, 1, sizeof(text), pFile), size_t(6));
+            CheckEqual(string(text), string("\"file\""));
+            fclose(pFile);
+        }
+    }
+}
+
+void TestWriter()
+{
+    TestNumbers();
+    TestStrings();
+    TestTrees();
+    TestConvertFrom();
+    TestSinks();
+}
@@ -8,6 +8,24 @@ void TestNumber();
 void TestString();
 void TestArray();
 void TestObject();
+void TestDocument();
+void TestValue();
+void TestParse();
+void TestPushParser();
+void TestLines();
+void TestWriter();
+void TestFile();
+void TestKeyPool();
+void TestLazy();
+void TestTyped();
+void TestValidate();
+void TestLimits();
+void TestTape();
+void TestParser();
+void TestArrayDocument();
+void TestInSitu();
+void TestTranscode();
+void TestCache();
 
 int main()
 {
@@ -18,6 +36,24 @@ int main()
         TestString();
         TestArray();
         TestObject();
+        TestDocument();
+        TestValue();
+        TestParse();
+        TestPushParser();
+        TestLines();
+        TestWriter();
+        TestFile();
+        TestKeyPool();
+        TestLazy();
+        TestTyped();
+        TestValidate();
+        TestLimits();
+        TestTape();
+        TestParser();
+        TestArrayDocument();
+        TestInSitu();
+        TestTranscode();
+        TestCache();
 
         cout << "All tests passed" << endl;
     }
@@ -25,6 +61,7 @@ int main()
     {
         cout << "Test failed" << endl;
         cout << e.what() << endl;
+        return 1;
     }
 
     return 0;
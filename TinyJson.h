@@ -30,10 +30,53 @@
 #include <deque>
 #include <list>
 #include <unordered_map>
+#include <string>
+#include <cstring>
+#include <cstddef>
+#include <stdexcept>
+#include <iterator>
+#include <type_traits>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <cfloat>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <cstdio>
+#include <cerrno>
+#include <cctype>
+#include <limits>
+
+#if !defined(TinyJson_NoSimd) && (defined(__x86_64__) || defined(_M_X64))
+#define TinyJson_X64
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <string_view>
+#define TinyJson_HasStringView
+#endif
 
 namespace TinyJson
 {
-    enum class ValueType
+    enum class ValueType : std::uint8_t
     {
         Null,
         Number,
@@ -43,6 +86,13 @@ namespace TinyJson
         Boolean
     };
 
+    enum class NumberType : std::uint8_t
+    {
+        Double,
+        Int64,
+        UInt64
+    };
+
     struct ValueBase;
 
     using ValuePtr = std::unique_ptr<ValueBase>;
@@ -50,9 +100,72 @@ namespace TinyJson
     using Number = double;
     using String = std::string;
     using Array = std::vector<ValuePtr>;
-    using Object = std::map<std::string, ValuePtr>;
+    class Object;
     using Boolean = bool;
 
+    class StringView
+    {
+        const char *pData;
+        std::size_t length;
+
+    public:
+        StringView() :
+            pData(""),
+            length(0)
+        {
+        }
+
+        StringView(const char *const pStr) :
+            pData(pStr),
+            length(std::strlen(pStr))
+        {
+        }
+
+        StringView(const char *const pData_, const std::size_t length_) :
+            pData(pData_),
+            length(length_)
+        {
+        }
+
+        StringView(const std::string &str) :
+            pData(str.data()),
+            length(str.size())
+        {
+        }
+
+        const char *data() const { return pData; }
+        std::size_t size() const { return length; }
+        bool empty() const { return length == 0; }
+
+        const char *begin() const { return pData; }
+        const char *end() const { return pData + length; }
+
+        char operator [](const std::size_t index) const { return pData[index]; }
+
+        std::string str() const { return std::string(pData, length); }
+        operator std::string() const { return str(); }
+
+#ifdef TinyJson_HasStringView
+        operator std::string_view() const { return std::string_view(pData, length); }
+#endif
+
+        friend bool operator ==(const StringView &lhs, const StringView &rhs)
+        {
+            return lhs.length == rhs.length && (lhs.pData == rhs.pData || std::memcmp(lhs.pData, rhs.pData, lhs.length) == 0);
+        }
+
+        friend bool operator !=(const StringView &lhs, const StringView &rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+        friend bool operator <(const StringView &lhs, const StringView &rhs)
+        {
+            const int result = std::memcmp(lhs.pData, rhs.pData, std::min(lhs.length, rhs.length));
+            return result < 0 || (result == 0 && lhs.length < rhs.length);
+        }
+    };
+
     struct ValueBase
     {
         explicit ValueBase() =default;
@@ -75,21 +188,94 @@ namespace TinyJson
         virtual const Array &AsArray() const { throw std::runtime_error("value is not an array"); }
         virtual const Object &AsObject() const { throw std::runtime_error("value is not an object"); }
         virtual const Boolean &AsBoolean() const { throw std::runtime_error("value is not a boolean"); }
+
+        virtual bool IsInt64() const { return false; }
+        virtual bool IsUInt64() const { return false; }
+        virtual std::int64_t AsInt64() const { throw std::runtime_error("value is not a number"); }
+        virtual std::uint64_t AsUInt64() const { throw std::runtime_error("value is not a number"); }
     };
 
     inline ValueBase::~ValueBase() =default;
 
+    inline std::int64_t DoubleToInt64(const double number)
+    {
+        if( !(number >= -9223372036854775808.0 && number < 9223372036854775808.0) || number != std::floor(number) )
+            throw std::runtime_error("number is not a 64-bit integer");
+
+        return static_cast<std::int64_t>(number);
+    }
+
+    inline std::uint64_t DoubleToUInt64(const double number)
+    {
+        if( !(number >= 0 && number < 18446744073709551616.0) || number != std::floor(number) )
+            throw std::runtime_error("number is not an unsigned 64-bit integer");
+
+        return static_cast<std::uint64_t>(number);
+    }
+
     struct NullValue : public ValueBase
     {
         ValueType Type() const override { return ValueType::Null; }
     };
 
+    // Integral literals also keep their exact value in int64Value or
+    // uint64Value, as selected by numberType.
     struct NumberValue : public ValueBase
     {
         Number value;
+        NumberType numberType;
+
+        union
+        {
+            std::int64_t int64Value;
+            std::uint64_t uint64Value;
+        };
+
+        explicit NumberValue() :
+            value(0),
+            numberType(NumberType::Double),
+            int64Value(0)
+        {
+        }
 
         ValueType Type() const override { return ValueType::Number; }
         const Number &AsNumber() const override { return value; }
+
+        bool IsInt64() const override { return numberType == NumberType::Int64; }
+        bool IsUInt64() const override { return numberType == NumberType::UInt64; }
+
+        std::int64_t AsInt64() const override
+        {
+            switch( numberType )
+            {
+                case NumberType::Int64:
+                    return int64Value;
+
+                case NumberType::UInt64:
+                    throw std::runtime_error("number is not a 64-bit integer");
+
+                default:
+                    return DoubleToInt64(value);
+            }
+        }
+
+        std::uint64_t AsUInt64() const override
+        {
+            switch( numberType )
+            {
+                case NumberType::Int64:
+                    if( int64Value < 0 )
+                        throw std::runtime_error("number is not an unsigned 64-bit integer");
+
+                    return static_cast<std::uint64_t>(int64Value);
+
+                case NumberType::UInt64:
+                    return uint64Value;
+
+                default:
+                    return DoubleToUInt64(value);
+            }
+        }
     };
 
     struct StringValue : public ValueBase
@@ -108,501 +294,9607 @@ namespace TinyJson
         const Array &AsArray() const override { return value; }
     };
 
-    struct ObjectValue : public ValueBase
+    // Seeded multiply-xorshift hash over 8-byte words. Keys are short, so
+    // this beats std::hash and needs no std::string for the lookup.
+    inline std::uint64_t HashString(const char *pData, std::size_t length)
     {
-        Object value;
+        const std::uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+        std::uint64_t hash = length * multiplier;
 
-        ValueType Type() const override { return ValueType::Object; }
-        const Object &AsObject() const override { return value; }
-    };
+        for( ; length >= 8; pData += 8, length -= 8 )
+        {
+            std::uint64_t word;
+            std::memcpy(&word, pData, 8);
+            hash = (hash ^ word) * multiplier;
+            hash ^= hash >> 29;
+        }
 
-    struct BooleanValue : public ValueBase
-    {
-        Boolean value;
+        if( length != 0 )
+        {
+            std::uint64_t word = 0;
+            std::memcpy(&word, pData, length);
+            hash = (hash ^ word) * multiplier;
+        }
 
-        ValueType Type() const override { return ValueType::Boolean; }
-        const Boolean &AsBoolean() const override { return value; }
-    };
+        hash ^= hash >> 32;
+        hash *= multiplier;
 
-#define TinyJson_Digits_0_9 \
-         '0': \
-    case '1': \
-    case '2': \
-    case '3': \
-    case '4': \
-    case '5': \
-    case '6': \
-    case '7': \
-    case '8': \
-    case '9'
+        return hash ^ (hash >> 29);
+    }
 
-    template <class Itr>
-    class CharItr
+    // One mixing step of HashString.
+    inline std::uint64_t HashWord(std::uint64_t hash, const char *const pData)
     {
-        static_assert(std::is_same<typename std::iterator_traits<Itr>::value_type, char>::value, "char iterator expected");
+        std::uint64_t word;
+        std::memcpy(&word, pData, 8);
 
-        Itr itr;
-        Itr end;
+        hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+        return hash ^ (hash >> 29);
+    }
 
-    public:
-        explicit CharItr(const Itr &begin_, const Itr &end_) :
-            itr(begin_),
-            end(end_)
-        {
-        }
+    // HashString for whole documents. Long inputs are mixed in four
+    // independent lanes of 8-byte words, which the CPU overlaps, and the
+    // lanes are folded into the hash of the tail.
+    inline std::uint64_t HashBytes(const char *pData, std::size_t length)
+    {
+        if( length < 64 )
+            return HashString(pData, length);
 
-        char operator *() const
-        {
-            if( itr != end )
-                return *itr;
+        const std::uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+        std::uint64_t lane0 = length * multiplier;
+        std::uint64_t lane1 = (length + 1) * multiplier;
+        std::uint64_t lane2 = (length + 2) * multiplier;
+        std::uint64_t lane3 = (length + 3) * multiplier;
 
-            return 0;
+        for( ; length >= 32; pData += 32, length -= 32 )
+        {
+            lane0 = HashWord(lane0, pData);
+            lane1 = HashWord(lane1, pData + 8);
+            lane2 = HashWord(lane2, pData + 16);
+            lane3 = HashWord(lane3, pData + 24);
         }
 
-        void operator ++()
+        const std::uint64_t lanes[] = { lane0, lane1, lane2, lane3 };
+
+        std::uint64_t hash = HashString(pData, length);
+        for( const std::uint64_t lane: lanes )
         {
-            if( itr != end )
-                ++itr;
+            hash = (hash ^ lane) * multiplier;
+            hash ^= hash >> 29;
         }
-    };
 
-    template <class Itr>
-    class Reader
+        return hash;
+    }
+
+    // Members of a legacy object in insertion order. Small objects are a
+    // single vector searched linearly, so they cost one allocation where
+    // std::map costs one per member; larger ones also keep the hash of each
+    // key and an open-addressing index. The lookup API follows std::map;
+    // keys must not be modified through an iterator.
+    class Object
     {
-        static bool IsWhitespace(const char ch)
+    public:
+        using key_type = std::string;
+        using mapped_type = ValuePtr;
+        using value_type = std::pair<std::string, ValuePtr>;
+        using size_type = std::size_t;
+        using iterator = std::vector<value_type>::iterator;
+        using const_iterator = std::vector<value_type>::const_iterator;
+
+    private:
+        static const std::size_t IndexThreshold = 16;
+
+        std::vector<value_type> members;
+
+        // Hash per member, kept only while the index is.
+        std::vector<std::uint64_t> hashes;
+
+        // Member position plus one per slot, zero for empty slots; the size
+        // is a power of two at least twice the member count.
+        std::vector<std::uint32_t> index;
+
+        void Insert(const std::size_t position)
         {
-            switch( ch )
+            const std::size_t mask = index.size() - 1;
+            for( std::size_t slot = hashes[position] & mask; ; slot = (slot + 1) & mask )
             {
-                case ' ':
-                case '\f':
-                case '\n':
-                case '\r':
-                case '\t':
-                case '\v':
-                    return true;
+                if( index[slot] == 0 )
+                {
+                    index[slot] = static_cast<std::uint32_t>(position + 1);
+                    return;
+                }
             }
-
-            return false;
         }
 
-        static void SkipWhitespace(Itr &itr)
+        void RebuildIndex()
         {
-            while( IsWhitespace(*itr) )
-                ++itr;
-        }
+            index.clear();
+            if( members.size() <= IndexThreshold )
+            {
+                hashes.clear();
+                return;
+            }
 
-        template <class T, class U>
-        static std::unique_ptr<T> CreateValue(U &&value)
-        {
-            static_assert(std::is_base_of<ValueBase, T>::value, "internal error: invalid type passed to CreateValue");
+            if( hashes.size() != members.size() )
+            {
+                hashes.clear();
+                hashes.reserve(members.capacity());
 
-            std::unique_ptr<T> ptr(new T());
-            ptr->value = std::move(value);
+                for( const value_type &member: members )
+                    hashes.push_back(HashString(member.first.data(), member.first.size()));
+            }
 
-            return ptr;
+            std::size_t slots = 64;
+            while( slots < members.size() * 2 )
+                slots *= 2;
+
+            index.assign(slots, 0);
+            for( std::size_t i = 0; i < members.size(); ++i )
+                Insert(i);
         }
 
-        template <std::size_t N>
-        static bool TryReadExpectedString(Itr &itr, const char(&pStr)[N])
+        std::size_t FindLinear(const StringView &key) const
         {
-            static_assert(N > 0, "internal error: string not null-terminated");
-
-            for(std::size_t i = 0; i < (N - 1); ++i, ++itr)
-                if( *itr != pStr[i] )
-                    return false;
+            for( std::size_t i = 0; i < members.size(); ++i )
+                if( StringView(members[i].first) == key )
+                    return i;
 
-            return true;
+            return members.size();
         }
 
-        static double ReadNumber(Itr &itr)
+        std::size_t Find(const StringView &key, const std::uint64_t hash) const
         {
-            int sign = 1;
-            if( *itr == '-' )
+            const std::size_t mask = index.size() - 1;
+            for( std::size_t slot = hash & mask; index[slot] != 0; slot = (slot + 1) & mask )
             {
-                sign = -1;
-                ++itr;
+                const std::size_t i = index[slot] - 1;
+                if( hashes[i] == hash && StringView(members[i].first) == key )
+                    return i;
             }
 
-            double number = 0;
-            for( ; *itr; ++itr )
-            {
-                switch( *itr )
-                {
-                    case TinyJson_Digits_0_9:
-                        number = number * 10 + (*itr - '0');
-                        continue;
-                }
+            return members.size();
+        }
 
-                break;
-            }
+        std::size_t Find(const StringView &key) const
+        {
+            if( index.empty() )
+                return FindLinear(key);
 
-            if( *itr == '.' )
-            {
-                ++itr;
+            return Find(key, HashString(key.data(), key.size()));
+        }
 
-                int factor = 1;
-                for( ; *itr; ++itr, factor *= 10 )
-                {
-                    switch( *itr )
-                    {
-                        case TinyJson_Digits_0_9:
-                            number = number * 10 + (*itr - '0');
-                            continue;
-                    }
+    public:
+        explicit Object() =default;
 
-                    break;
-                }
+        Object(Object &&) =default;
+        Object &operator =(Object &&) =default;
 
-                number /= factor;
-            }
+        iterator begin() { return members.begin(); }
+        iterator end() { return members.end(); }
+        const_iterator begin() const { return members.begin(); }
+        const_iterator end() const { return members.end(); }
 
-            if( *itr == 'e' || *itr == 'E' )
-            {
-                ++itr;
+        std::size_t size() const { return members.size(); }
+        bool empty() const { return members.empty(); }
 
-                bool eNegative = false;
-                if( *itr == '+' )
-                {
-                    ++itr;
-                }
-                else if( *itr == '-' )
-                {
-                    eNegative = true;
-                    ++itr;
-                }
+        void reserve(const std::size_t capacity)
+        {
+            members.reserve(capacity);
+            if( capacity > IndexThreshold )
+                hashes.reserve(capacity);
+        }
 
-                int e = 0;
-                for( ; *itr; ++itr )
-                {
-                    switch( *itr )
-                    {
-                        case TinyJson_Digits_0_9:
-                            e = e * 10 + (*itr - '0');
-                            continue;
-                    }
+        void clear()
+        {
+            members.clear();
+            hashes.clear();
+            index.clear();
+        }
 
-                    break;
-                }
+        iterator find(const StringView &key)
+        {
+            return members.begin() + static_cast<std::ptrdiff_t>(Find(key));
+        }
 
-                int power = 1;
-                for( int i = 0; i < e; ++i )
-                    power *= 10;
+        const_iterator find(const StringView &key) const
+        {
+            return members.begin() + static_cast<std::ptrdiff_t>(Find(key));
+        }
 
-                if( eNegative )
-                    number /= power;
-                else
-                    number *= power;
-            }
+        std::size_t count(const StringView &key) const
+        {
+            return Find(key) != members.size() ? 1 : 0;
+        }
 
-            number *= sign;
+        const ValuePtr &at(const StringView &key) const
+        {
+            const std::size_t i = Find(key);
+            if( i == members.size() )
+                throw std::out_of_range("key not found: " + key.str());
 
-            return number;
+            return members[i].second;
         }
 
-        static void ReadExpectedChar(Itr &itr, const char ch)
+        ValuePtr &at(const StringView &key)
         {
-            if( *itr != ch )
-                throw std::runtime_error("'" + std::string(1, ch) + "' expected");
+            const std::size_t i = Find(key);
+            if( i == members.size() )
+                throw std::out_of_range("key not found: " + key.str());
 
-            ++itr;
+            return members[i].second;
         }
 
-        static String ReadString(Itr &itr)
+        // Appends the member unless the key exists; like std::map::emplace,
+        // the second field tells whether it was inserted.
+        std::pair<iterator, bool> emplace(std::string key, ValuePtr value)
         {
-            assert(*itr == '"');
-            ++itr;
+            if( index.empty() )
+            {
+                const std::size_t existing = FindLinear(key);
+                if( existing != members.size() )
+                    return std::make_pair(members.begin() + static_cast<std::ptrdiff_t>(existing), false);
 
-            String str;
+                members.emplace_back(std::move(key), std::move(value));
+                if( members.size() > IndexThreshold )
+                    RebuildIndex();
 
-            for( ; *itr; ++itr )
-            {
-                if( *itr == '\\' )
-                {
-                    ++itr;
-                    switch( *itr )
-                    {
-                        case '"':
-                        case '\\':
-                        case '/':
-                            str.push_back(*itr);
-                            break;
+                return std::make_pair(members.end() - 1, true);
+            }
 
-                        case 'b':str.push_back('\b'); break;
-                        case 'f':str.push_back('\f'); break;
-                        case 'n':str.push_back('\n'); break;
-                        case 'r':str.push_back('\r'); break;
-                        case 't':str.push_back('\t'); break;
+            const std::uint64_t hash = HashString(key.data(), key.size());
 
-                        case 'u':
-                            throw std::runtime_error("\\u control character not implemented");
-                            break;
+            const std::size_t existing = Find(key, hash);
+            if( existing != members.size() )
+                return std::make_pair(members.begin() + static_cast<std::ptrdiff_t>(existing), false);
 
-                        default:
-                            throw std::runtime_error("unrecognized character escape sequence: \\" + std::string(1, *itr));
-                            break;
-                    }
-                }
-                else if( *itr == '"' )
-                {
-                    break;
-                }
-                else
-                {
-                    str.push_back(*itr);
-                }
-            }
+            members.emplace_back(std::move(key), std::move(value));
+            hashes.push_back(hash);
 
-            ReadExpectedChar(itr, '"');
-            return str;
+            if( members.size() * 2 > index.size() )
+                RebuildIndex();
+            else
+                Insert(members.size() - 1);
+
+            return std::make_pair(members.end() - 1, true);
         }
 
-        static Array ReadArray(Itr &itr)
+        std::pair<iterator, bool> insert(value_type &&member)
         {
-            assert(*itr == '[');
-            ++itr;
+            return emplace(std::move(member.first), std::move(member.second));
+        }
 
-            Array arr;
+        ValuePtr &operator [](const std::string &key)
+        {
+            return emplace(key, ValuePtr()).first->second;
+        }
 
-            for( ;; )
-            {
-                arr.push_back(ReadValue(itr));
+        iterator erase(const_iterator position)
+        {
+            const std::ptrdiff_t offset = position - members.cbegin();
 
-                SkipWhitespace(itr);
-                if( *itr == ',' )
-                {
-                    ++itr;
-                    continue;
-                }
+            members.erase(members.begin() + offset);
+            if( !hashes.empty() )
+                hashes.erase(hashes.begin() + offset);
 
-                ReadExpectedChar(itr, ']');
-                break;
-            }
+            RebuildIndex();
 
-            return arr;
+            return members.begin() + offset;
         }
 
-        static std::string ReadKey(Itr &itr)
+        std::size_t erase(const StringView &key)
+        {
+            const std::size_t i = Find(key);
+            if( i == members.size() )
+                return 0;
+
+            erase(members.cbegin() + static_cast<std::ptrdiff_t>(i));
+            return 1;
+        }
+    };
+
+    struct ObjectValue : public ValueBase
+    {
+        Object value;
+
+        ValueType Type() const override { return ValueType::Object; }
+        const Object &AsObject() const override { return value; }
+    };
+
+    struct BooleanValue : public ValueBase
+    {
+        Boolean value;
+
+        ValueType Type() const override { return ValueType::Boolean; }
+        const Boolean &AsBoolean() const override { return value; }
+    };
+
+    class Arena
+    {
+        struct Block
+        {
+            Block *pNext;
+            std::size_t size;
+        };
+
+        static const std::size_t MinBlockSize = 4096;
+        static const std::size_t MaxBlockSize = 1024 * 1024;
+
+        Block *pHead;
+        Block *pSpare;
+        char *pCurrent;
+        char *pEnd;
+        std::size_t nextBlockSize;
+
+        static void Free(Block *pBlock)
+        {
+            while( pBlock )
+            {
+                Block *const pNext = pBlock->pNext;
+                ::operator delete(pBlock);
+                pBlock = pNext;
+            }
+        }
+
+        void AddBlock(const std::size_t minSize)
+        {
+            if( pSpare && pSpare->size >= minSize )
+            {
+                Block *const pBlock = pSpare;
+                pSpare = pBlock->pNext;
+                pBlock->pNext = pHead;
+                pHead = pBlock;
+
+                pCurrent = reinterpret_cast<char *>(pBlock + 1);
+                pEnd = pCurrent + pBlock->size;
+                return;
+            }
+
+            const std::size_t size = std::max(minSize, nextBlockSize);
+
+            Block *const pBlock = static_cast<Block *>(::operator new(sizeof(Block) + size));
+            pBlock->pNext = pHead;
+            pBlock->size = size;
+            pHead = pBlock;
+
+            pCurrent = reinterpret_cast<char *>(pBlock + 1);
+            pEnd = pCurrent + size;
+
+            if( nextBlockSize < MaxBlockSize )
+                nextBlockSize *= 2;
+        }
+
+    public:
+        explicit Arena() :
+            pHead(nullptr),
+            pSpare(nullptr),
+            pCurrent(nullptr),
+            pEnd(nullptr),
+            nextBlockSize(MinBlockSize)
+        {
+        }
+
+        Arena(Arena &&other) :
+            pHead(other.pHead),
+            pSpare(other.pSpare),
+            pCurrent(other.pCurrent),
+            pEnd(other.pEnd),
+            nextBlockSize(other.nextBlockSize)
+        {
+            other.pHead = nullptr;
+            other.pSpare = nullptr;
+            other.pCurrent = nullptr;
+            other.pEnd = nullptr;
+            other.nextBlockSize = MinBlockSize;
+        }
+
+        Arena &operator =(Arena &&other)
+        {
+            if( this != &other )
+            {
+                Clear();
+                std::swap(pHead, other.pHead);
+                std::swap(pSpare, other.pSpare);
+                std::swap(pCurrent, other.pCurrent);
+                std::swap(pEnd, other.pEnd);
+                std::swap(nextBlockSize, other.nextBlockSize);
+            }
+
+            return *this;
+        }
+
+        Arena(const Arena &) =delete;
+        void operator =(const Arena &) =delete;
+
+        ~Arena()
+        {
+            Clear();
+        }
+
+        void *Allocate(const std::size_t size, const std::size_t alignment = alignof(std::max_align_t))
+        {
+            assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+            std::size_t padding = static_cast<std::size_t>(-reinterpret_cast<std::uintptr_t>(pCurrent)) & (alignment - 1);
+            if( size + padding > static_cast<std::size_t>(pEnd - pCurrent) )
+            {
+                AddBlock(size + alignment);
+                padding = static_cast<std::size_t>(-reinterpret_cast<std::uintptr_t>(pCurrent)) & (alignment - 1);
+            }
+
+            char *const ptr = pCurrent + padding;
+            pCurrent = ptr + size;
+
+            return ptr;
+        }
+
+        template <class T>
+        T *AllocateArray(const std::size_t count)
+        {
+            static_assert(std::is_trivially_destructible<T>::value, "arena objects are never destroyed");
+
+            return static_cast<T *>(Allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        const char *CopyString(const char *const pStr, const std::size_t length)
+        {
+            char *const ptr = static_cast<char *>(Allocate(length + 1, 1));
+            std::memcpy(ptr, pStr, length);
+            ptr[length] = 0;
+
+            return ptr;
+        }
+
+        // Releases every block except the most recent, which is the largest,
+        // so a reused arena stops allocating once it reaches its working size.
+        void Reset()
+        {
+            Free(pSpare);
+            pSpare = nullptr;
+
+            if( !pHead )
+                return;
+
+            Free(pHead->pNext);
+
+            pHead->pNext = nullptr;
+            pCurrent = reinterpret_cast<char *>(pHead + 1);
+            pEnd = pCurrent + pHead->size;
+        }
+
+        // Keeps every block for reuse in the order they were first filled, so
+        // documents spanning several blocks are parsed again without allocating.
+        void Rewind()
+        {
+            while( pHead )
+            {
+                Block *const pNext = pHead->pNext;
+                pHead->pNext = pSpare;
+                pSpare = pHead;
+                pHead = pNext;
+            }
+
+            pCurrent = nullptr;
+            pEnd = nullptr;
+        }
+
+        void Clear()
+        {
+            Free(pHead);
+            Free(pSpare);
+
+            pHead = nullptr;
+            pSpare = nullptr;
+            pCurrent = nullptr;
+            pEnd = nullptr;
+            nextBlockSize = MinBlockSize;
+        }
+
+        // Bytes held in blocks, in use or kept for reuse.
+        std::size_t Capacity() const
+        {
+            std::size_t capacity = 0;
+
+            for( const Block *pBlock = pHead; pBlock; pBlock = pBlock->pNext )
+                capacity += pBlock->size;
+
+            for( const Block *pBlock = pSpare; pBlock; pBlock = pBlock->pNext )
+                capacity += pBlock->size;
+
+            return capacity;
+        }
+    };
+
+    // Interned object keys. A document parsed with a pool stores each key
+    // once in the pool, so repeated keys cost no memory and equal keys share
+    // a pointer. The pool is bounded: once full, new keys are copied into the
+    // document as usual. After Freeze it is read-only and can be shared by
+    // documents parsed on different threads.
+    class KeyPool
+    {
+        struct Slot
+        {
+            std::uint64_t hash;
+            const char *pStr;
+            std::size_t length;
+        };
+
+        Arena arena;
+        std::vector<Slot> slots;
+        std::size_t count;
+        std::size_t maxKeys;
+        std::size_t maxKeyLength;
+        bool frozen;
+
+        const Slot *Find(const StringView &key, const std::uint64_t hash) const
+        {
+            if( slots.empty() )
+                return nullptr;
+
+            const std::size_t mask = slots.size() - 1;
+            for( std::size_t i = hash & mask; slots[i].pStr; i = (i + 1) & mask )
+                if( slots[i].hash == hash && StringView(slots[i].pStr, slots[i].length) == key )
+                    return &slots[i];
+
+            return nullptr;
+        }
+
+        void Insert(const Slot &slot)
+        {
+            const std::size_t mask = slots.size() - 1;
+
+            std::size_t i = slot.hash & mask;
+            while( slots[i].pStr )
+                i = (i + 1) & mask;
+
+            slots[i] = slot;
+        }
+
+        void Grow()
+        {
+            std::vector<Slot> old(slots.empty() ? 256 : slots.size() * 2, Slot());
+            old.swap(slots);
+
+            for( const Slot &slot: old )
+                if( slot.pStr )
+                    Insert(slot);
+        }
+
+    public:
+        explicit KeyPool(const std::size_t maxKeys_ = 65536, const std::size_t maxKeyLength_ = 128) :
+            count(0),
+            maxKeys(maxKeys_),
+            maxKeyLength(maxKeyLength_),
+            frozen(false)
+        {
+        }
+
+        KeyPool(const KeyPool &) =delete;
+        void operator =(const KeyPool &) =delete;
+
+        // Returns the pooled copy of the key, adding it while the pool is not
+        // frozen or full; returns nullptr when the key is not pooled.
+        const char *Intern(const StringView &key)
+        {
+            if( key.size() > maxKeyLength )
+                return nullptr;
+
+            const std::uint64_t hash = HashString(key.data(), key.size());
+            if( const Slot *const pSlot = Find(key, hash) )
+                return pSlot->pStr;
+
+            if( frozen || count == maxKeys )
+                return nullptr;
+
+            if( (count + 1) * 2 > slots.size() )
+                Grow();
+
+            Slot slot;
+            slot.hash = hash;
+            slot.pStr = arena.CopyString(key.data(), key.size());
+            slot.length = key.size();
+
+            Insert(slot);
+            ++count;
+
+            return slot.pStr;
+        }
+
+        // Read-only lookup, safe to call concurrently once the pool is frozen.
+        const char *Find(const StringView &key) const
+        {
+            if( key.size() > maxKeyLength )
+                return nullptr;
+
+            const Slot *const pSlot = Find(key, HashString(key.data(), key.size()));
+            return pSlot ? pSlot->pStr : nullptr;
+        }
+
+        // Stops adding keys, so the pool can be read by several threads.
+        void Freeze()
+        {
+            frozen = true;
+        }
+
+        bool IsFrozen() const
+        {
+            return frozen;
+        }
+
+        std::size_t size() const
+        {
+            return count;
+        }
+    };
+
+    struct Member;
+    class ArrayView;
+    class ObjectView;
+
+    // Compact 16-byte tagged union used by Document. Strings, items and
+    // members point into the arena that owns the document.
+    class Value
+    {
+        union
+        {
+            Number number;
+            std::int64_t int64;
+            std::uint64_t uint64;
+            Boolean boolean;
+            const char *pString;
+            const Value *pItems;
+            const Member *pMembers;
+        };
+
+        std::uint32_t size;
+        ValueType type;
+        NumberType numberType;
+
+        static std::uint32_t CheckedSize(const std::size_t size)
+        {
+            if( size > UINT32_MAX )
+                throw std::runtime_error("value too large");
+
+            return static_cast<std::uint32_t>(size);
+        }
+
+    public:
+        static Value MakeNull()
+        {
+            Value value;
+            value.numberType = NumberType::Double;
+            value.type = ValueType::Null;
+            value.size = 0;
+            value.pString = nullptr;
+            return value;
+        }
+
+        static Value MakeNumber(const Number number)
+        {
+            Value value;
+            value.numberType = NumberType::Double;
+            value.type = ValueType::Number;
+            value.size = 0;
+            value.number = number;
+            return value;
+        }
+
+        static Value MakeInt64(const std::int64_t int64)
+        {
+            Value value = MakeNumber(0);
+            value.numberType = NumberType::Int64;
+            value.int64 = int64;
+            return value;
+        }
+
+        static Value MakeUInt64(const std::uint64_t uint64)
+        {
+            Value value = MakeNumber(0);
+            value.numberType = NumberType::UInt64;
+            value.uint64 = uint64;
+            return value;
+        }
+
+        static Value MakeBoolean(const Boolean boolean)
+        {
+            Value value;
+            value.numberType = NumberType::Double;
+            value.type = ValueType::Boolean;
+            value.size = 0;
+            value.boolean = boolean;
+            return value;
+        }
+
+        static Value MakeString(const char *const pStr, const std::size_t length)
+        {
+            Value value;
+            value.numberType = NumberType::Double;
+            value.type = ValueType::String;
+            value.size = CheckedSize(length);
+            value.pString = pStr;
+            return value;
+        }
+
+        static Value MakeArray(const Value *const pItems, const std::size_t count)
+        {
+            Value value;
+            value.numberType = NumberType::Double;
+            value.type = ValueType::Array;
+            value.size = CheckedSize(count);
+            value.pItems = pItems;
+            return value;
+        }
+
+        static Value MakeObject(const Member *const pMembers, const std::size_t count)
+        {
+            Value value;
+            value.numberType = NumberType::Double;
+            value.type = ValueType::Object;
+            value.size = CheckedSize(count);
+            value.pMembers = pMembers;
+            return value;
+        }
+
+        ValueType Type() const { return type; }
+
+        bool IsNull() const { return type == ValueType::Null; }
+        bool IsNumber() const { return type == ValueType::Number; }
+        bool IsString() const { return type == ValueType::String; }
+        bool IsArray() const { return type == ValueType::Array; }
+        bool IsObject() const { return type == ValueType::Object; }
+        bool IsBoolean() const { return type == ValueType::Boolean; }
+
+        bool IsInt64() const { return IsNumber() && numberType == NumberType::Int64; }
+        bool IsUInt64() const { return IsNumber() && numberType == NumberType::UInt64; }
+
+        Number AsNumber() const
+        {
+            if( !IsNumber() )
+                throw std::runtime_error("value is not a number");
+
+            switch( numberType )
+            {
+                case NumberType::Int64: return static_cast<Number>(int64);
+                case NumberType::UInt64: return static_cast<Number>(uint64);
+                default: return number;
+            }
+        }
+
+        std::int64_t AsInt64() const
+        {
+            if( !IsNumber() )
+                throw std::runtime_error("value is not a number");
+
+            switch( numberType )
+            {
+                case NumberType::Int64:
+                    return int64;
+
+                case NumberType::UInt64:
+                    throw std::runtime_error("number is not a 64-bit integer");
+
+                default:
+                    return DoubleToInt64(number);
+            }
+        }
+
+        std::uint64_t AsUInt64() const
+        {
+            if( !IsNumber() )
+                throw std::runtime_error("value is not a number");
+
+            switch( numberType )
+            {
+                case NumberType::Int64:
+                    if( int64 < 0 )
+                        throw std::runtime_error("number is not an unsigned 64-bit integer");
+
+                    return static_cast<std::uint64_t>(int64);
+
+                case NumberType::UInt64:
+                    return uint64;
+
+                default:
+                    return DoubleToUInt64(number);
+            }
+        }
+
+        StringView AsString() const
+        {
+            if( !IsString() )
+                throw std::runtime_error("value is not a string");
+
+            return StringView(pString, size);
+        }
+
+        ArrayView AsArray() const;
+        ObjectView AsObject() const;
+
+        Boolean AsBoolean() const
+        {
+            if( !IsBoolean() )
+                throw std::runtime_error("value is not a boolean");
+
+            return boolean;
+        }
+    };
+
+    static_assert(sizeof(Value) <= 16, "Value must stay compact");
+    static_assert(std::is_trivial<Value>::value && std::is_standard_layout<Value>::value, "Value must be a POD type");
+
+    struct Member
+    {
+        Value key;
+        Value value;
+    };
+
+    class ArrayView
+    {
+        const Value *pItems;
+        std::size_t length;
+
+    public:
+        explicit ArrayView(const Value *const pItems_, const std::size_t length_) :
+            pItems(pItems_),
+            length(length_)
+        {
+        }
+
+        const Value *begin() const { return pItems; }
+        const Value *end() const { return pItems + length; }
+
+        std::size_t size() const { return length; }
+        bool empty() const { return length == 0; }
+
+        const Value &operator [](const std::size_t index) const { return pItems[index]; }
+
+        const Value &at(const std::size_t index) const
+        {
+            if( index >= length )
+                throw std::out_of_range("array index out of range");
+
+            return pItems[index];
+        }
+    };
+
+    class ObjectView
+    {
+        const Member *pMembers;
+        std::size_t length;
+
+    public:
+        explicit ObjectView(const Member *const pMembers_, const std::size_t length_) :
+            pMembers(pMembers_),
+            length(length_)
+        {
+        }
+
+        const Member *begin() const { return pMembers; }
+        const Member *end() const { return pMembers + length; }
+
+        std::size_t size() const { return length; }
+        bool empty() const { return length == 0; }
+
+        const Member *find(const StringView &key) const
+        {
+            for( const auto &member: *this )
+                if( member.key.AsString() == key )
+                    return &member;
+
+            return end();
+        }
+
+        std::size_t count(const StringView &key) const
+        {
+            return find(key) != end() ? 1 : 0;
+        }
+
+        const Value &at(const StringView &key) const
+        {
+            const auto itr = find(key);
+            if( itr == end() )
+                throw std::out_of_range("key not found: " + key.str());
+
+            return itr->value;
+        }
+    };
+
+    inline ArrayView Value::AsArray() const
+    {
+        if( !IsArray() )
+            throw std::runtime_error("value is not an array");
+
+        return ArrayView(pItems, size);
+    }
+
+    inline ObjectView Value::AsObject() const
+    {
+        if( !IsObject() )
+            throw std::runtime_error("value is not an object");
+
+        return ObjectView(pMembers, size);
+    }
+
+#define TinyJson_Digits_0_9 \
+         '0': \
+    case '1': \
+    case '2': \
+    case '3': \
+    case '4': \
+    case '5': \
+    case '6': \
+    case '7': \
+    case '8': \
+    case '9'
+
+    template <class Itr>
+    class CharItr
+    {
+        static_assert(std::is_same<typename std::iterator_traits<Itr>::value_type, char>::value, "char iterator expected");
+
+        Itr itr;
+        Itr end;
+        std::size_t count;
+        std::size_t limit;
+
+    public:
+        explicit CharItr(const Itr &begin_, const Itr &end_) :
+            itr(begin_),
+            end(end_),
+            count(0),
+            limit(std::numeric_limits<std::size_t>::max())
+        {
+        }
+
+        char operator *() const
+        {
+            if( itr != end )
+                return *itr;
+
+            return 0;
+        }
+
+        void operator ++()
+        {
+            if( itr != end )
+            {
+                ++itr;
+
+                if( ++count > limit )
+                    throw std::runtime_error("input too large");
+            }
+        }
+
+        // The length is not known up front, so the characters are counted
+        // and consuming more than maxBytes from here on throws.
+        void LimitInput(const std::size_t maxBytes)
+        {
+            const std::size_t unlimited = std::numeric_limits<std::size_t>::max();
+            limit = maxBytes < unlimited - count ? count + maxBytes : unlimited;
+        }
+
+        bool AtEnd() const
+        {
+            return itr == end;
+        }
+    };
+
+#if defined(TinyJson_X64) && defined(__GNUC__)
+#define TinyJson_TargetAvx2 __attribute__((target("avx2")))
+#else
+#define TinyJson_TargetAvx2
+#endif
+
+#ifdef TinyJson_X64
+    inline bool CpuHasAvx2()
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        if( !osxsave || (_xgetbv(0) & 6) != 6 )
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+#endif
+    }
+#endif
+
+    inline unsigned CountTrailingZeros64(const std::uint64_t value)
+    {
+#if defined(__GNUC__)
+        return static_cast<unsigned>(__builtin_ctzll(value));
+#elif defined(_M_X64)
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return index;
+#else
+        unsigned count = 0;
+        for( std::uint64_t bit = 1; (value & bit) == 0; bit <<= 1 )
+            ++count;
+
+        return count;
+#endif
+    }
+
+    // Finds the first '"', '\\' or control character of a string token,
+    // 16 or 32 bytes at a time where the CPU allows it. The MultiByte
+    // variants also stop on any byte of 0x80 or above, which lets a reader
+    // check UTF-8 only where a string has some.
+    class StringScanner
+    {
+        using FindFunc = const char *(*)(const char *, const char *);
+
+        template <bool MultiByte>
+        static bool IsSpecial(const char ch)
+        {
+            return ch == '"' || ch == '\\' || static_cast<unsigned char>(ch) < 0x20 || (MultiByte && static_cast<unsigned char>(ch) >= 0x80);
+        }
+
+#ifdef TinyJson_X64
+        template <bool MultiByte>
+        static unsigned FindInBlock(const char *const ptr)
+        {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+
+            const __m128i quote = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'));
+            const __m128i backslash = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'));
+
+            // A signed compare takes bytes of 0x80 and above along with controls.
+            const __m128i control = MultiByte ? _mm_cmplt_epi8(chunk, _mm_set1_epi8(0x20)) : _mm_cmpeq_epi8(_mm_min_epu8(chunk, _mm_set1_epi8(0x1F)), chunk);
+
+            return static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(quote, backslash), control)));
+        }
+
+        template <bool MultiByte>
+        static const char *FindSse2(const char *ptr, const char *const end)
+        {
+            for( ; end - ptr >= 16; ptr += 16 )
+            {
+                const unsigned mask = FindInBlock<MultiByte>(ptr);
+                if( mask != 0 )
+                    return ptr + CountTrailingZeros64(mask);
+            }
+
+            return FindScalar<MultiByte>(ptr, end);
+        }
+
+        template <bool MultiByte>
+        TinyJson_TargetAvx2 static const char *FindAvx2(const char *ptr, const char *const end)
+        {
+            for( ; end - ptr >= 32; ptr += 32 )
+            {
+                const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+
+                const __m256i quote = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"'));
+                const __m256i backslash = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'));
+                const __m256i control = MultiByte ? _mm256_cmpgt_epi8(_mm256_set1_epi8(0x20), chunk) : _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, _mm256_set1_epi8(0x1F)), chunk);
+
+                const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(quote, backslash), control)));
+                if( mask != 0 )
+                    return ptr + CountTrailingZeros64(mask);
+            }
+
+            return FindSse2<MultiByte>(ptr, end);
+        }
+#endif
+
+        template <bool MultiByte>
+        static FindFunc SelectFind()
+        {
+#ifdef TinyJson_X64
+            if( CpuHasAvx2() )
+                return &FindAvx2<MultiByte>;
+
+            return &FindSse2<MultiByte>;
+#else
+            return &FindScalar<MultiByte>;
+#endif
+        }
+
+        template <bool MultiByte>
+        static const char *FindSpecial(const char *const ptr, const char *const end)
+        {
+#ifdef TinyJson_X64
+            if( end - ptr < 16 )
+                return FindScalar<MultiByte>(ptr, end);
+
+            const unsigned mask = FindInBlock<MultiByte>(ptr);
+            if( mask != 0 )
+                return ptr + CountTrailingZeros64(mask);
+
+            static const FindFunc find = SelectFind<MultiByte>();
+            return find(ptr + 16, end);
+#else
+            return FindScalar<MultiByte>(ptr, end);
+#endif
+        }
+
+    public:
+        template <bool MultiByte = false>
+        static const char *FindScalar(const char *ptr, const char *const end)
+        {
+            while( ptr != end && !IsSpecial<MultiByte>(*ptr) )
+                ++ptr;
+
+            return ptr;
+        }
+
+        // Returns the first special character in [ptr, end), or end.
+        static const char *Find(const char *const ptr, const char *const end)
+        {
+            return FindSpecial<false>(ptr, end);
+        }
+
+        static const char *FindOrMultiByte(const char *const ptr, const char *const end)
+        {
+            return FindSpecial<true>(ptr, end);
+        }
+    };
+
+    // Finds the first byte that is not JSON whitespace, 16 or 32 bytes at a
+    // time where the CPU allows it. Indentation in pretty-printed input
+    // makes up most of its length.
+    class WhitespaceScanner
+    {
+        using SkipFunc = const char *(*)(const char *, const char *);
+
+        static bool IsWhitespace(const char ch)
+        {
+            return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t';
+        }
+
+#ifdef TinyJson_X64
+        static const char *SkipSse2(const char *ptr, const char *const end)
+        {
+            for( ; end - ptr >= 16; ptr += 16 )
+            {
+                const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+
+                const __m128i space = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')));
+                const __m128i other = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t')));
+
+                const unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(space, other))) & 0xFFFF;
+                if( mask != 0 )
+                    return ptr + CountTrailingZeros64(mask);
+            }
+
+            return SkipScalar(ptr, end);
+        }
+
+        TinyJson_TargetAvx2 static const char *SkipAvx2(const char *ptr, const char *const end)
+        {
+            for( ; end - ptr >= 32; ptr += 32 )
+            {
+                const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+
+                const __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n')));
+                const __m256i other = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t')));
+
+                const unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(space, other)));
+                if( mask != 0 )
+                    return ptr + CountTrailingZeros64(mask);
+            }
+
+            return SkipSse2(ptr, end);
+        }
+
+        static SkipFunc SelectSkip()
+        {
+            if( CpuHasAvx2() )
+                return &SkipAvx2;
+
+            return &SkipSse2;
+        }
+#endif
+
+    public:
+        static const char *SkipScalar(const char *ptr, const char *const end)
+        {
+            while( ptr != end && IsWhitespace(*ptr) )
+                ++ptr;
+
+            return ptr;
+        }
+
+        // Returns the first byte in [ptr, end) that is not whitespace, or
+        // end. No whitespace or a single space, as after a colon, are the
+        // common cases and are checked first.
+        static const char *Skip(const char *const ptr, const char *const end)
+        {
+            if( ptr == end || !IsWhitespace(*ptr) )
+                return ptr;
+
+            if( end - ptr == 1 || !IsWhitespace(ptr[1]) )
+                return ptr + 1;
+
+#ifdef TinyJson_X64
+            if( end - ptr < 18 )
+                return SkipScalar(ptr + 2, end);
+
+            static const SkipFunc skip = SelectSkip();
+            return skip(ptr + 2, end);
+#else
+            return SkipScalar(ptr + 2, end);
+#endif
+        }
+    };
+
+    // Checks string contents for well-formed UTF-8 (RFC 3629): no overlong
+    // forms, surrogates or code points above U+10FFFF. ASCII runs are
+    // skipped a block at a time; with AVX2, runs of multi-byte text are
+    // checked 32 bytes at a time as well.
+    class Utf8Validator
+    {
+        using ValidFunc = bool (*)(const char *, const char *);
+        using FindFunc = const char *(*)(const char *, const char *);
+
+        static bool IsContinuation(const unsigned char ch)
+        {
+            return (ch & 0xC0) == 0x80;
+        }
+
+        // Length of the well-formed sequence at pBytes, or 0.
+        static std::size_t SequenceLength(const unsigned char *const pBytes, const std::size_t available)
+        {
+            const unsigned char lead = pBytes[0];
+            if( lead < 0x80 )
+                return 1;
+
+            std::size_t length;
+            unsigned char low = 0x80;
+            unsigned char high = 0xBF;
+
+            if( lead >= 0xC2 && lead <= 0xDF )
+            {
+                length = 2;
+            }
+            else if( lead >= 0xE0 && lead <= 0xEF )
+            {
+                length = 3;
+                if( lead == 0xE0 )
+                    low = 0xA0;
+                else if( lead == 0xED )
+                    high = 0x9F;
+            }
+            else if( lead >= 0xF0 && lead <= 0xF4 )
+            {
+                length = 4;
+                if( lead == 0xF0 )
+                    low = 0x90;
+                else if( lead == 0xF4 )
+                    high = 0x8F;
+            }
+            else
+            {
+                return 0;
+            }
+
+            if( available < length || pBytes[1] < low || pBytes[1] > high )
+                return 0;
+
+            for( std::size_t i = 2; i < length; ++i )
+                if( !IsContinuation(pBytes[i]) )
+                    return 0;
+
+            return length;
+        }
+
+        static bool CheckScalar(const char *&ptr, const char *const limit, const char *const end)
+        {
+            while( ptr < limit )
+            {
+#ifdef TinyJson_X64
+                for( ; limit - ptr >= 16; ptr += 16 )
+                {
+                    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+
+                    const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(chunk));
+                    if( mask != 0 )
+                    {
+                        ptr += CountTrailingZeros64(mask);
+                        break;
+                    }
+                }
+
+                if( ptr == limit )
+                    break;
+#endif
+                const std::size_t length = SequenceLength(reinterpret_cast<const unsigned char *>(ptr), static_cast<std::size_t>(end - ptr));
+                if( length == 0 )
+                    return false;
+
+                ptr += length;
+            }
+
+            return true;
+        }
+
+        static bool IsValidScalar(const char *ptr, const char *const end)
+        {
+            return CheckScalar(ptr, end, end);
+        }
+
+        static const char *FindInStringScalar(const char *const ptr, const char *const end)
+        {
+            const char *const special = StringScanner::Find(ptr, end);
+            return IsValidScalar(ptr, special) ? special : nullptr;
+        }
+
+#ifdef TinyJson_X64
+        // Keiser and Lemire's lookup method. Each byte is looked up by its
+        // high nibble and by both nibbles of the byte before it; the AND of
+        // the three results flags every error but a missing or surplus
+        // continuation, which is found from the leads two and three back.
+        TinyJson_TargetAvx2 static __m256i FindErrors(const __m256i input, const __m256i previous)
+        {
+            static const unsigned char byte1High[16] =
+            {
+                0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x80, 0x80, 0x80, 0x80, 0x21, 0x01, 0x15, 0x49
+            };
+
+            static const unsigned char byte1Low[16] =
+            {
+                0xE7, 0xA3, 0x83, 0x83, 0x8B, 0xCB, 0xCB, 0xCB, 0xCB, 0xCB, 0xCB, 0xCB, 0xCB, 0xDB, 0xCB, 0xCB
+            };
+
+            static const unsigned char byte2High[16] =
+            {
+                0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0xE6, 0xAE, 0xBA, 0xBA, 0x01, 0x01, 0x01, 0x01
+            };
+
+            const __m256i nibble = _mm256_set1_epi8(0x0F);
+            const __m256i shifted = _mm256_permute2x128_si256(previous, input, 0x21);
+            const __m256i prev1 = _mm256_alignr_epi8(input, shifted, 15);
+            const __m256i prev2 = _mm256_alignr_epi8(input, shifted, 14);
+            const __m256i prev3 = _mm256_alignr_epi8(input, shifted, 13);
+
+            const __m256i lookup1High = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(byte1High))), _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+            const __m256i lookup1Low = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(byte1Low))), _mm256_and_si256(prev1, nibble));
+            const __m256i lookup2High = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(byte2High))), _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+            const __m256i special = _mm256_and_si256(_mm256_and_si256(lookup1High, lookup1Low), lookup2High);
+
+            // The top bit is set where a third or fourth byte is required,
+            // and the lookup sets it where two continuations meet.
+            const __m256i third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+            const __m256i fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+            const __m256i required = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+
+            return _mm256_xor_si256(required, special);
+        }
+
+        TinyJson_TargetAvx2 static bool IsValidAvx2(const char *ptr, const char *const end)
+        {
+            // Nonzero where a sequence is cut short by the end of a block.
+            const __m256i lastLeads = _mm256_setr_epi8(
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+
+            __m256i errors = _mm256_setzero_si256();
+            __m256i previous = _mm256_setzero_si256();
+            __m256i incomplete = _mm256_setzero_si256();
+            char tail[32];
+
+            for( bool last = false; !last; ptr += 32 )
+            {
+                __m256i input;
+                if( end - ptr >= 32 )
+                {
+                    input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+                }
+                else
+                {
+                    std::memset(tail, 0, sizeof(tail));
+                    std::memcpy(tail, ptr, static_cast<std::size_t>(end - ptr));
+                    input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(tail));
+                    last = true;
+                }
+
+                if( _mm256_movemask_epi8(input) == 0 )
+                {
+                    errors = _mm256_or_si256(errors, incomplete);
+                    incomplete = _mm256_setzero_si256();
+                }
+                else
+                {
+                    errors = _mm256_or_si256(errors, FindErrors(input, previous));
+                    incomplete = _mm256_subs_epu8(input, lastLeads);
+                }
+
+                previous = input;
+            }
+
+            errors = _mm256_or_si256(errors, incomplete);
+            return _mm256_testz_si256(errors, errors) != 0;
+        }
+
+        // The string scan and the check in one pass. The block holding the
+        // special character is cut off there, and the zeros that replace
+        // the rest end any sequence left open.
+        TinyJson_TargetAvx2 static const char *FindInStringAvx2(const char *ptr, const char *const end)
+        {
+            const __m256i lastLeads = _mm256_setr_epi8(
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+
+            const __m256i indices = _mm256_setr_epi8(
+                0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31);
+
+            __m256i errors = _mm256_setzero_si256();
+            __m256i previous = _mm256_setzero_si256();
+            __m256i incomplete = _mm256_setzero_si256();
+            char tail[32];
+
+            for( ;; ptr += 32 )
+            {
+                __m256i input;
+                if( end - ptr >= 32 )
+                {
+                    input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+                }
+                else
+                {
+                    // The zero padding stops the scan at end.
+                    std::memset(tail, 0, sizeof(tail));
+                    std::memcpy(tail, ptr, static_cast<std::size_t>(end - ptr));
+                    input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(tail));
+                }
+
+                const __m256i quote = _mm256_cmpeq_epi8(input, _mm256_set1_epi8('"'));
+                const __m256i backslash = _mm256_cmpeq_epi8(input, _mm256_set1_epi8('\\'));
+                const __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(input, _mm256_set1_epi8(0x1F)), input);
+
+                const unsigned special = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(quote, backslash), control)));
+                if( special != 0 )
+                {
+                    const unsigned index = CountTrailingZeros64(special);
+                    input = _mm256_and_si256(input, _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(index)), indices));
+                }
+
+                if( _mm256_movemask_epi8(input) == 0 )
+                {
+                    errors = _mm256_or_si256(errors, incomplete);
+                    incomplete = _mm256_setzero_si256();
+                }
+                else
+                {
+                    errors = _mm256_or_si256(errors, FindErrors(input, previous));
+                    incomplete = _mm256_subs_epu8(input, lastLeads);
+                }
+
+                if( special != 0 )
+                {
+                    if( !_mm256_testz_si256(errors, errors) )
+                        return nullptr;
+
+                    return ptr + CountTrailingZeros64(special);
+                }
+
+                previous = input;
+            }
+        }
+#endif
+
+        static ValidFunc SelectIsValid()
+        {
+#ifdef TinyJson_X64
+            if( CpuHasAvx2() )
+                return &IsValidAvx2;
+#endif
+            return &IsValidScalar;
+        }
+
+        static FindFunc SelectFindInString()
+        {
+#ifdef TinyJson_X64
+            if( CpuHasAvx2() )
+                return &FindInStringAvx2;
+#endif
+            return &FindInStringScalar;
+        }
+
+    public:
+        // True if [ptr, end) is a whole number of well-formed sequences.
+        static bool IsValid(const char *const ptr, const char *const end)
+        {
+            if( end - ptr < 32 )
+                return IsValidScalar(ptr, end);
+
+            static const ValidFunc isValid = SelectIsValid();
+            return isValid(ptr, end);
+        }
+
+        // Like StringScanner::Find, but also checks the bytes it passes over
+        // and returns nullptr if they are not well-formed. The caller knows
+        // the end of the string only once it is found, so ptr must start a
+        // sequence and the check stops at the first special character.
+        static const char *FindInString(const char *const ptr, const char *const end)
+        {
+            static const FindFunc find = SelectFindInString();
+            return find(ptr, end);
+        }
+
+        // Checks the sequences that start in [ptr, limit); the last one may
+        // run on up to end. On success ptr is left after it, on failure at
+        // the first byte of the malformed sequence.
+        static bool Check(const char *&ptr, const char *const limit, const char *const end)
+        {
+            if( ptr >= limit )
+                return true;
+
+            // The range is checked whole first; only a failure is walked
+            // sequence by sequence to find the byte to report.
+            const char *stop = limit;
+            while( stop != end && stop - limit < 3 && IsContinuation(static_cast<unsigned char>(*stop)) )
+                ++stop;
+
+            if( IsValid(ptr, stop) )
+            {
+                ptr = stop;
+                return true;
+            }
+
+            return CheckScalar(ptr, limit, end);
+        }
+    };
+
+    // Reads the four hexadecimal digits of a \u escape.
+    template <class Itr>
+    unsigned ReadHex4(Itr &itr)
+    {
+        unsigned code = 0;
+        for( int i = 0; i < 4; ++i, ++itr )
+        {
+            const char ch = *itr;
+
+            unsigned digit;
+            if( ch >= '0' && ch <= '9' )
+                digit = static_cast<unsigned>(ch - '0');
+            else if( (ch | 0x20) >= 'a' && (ch | 0x20) <= 'f' )
+                digit = static_cast<unsigned>((ch | 0x20) - 'a' + 10);
+            else
+                throw std::runtime_error("hexadecimal digit expected");
+
+            code = code << 4 | digit;
+        }
+
+        return code;
+    }
+
+    inline void AppendUtf8(String &out, const unsigned code)
+    {
+        if( code < 0x80 )
+        {
+            out.push_back(static_cast<char>(code));
+        }
+        else if( code < 0x800 )
+        {
+            out.push_back(static_cast<char>(0xC0 | code >> 6));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+        else if( code < 0x10000 )
+        {
+            out.push_back(static_cast<char>(0xE0 | code >> 12));
+            out.push_back(static_cast<char>(0x80 | (code >> 6 & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+        else
+        {
+            out.push_back(static_cast<char>(0xF0 | code >> 18));
+            out.push_back(static_cast<char>(0x80 | (code >> 12 & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code >> 6 & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+    }
+
+    // Decodes the escape sequence after a backslash into out as UTF-8 and
+    // leaves itr after it. A \u escape for a high surrogate must be followed
+    // by one for a low surrogate; the pair is one code point.
+    template <class Itr>
+    void DecodeEscape(Itr &itr, String &out)
+    {
+        const char ch = *itr;
+        switch( ch )
+        {
+            case '"':
+            case '\\':
+            case '/':
+                out.push_back(ch);
+                break;
+
+            case 'b': out.push_back('\b'); break;
+            case 'f': out.push_back('\f'); break;
+            case 'n': out.push_back('\n'); break;
+            case 'r': out.push_back('\r'); break;
+            case 't': out.push_back('\t'); break;
+
+            case 'u':
+            {
+                ++itr;
+                unsigned code = ReadHex4(itr);
+
+                if( code >= 0xD800 && code <= 0xDFFF )
+                {
+                    if( code >= 0xDC00 || *itr != '\\' )
+                        throw std::runtime_error("unpaired surrogate in \\u escape");
+
+                    ++itr;
+                    if( *itr != 'u' )
+                        throw std::runtime_error("unpaired surrogate in \\u escape");
+
+                    ++itr;
+                    const unsigned low = ReadHex4(itr);
+                    if( low < 0xDC00 || low > 0xDFFF )
+                        throw std::runtime_error("unpaired surrogate in \\u escape");
+
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+
+                AppendUtf8(out, code);
+                return;
+            }
+
+            default:
+                throw std::runtime_error("unrecognized character escape sequence: \\" + std::string(1, ch));
+        }
+
+        ++itr;
+    }
+
+    // Characters an escape takes after its backslash, judged from the ones
+    // seen so far; a high surrogate waits for its low half. Readers of
+    // chunked input use it to tell whether an escape is complete.
+    inline std::size_t EscapeLength(const char *const pEscape, const std::size_t available)
+    {
+        if( available == 0 || pEscape[0] != 'u' )
+            return 1;
+
+        if( available < 3 )
+            return 5;
+
+        const char second = static_cast<char>(pEscape[2] | 0x20);
+        const bool high = (pEscape[1] | 0x20) == 'd' && (second == '8' || second == '9' || second == 'a' || second == 'b');
+        return high ? 11 : 5;
+    }
+
+    // Reads a string token. The result views either the input buffer or
+    // scratch, which receives the decoded characters.
+    template <class Itr>
+    struct StringReader
+    {
+        static StringView Read(Itr &itr, String &scratch)
+        {
+            assert(*itr == '"');
+            ++itr;
+
+            scratch.clear();
+            bool multiByte = false;
+
+            for( char ch; (ch = *itr) != '"'; )
+            {
+                if( ch == '\\' )
+                {
+                    ++itr;
+                    DecodeEscape(itr, scratch);
+                    continue;
+                }
+
+                if( static_cast<unsigned char>(ch) >= 0x20 )
+                {
+                    multiByte |= static_cast<unsigned char>(ch) >= 0x80;
+                    scratch.push_back(ch);
+                }
+                else if( ch == 0 )
+                {
+                    throw std::runtime_error("'\"' expected");
+                }
+                else
+                {
+                    throw std::runtime_error("invalid control character in string");
+                }
+
+                ++itr;
+            }
+
+            // Decoded escapes are valid by construction, so the whole result
+            // can be checked.
+            if( multiByte && !Utf8Validator::IsValid(scratch.data(), scratch.data() + scratch.size()) )
+                throw std::runtime_error("invalid UTF-8");
+
+            ++itr;
+            return StringView(scratch);
+        }
+    };
+
+    // Stream over a contiguous buffer that is null-terminated at end_. The
+    // reader stops on the terminator, so no per-character end check is needed.
+    class CharPtr
+    {
+        const char *ptr;
+        const char *end;
+
+    public:
+        explicit CharPtr(const char *const begin_, const char *const end_) :
+            ptr(begin_),
+            end(end_)
+        {
+            assert(*end == 0);
+        }
+
+        char operator *() const
+        {
+            return *ptr;
+        }
+
+        void operator ++()
+        {
+            ++ptr;
+        }
+
+        const char *Ptr() const
+        {
+            return ptr;
+        }
+
+        const char *End() const
+        {
+            return end;
+        }
+
+        bool AtEnd() const
+        {
+            return ptr == end;
+        }
+
+        // The rest of the buffer is measured at once; it counts in full even
+        // if only its first value is read.
+        void LimitInput(const std::size_t maxBytes) const
+        {
+            if( static_cast<std::size_t>(end - ptr) > maxBytes )
+                throw std::runtime_error("input too large");
+        }
+
+        void SetPtr(const char *const ptr_)
+        {
+            assert(ptr_ <= end);
+            ptr = ptr_;
+        }
+    };
+
+    // Unescaped strings are returned as a view of the input; escaped ones
+    // are decoded into scratch with unescaped runs copied in bulk. The scan
+    // stops on bytes above ASCII, and only those runs are checked as UTF-8.
+    template <>
+    struct StringReader<CharPtr>
+    {
+        static StringView Read(CharPtr &itr, String &scratch)
+        {
+            assert(*itr == '"');
+
+            const char *ptr = itr.Ptr() + 1;
+            const char *const end = itr.End();
+            const char *run = ptr;
+            bool escaped = false;
+
+            scratch.clear();
+
+            for( ;; )
+            {
+                ptr = StringScanner::FindOrMultiByte(ptr, end);
+
+                const char ch = *ptr;
+                if( ch == '"' )
+                {
+                    itr.SetPtr(ptr + 1);
+
+                    if( !escaped )
+                        return StringView(run, static_cast<std::size_t>(ptr - run));
+
+                    scratch.append(run, ptr);
+                    return StringView(scratch);
+                }
+
+                if( ch == '\\' )
+                {
+                    scratch.append(run, ptr);
+
+                    CharPtr escape(ptr + 1, end);
+                    DecodeEscape(escape, scratch);
+
+                    ptr = escape.Ptr();
+                    run = ptr;
+                    escaped = true;
+                    continue;
+                }
+
+                // A sequence cannot contain ASCII, so the run up to the next
+                // special character must be whole sequences.
+                if( static_cast<unsigned char>(ch) >= 0x80 )
+                {
+                    ptr = Utf8Validator::FindInString(ptr, end);
+                    if( !ptr )
+                        throw std::runtime_error("invalid UTF-8");
+
+                    continue;
+                }
+
+                if( ptr == end )
+                    throw std::runtime_error("'\"' expected");
+
+                throw std::runtime_error("invalid control character in string");
+            }
+        }
+    };
+
+    // Stream over a mutable buffer, null-terminated at end_, for in-situ
+    // parsing: strings are decoded inside the buffer, which is overwritten.
+    class InSituCharPtr : public CharPtr
+    {
+    public:
+        explicit InSituCharPtr(char *const begin_, char *const end_) :
+            CharPtr(begin_, end_)
+        {
+        }
+
+        // Only ever constructed over mutable memory, so the cast is safe.
+        static char *Mutable(const char *const ptr)
+        {
+            return const_cast<char *>(ptr);
+        }
+    };
+
+    // Every string is returned as a view of the buffer. From the first
+    // escape on, decoded characters are written back behind the read
+    // position, which never falls behind since an escape only shrinks, and
+    // the string is null-terminated where it ends.
+    template <>
+    struct StringReader<InSituCharPtr>
+    {
+        static StringView Read(InSituCharPtr &itr, String &scratch)
+        {
+            assert(*itr == '"');
+
+            const char *ptr = itr.Ptr() + 1;
+            const char *const end = itr.End();
+            const char *run = ptr;
+            char *const pBegin = InSituCharPtr::Mutable(ptr);
+            char *pOut = nullptr;
+
+            for( ;; )
+            {
+                ptr = StringScanner::FindOrMultiByte(ptr, end);
+
+                const char ch = *ptr;
+                if( ch == '"' || ch == '\\' )
+                {
+                    if( pOut )
+                    {
+                        std::memmove(pOut, run, static_cast<std::size_t>(ptr - run));
+                        pOut += ptr - run;
+                    }
+                    else if( ch == '\\' )
+                    {
+                        pOut = InSituCharPtr::Mutable(ptr);
+                    }
+                }
+
+                if( ch == '"' )
+                {
+                    char *const pEnd = pOut ? pOut : InSituCharPtr::Mutable(ptr);
+                    *pEnd = 0;
+
+                    itr.SetPtr(ptr + 1);
+                    return StringView(pBegin, static_cast<std::size_t>(pEnd - pBegin));
+                }
+
+                if( ch == '\\' )
+                {
+                    // At most four bytes, so scratch never allocates here.
+                    scratch.clear();
+
+                    CharPtr escape(ptr + 1, end);
+                    DecodeEscape(escape, scratch);
+
+                    std::memcpy(pOut, scratch.data(), scratch.size());
+                    pOut += scratch.size();
+
+                    ptr = escape.Ptr();
+                    run = ptr;
+                    continue;
+                }
+
+                if( static_cast<unsigned char>(ch) >= 0x80 )
+                {
+                    ptr = Utf8Validator::FindInString(ptr, end);
+                    if( !ptr )
+                        throw std::runtime_error("invalid UTF-8");
+
+                    continue;
+                }
+
+                if( ptr == end )
+                    throw std::runtime_error("'\"' expected");
+
+                throw std::runtime_error("invalid control character in string");
+            }
+        }
+    };
+
+    inline int CountLeadingZeros64(const std::uint64_t value)
+    {
+#if defined(__GNUC__)
+        return __builtin_clzll(value);
+#elif defined(_M_X64)
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return 63 - static_cast<int>(index);
+#else
+        int count = 0;
+        for( std::uint64_t bit = std::uint64_t(1) << 63; (value & bit) == 0; bit >>= 1 )
+            ++count;
+
+        return count;
+#endif
+    }
+
+    inline void Multiply64(const std::uint64_t a, const std::uint64_t b, std::uint64_t &high, std::uint64_t &low)
+    {
+#if defined(__SIZEOF_INT128__)
+        __extension__ typedef unsigned __int128 UInt128;
+
+        const UInt128 product = static_cast<UInt128>(a) * b;
+        high = static_cast<std::uint64_t>(product >> 64);
+        low = static_cast<std::uint64_t>(product);
+#elif defined(_M_X64)
+        low = _umul128(a, b, &high);
+#else
+        const std::uint64_t aLow = a & 0xFFFFFFFF, aHigh = a >> 32;
+        const std::uint64_t bLow = b & 0xFFFFFFFF, bHigh = b >> 32;
+
+        const std::uint64_t lowLow = aLow * bLow;
+        const std::uint64_t highLow = aHigh * bLow + (lowLow >> 32);
+        const std::uint64_t lowHigh = aLow * bHigh + (highLow & 0xFFFFFFFF);
+
+        high = aHigh * bHigh + (highLow >> 32) + (lowHigh >> 32);
+        low = (lowHigh << 32) | (lowLow & 0xFFFFFFFF);
+#endif
+    }
+
+    // Significant digits and decimal exponent of a number token. Integral
+    // literals become exact 64-bit integers; everything else is converted to
+    // the correctly rounded double with Clinger's fast path, then the
+    // Eisel-Lemire algorithm, and strtod for the rare ambiguous case.
+    class DecimalNumber
+    {
+        static const int MaxMantissaDigits = 19;
+        static const std::size_t MaxDigits = 800;
+
+        bool negative;
+        bool integral;
+        std::uint64_t mantissa;
+        int mantissaDigits;
+        std::int64_t exponent;
+        bool truncatedNonZero;
+        std::string digits;
+
+        static const std::uint64_t *PowersOfFive()
+        {
+            // 128-bit approximations of 5^q for q in [-342, 308].
+            static const std::uint64_t table[] =
+            {
+                0xeef453d6923bd65a, 0x113faa2906a13b3f, 0x9558b4661b6565f8, 0x4ac7ca59a424c507,
+                0xbaaee17fa23ebf76, 0x5d79bcf00d2df649, 0xe95a99df8ace6f53, 0xf4d82c2c107973dc,
+                0x91d8a02bb6c10594, 0x79071b9b8a4be869, 0xb64ec836a47146f9, 0x9748e2826cdee284,
+                0xe3e27a444d8d98b7, 0xfd1b1b2308169b25, 0x8e6d8c6ab0787f72, 0xfe30f0f5e50e20f7,
+                0xb208ef855c969f4f, 0xbdbd2d335e51a935, 0xde8b2b66b3bc4723, 0xad2c788035e61382,
+                0x8b16fb203055ac76, 0x4c3bcb5021afcc31, 0xaddcb9e83c6b1793, 0xdf4abe242a1bbf3d,
+                0xd953e8624b85dd78, 0xd71d6dad34a2af0d, 0x87d4713d6f33aa6b, 0x8672648c40e5ad68,
+                0xa9c98d8ccb009506, 0x680efdaf511f18c2, 0xd43bf0effdc0ba48, 0x0212bd1b2566def2,
+                0x84a57695fe98746d, 0x014bb630f7604b57, 0xa5ced43b7e3e9188, 0x419ea3bd35385e2d,
+                0xcf42894a5dce35ea, 0x52064cac828675b9, 0x818995ce7aa0e1b2, 0x7343efebd1940993,
+                0xa1ebfb4219491a1f, 0x1014ebe6c5f90bf8, 0xca66fa129f9b60a6, 0xd41a26e077774ef6,
+                0xfd00b897478238d0, 0x8920b098955522b4, 0x9e20735e8cb16382, 0x55b46e5f5d5535b0,
+                0xc5a890362fddbc62, 0xeb2189f734aa831d, 0xf712b443bbd52b7b, 0xa5e9ec7501d523e4,
+                0x9a6bb0aa55653b2d, 0x47b233c92125366e, 0xc1069cd4eabe89f8, 0x999ec0bb696e840a,
+                0xf148440a256e2c76, 0xc00670ea43ca250d, 0x96cd2a865764dbca, 0x380406926a5e5728,
+                0xbc807527ed3e12bc, 0xc605083704f5ecf2, 0xeba09271e88d976b, 0xf7864a44c633682e,
+                0x93445b8731587ea3, 0x7ab3ee6afbe0211d, 0xb8157268fdae9e4c, 0x5960ea05bad82964,
+                0xe61acf033d1a45df, 0x6fb92487298e33bd, 0x8fd0c16206306bab, 0xa5d3b6d479f8e056,
+                0xb3c4f1ba87bc8696, 0x8f48a4899877186c, 0xe0b62e2929aba83c, 0x331acdabfe94de87,
+                0x8c71dcd9ba0b4925, 0x9ff0c08b7f1d0b14, 0xaf8e5410288e1b6f, 0x07ecf0ae5ee44dd9,
+                0xdb71e91432b1a24a, 0xc9e82cd9f69d6150, 0x892731ac9faf056e, 0xbe311c083a225cd2,
+                0xab70fe17c79ac6ca, 0x6dbd630a48aaf406, 0xd64d3d9db981787d, 0x092cbbccdad5b108,
+                0x85f0468293f0eb4e, 0x25bbf56008c58ea5, 0xa76c582338ed2621, 0xaf2af2b80af6f24e,
+                0xd1476e2c07286faa, 0x1af5af660db4aee1, 0x82cca4db847945ca, 0x50d98d9fc890ed4d,
+                0xa37fce126597973c, 0xe50ff107bab528a0, 0xcc5fc196fefd7d0c, 0x1e53ed49a96272c8,
+                0xff77b1fcbebcdc4f, 0x25e8e89c13bb0f7a, 0x9faacf3df73609b1, 0x77b191618c54e9ac,
+                0xc795830d75038c1d, 0xd59df5b9ef6a2417, 0xf97ae3d0d2446f25, 0x4b0573286b44ad1d,
+                0x9becce62836ac577, 0x4ee367f9430aec32, 0xc2e801fb244576d5, 0x229c41f793cda73f,
+                0xf3a20279ed56d48a, 0x6b43527578c1110f, 0x9845418c345644d6, 0x830a13896b78aaa9,
+                0xbe5691ef416bd60c, 0x23cc986bc656d553, 0xedec366b11c6cb8f, 0x2cbfbe86b7ec8aa8,
+                0x94b3a202eb1c3f39, 0x7bf7d71432f3d6a9, 0xb9e08a83a5e34f07, 0xdaf5ccd93fb0cc53,
+                0xe858ad248f5c22c9, 0xd1b3400f8f9cff68, 0x91376c36d99995be, 0x23100809b9c21fa1,
+                0xb58547448ffffb2d, 0xabd40a0c2832a78a, 0xe2e69915b3fff9f9, 0x16c90c8f323f516c,
+                0x8dd01fad907ffc3b, 0xae3da7d97f6792e3, 0xb1442798f49ffb4a, 0x99cd11cfdf41779c,
+                0xdd95317f31c7fa1d, 0x40405643d711d583, 0x8a7d3eef7f1cfc52, 0x482835ea666b2572,
+                0xad1c8eab5ee43b66, 0xda3243650005eecf, 0xd863b256369d4a40, 0x90bed43e40076a82,
+                0x873e4f75e2224e68, 0x5a7744a6e804a291, 0xa90de3535aaae202, 0x711515d0a205cb36,
+                0xd3515c2831559a83, 0x0d5a5b44ca873e03, 0x8412d9991ed58091, 0xe858790afe9486c2,
+                0xa5178fff668ae0b6, 0x626e974dbe39a872, 0xce5d73ff402d98e3, 0xfb0a3d212dc8128f,
+                0x80fa687f881c7f8e, 0x7ce66634bc9d0b99, 0xa139029f6a239f72, 0x1c1fffc1ebc44e80,
+                0xc987434744ac874e, 0xa327ffb266b56220, 0xfbe9141915d7a922, 0x4bf1ff9f0062baa8,
+                0x9d71ac8fada6c9b5, 0x6f773fc3603db4a9, 0xc4ce17b399107c22, 0xcb550fb4384d21d3,
+                0xf6019da07f549b2b, 0x7e2a53a146606a48, 0x99c102844f94e0fb, 0x2eda7444cbfc426d,
+                0xc0314325637a1939, 0xfa911155fefb5308, 0xf03d93eebc589f88, 0x793555ab7eba27ca,
+                0x96267c7535b763b5, 0x4bc1558b2f3458de, 0xbbb01b9283253ca2, 0x9eb1aaedfb016f16,
+                0xea9c227723ee8bcb, 0x465e15a979c1cadc, 0x92a1958a7675175f, 0x0bfacd89ec191ec9,
+                0xb749faed14125d36, 0xcef980ec671f667b, 0xe51c79a85916f484, 0x82b7e12780e7401a,
+                0x8f31cc0937ae58d2, 0xd1b2ecb8b0908810, 0xb2fe3f0b8599ef07, 0x861fa7e6dcb4aa15,
+                0xdfbdcece67006ac9, 0x67a791e093e1d49a, 0x8bd6a141006042bd, 0xe0c8bb2c5c6d24e0,
+                0xaecc49914078536d, 0x58fae9f773886e18, 0xda7f5bf590966848, 0xaf39a475506a899e,
+                0x888f99797a5e012d, 0x6d8406c952429603, 0xaab37fd7d8f58178, 0xc8e5087ba6d33b83,
+                0xd5605fcdcf32e1d6, 0xfb1e4a9a90880a64, 0x855c3be0a17fcd26, 0x5cf2eea09a55067f,
+                0xa6b34ad8c9dfc06f, 0xf42faa48c0ea481e, 0xd0601d8efc57b08b, 0xf13b94daf124da26,
+                0x823c12795db6ce57, 0x76c53d08d6b70858, 0xa2cb1717b52481ed, 0x54768c4b0c64ca6e,
+                0xcb7ddcdda26da268, 0xa9942f5dcf7dfd09, 0xfe5d54150b090b02, 0xd3f93b35435d7c4c,
+                0x9efa548d26e5a6e1, 0xc47bc5014a1a6daf, 0xc6b8e9b0709f109a, 0x359ab6419ca1091b,
+                0xf867241c8cc6d4c0, 0xc30163d203c94b62, 0x9b407691d7fc44f8, 0x79e0de63425dcf1d,
+                0xc21094364dfb5636, 0x985915fc12f542e4, 0xf294b943e17a2bc4, 0x3e6f5b7b17b2939d,
+                0x979cf3ca6cec5b5a, 0xa705992ceecf9c42, 0xbd8430bd08277231, 0x50c6ff782a838353,
+                0xece53cec4a314ebd, 0xa4f8bf5635246428, 0x940f4613ae5ed136, 0x871b7795e136be99,
+                0xb913179899f68584, 0x28e2557b59846e3f, 0xe757dd7ec07426e5, 0x331aeada2fe589cf,
+                0x9096ea6f3848984f, 0x3ff0d2c85def7621, 0xb4bca50b065abe63, 0x0fed077a756b53a9,
+                0xe1ebce4dc7f16dfb, 0xd3e8495912c62894, 0x8d3360f09cf6e4bd, 0x64712dd7abbbd95c,
+                0xb080392cc4349dec, 0xbd8d794d96aacfb3, 0xdca04777f541c567, 0xecf0d7a0fc5583a0,
+                0x89e42caaf9491b60, 0xf41686c49db57244, 0xac5d37d5b79b6239, 0x311c2875c522ced5,
+                0xd77485cb25823ac7, 0x7d633293366b828b, 0x86a8d39ef77164bc, 0xae5dff9c02033197,
+                0xa8530886b54dbdeb, 0xd9f57f830283fdfc, 0xd267caa862a12d66, 0xd072df63c324fd7b,
+                0x8380dea93da4bc60, 0x4247cb9e59f71e6d, 0xa46116538d0deb78, 0x52d9be85f074e608,
+                0xcd795be870516656, 0x67902e276c921f8b, 0x806bd9714632dff6, 0x00ba1cd8a3db53b6,
+                0xa086cfcd97bf97f3, 0x80e8a40eccd228a4, 0xc8a883c0fdaf7df0, 0x6122cd128006b2cd,
+                0xfad2a4b13d1b5d6c, 0x796b805720085f81, 0x9cc3a6eec6311a63, 0xcbe3303674053bb0,
+                0xc3f490aa77bd60fc, 0xbedbfc4411068a9c, 0xf4f1b4d515acb93b, 0xee92fb5515482d44,
+                0x991711052d8bf3c5, 0x751bdd152d4d1c4a, 0xbf5cd54678eef0b6, 0xd262d45a78a0635d,
+                0xef340a98172aace4, 0x86fb897116c87c34, 0x9580869f0e7aac0e, 0xd45d35e6ae3d4da0,
+                0xbae0a846d2195712, 0x8974836059cca109, 0xe998d258869facd7, 0x2bd1a438703fc94b,
+                0x91ff83775423cc06, 0x7b6306a34627ddcf, 0xb67f6455292cbf08, 0x1a3bc84c17b1d542,
+                0xe41f3d6a7377eeca, 0x20caba5f1d9e4a93, 0x8e938662882af53e, 0x547eb47b7282ee9c,
+                0xb23867fb2a35b28d, 0xe99e619a4f23aa43, 0xdec681f9f4c31f31, 0x6405fa00e2ec94d4,
+                0x8b3c113c38f9f37e, 0xde83bc408dd3dd04, 0xae0b158b4738705e, 0x9624ab50b148d445,
+                0xd98ddaee19068c76, 0x3badd624dd9b0957, 0x87f8a8d4cfa417c9, 0xe54ca5d70a80e5d6,
+                0xa9f6d30a038d1dbc, 0x5e9fcf4ccd211f4c, 0xd47487cc8470652b, 0x7647c3200069671f,
+                0x84c8d4dfd2c63f3b, 0x29ecd9f40041e073, 0xa5fb0a17c777cf09, 0xf468107100525890,
+                0xcf79cc9db955c2cc, 0x7182148d4066eeb4, 0x81ac1fe293d599bf, 0xc6f14cd848405530,
+                0xa21727db38cb002f, 0xb8ada00e5a506a7c, 0xca9cf1d206fdc03b, 0xa6d90811f0e4851c,
+                0xfd442e4688bd304a, 0x908f4a166d1da663, 0x9e4a9cec15763e2e, 0x9a598e4e043287fe,
+                0xc5dd44271ad3cdba, 0x40eff1e1853f29fd, 0xf7549530e188c128, 0xd12bee59e68ef47c,
+                0x9a94dd3e8cf578b9, 0x82bb74f8301958ce, 0xc13a148e3032d6e7, 0xe36a52363c1faf01,
+                0xf18899b1bc3f8ca1, 0xdc44e6c3cb279ac1, 0x96f5600f15a7b7e5, 0x29ab103a5ef8c0b9,
+                0xbcb2b812db11a5de, 0x7415d448f6b6f0e7, 0xebdf661791d60f56, 0x111b495b3464ad21,
+                0x936b9fcebb25c995, 0xcab10dd900beec34, 0xb84687c269ef3bfb, 0x3d5d514f40eea742,
+                0xe65829b3046b0afa, 0x0cb4a5a3112a5112, 0x8ff71a0fe2c2e6dc, 0x47f0e785eaba72ab,
+                0xb3f4e093db73a093, 0x59ed216765690f56, 0xe0f218b8d25088b8, 0x306869c13ec3532c,
+                0x8c974f7383725573, 0x1e414218c73a13fb, 0xafbd2350644eeacf, 0xe5d1929ef90898fa,
+                0xdbac6c247d62a583, 0xdf45f746b74abf39, 0x894bc396ce5da772, 0x6b8bba8c328eb783,
+                0xab9eb47c81f5114f, 0x066ea92f3f326564, 0xd686619ba27255a2, 0xc80a537b0efefebd,
+                0x8613fd0145877585, 0xbd06742ce95f5f36, 0xa798fc4196e952e7, 0x2c48113823b73704,
+                0xd17f3b51fca3a7a0, 0xf75a15862ca504c5, 0x82ef85133de648c4, 0x9a984d73dbe722fb,
+                0xa3ab66580d5fdaf5, 0xc13e60d0d2e0ebba, 0xcc963fee10b7d1b3, 0x318df905079926a8,
+                0xffbbcfe994e5c61f, 0xfdf17746497f7052, 0x9fd561f1fd0f9bd3, 0xfeb6ea8bedefa633,
+                0xc7caba6e7c5382c8, 0xfe64a52ee96b8fc0, 0xf9bd690a1b68637b, 0x3dfdce7aa3c673b0,
+                0x9c1661a651213e2d, 0x06bea10ca65c084e, 0xc31bfa0fe5698db8, 0x486e494fcff30a62,
+                0xf3e2f893dec3f126, 0x5a89dba3c3efccfa, 0x986ddb5c6b3a76b7, 0xf89629465a75e01c,
+                0xbe89523386091465, 0xf6bbb397f1135823, 0xee2ba6c0678b597f, 0x746aa07ded582e2c,
+                0x94db483840b717ef, 0xa8c2a44eb4571cdc, 0xba121a4650e4ddeb, 0x92f34d62616ce413,
+                0xe896a0d7e51e1566, 0x77b020baf9c81d17, 0x915e2486ef32cd60, 0x0ace1474dc1d122e,
+                0xb5b5ada8aaff80b8, 0x0d819992132456ba, 0xe3231912d5bf60e6, 0x10e1fff697ed6c69,
+                0x8df5efabc5979c8f, 0xca8d3ffa1ef463c1, 0xb1736b96b6fd83b3, 0xbd308ff8a6b17cb2,
+                0xddd0467c64bce4a0, 0xac7cb3f6d05ddbde, 0x8aa22c0dbef60ee4, 0x6bcdf07a423aa96b,
+                0xad4ab7112eb3929d, 0x86c16c98d2c953c6, 0xd89d64d57a607744, 0xe871c7bf077ba8b7,
+                0x87625f056c7c4a8b, 0x11471cd764ad4972, 0xa93af6c6c79b5d2d, 0xd598e40d3dd89bcf,
+                0xd389b47879823479, 0x4aff1d108d4ec2c3, 0x843610cb4bf160cb, 0xcedf722a585139ba,
+                0xa54394fe1eedb8fe, 0xc2974eb4ee658828, 0xce947a3da6a9273e, 0x733d226229feea32,
+                0x811ccc668829b887, 0x0806357d5a3f525f, 0xa163ff802a3426a8, 0xca07c2dcb0cf26f7,
+                0xc9bcff6034c13052, 0xfc89b393dd02f0b5, 0xfc2c3f3841f17c67, 0xbbac2078d443ace2,
+                0x9d9ba7832936edc0, 0xd54b944b84aa4c0d, 0xc5029163f384a931, 0x0a9e795e65d4df11,
+                0xf64335bcf065d37d, 0x4d4617b5ff4a16d5, 0x99ea0196163fa42e, 0x504bced1bf8e4e45,
+                0xc06481fb9bcf8d39, 0xe45ec2862f71e1d6, 0xf07da27a82c37088, 0x5d767327bb4e5a4c,
+                0x964e858c91ba2655, 0x3a6a07f8d510f86f, 0xbbe226efb628afea, 0x890489f70a55368b,
+                0xeadab0aba3b2dbe5, 0x2b45ac74ccea842e, 0x92c8ae6b464fc96f, 0x3b0b8bc90012929d,
+                0xb77ada0617e3bbcb, 0x09ce6ebb40173744, 0xe55990879ddcaabd, 0xcc420a6a101d0515,
+                0x8f57fa54c2a9eab6, 0x9fa946824a12232d, 0xb32df8e9f3546564, 0x47939822dc96abf9,
+                0xdff9772470297ebd, 0x59787e2b93bc56f7, 0x8bfbea76c619ef36, 0x57eb4edb3c55b65a,
+                0xaefae51477a06b03, 0xede622920b6b23f1, 0xdab99e59958885c4, 0xe95fab368e45eced,
+                0x88b402f7fd75539b, 0x11dbcb0218ebb414, 0xaae103b5fcd2a881, 0xd652bdc29f26a119,
+                0xd59944a37c0752a2, 0x4be76d3346f0495f, 0x857fcae62d8493a5, 0x6f70a4400c562ddb,
+                0xa6dfbd9fb8e5b88e, 0xcb4ccd500f6bb952, 0xd097ad07a71f26b2, 0x7e2000a41346a7a7,
+                0x825ecc24c873782f, 0x8ed400668c0c28c8, 0xa2f67f2dfa90563b, 0x728900802f0f32fa,
+                0xcbb41ef979346bca, 0x4f2b40a03ad2ffb9, 0xfea126b7d78186bc, 0xe2f610c84987bfa8,
+                0x9f24b832e6b0f436, 0x0dd9ca7d2df4d7c9, 0xc6ede63fa05d3143, 0x91503d1c79720dbb,
+                0xf8a95fcf88747d94, 0x75a44c6397ce912a, 0x9b69dbe1b548ce7c, 0xc986afbe3ee11aba,
+                0xc24452da229b021b, 0xfbe85badce996168, 0xf2d56790ab41c2a2, 0xfae27299423fb9c3,
+                0x97c560ba6b0919a5, 0xdccd879fc967d41a, 0xbdb6b8e905cb600f, 0x5400e987bbc1c920,
+                0xed246723473e3813, 0x290123e9aab23b68, 0x9436c0760c86e30b, 0xf9a0b6720aaf6521,
+                0xb94470938fa89bce, 0xf808e40e8d5b3e69, 0xe7958cb87392c2c2, 0xb60b1d1230b20e04,
+                0x90bd77f3483bb9b9, 0xb1c6f22b5e6f48c2, 0xb4ecd5f01a4aa828, 0x1e38aeb6360b1af3,
+                0xe2280b6c20dd5232, 0x25c6da63c38de1b0, 0x8d590723948a535f, 0x579c487e5a38ad0e,
+                0xb0af48ec79ace837, 0x2d835a9df0c6d851, 0xdcdb1b2798182244, 0xf8e431456cf88e65,
+                0x8a08f0f8bf0f156b, 0x1b8e9ecb641b58ff, 0xac8b2d36eed2dac5, 0xe272467e3d222f3f,
+                0xd7adf884aa879177, 0x5b0ed81dcc6abb0f, 0x86ccbb52ea94baea, 0x98e947129fc2b4e9,
+                0xa87fea27a539e9a5, 0x3f2398d747b36224, 0xd29fe4b18e88640e, 0x8eec7f0d19a03aad,
+                0x83a3eeeef9153e89, 0x1953cf68300424ac, 0xa48ceaaab75a8e2b, 0x5fa8c3423c052dd7,
+                0xcdb02555653131b6, 0x3792f412cb06794d, 0x808e17555f3ebf11, 0xe2bbd88bbee40bd0,
+                0xa0b19d2ab70e6ed6, 0x5b6aceaeae9d0ec4, 0xc8de047564d20a8b, 0xf245825a5a445275,
+                0xfb158592be068d2e, 0xeed6e2f0f0d56712, 0x9ced737bb6c4183d, 0x55464dd69685606b,
+                0xc428d05aa4751e4c, 0xaa97e14c3c26b886, 0xf53304714d9265df, 0xd53dd99f4b3066a8,
+                0x993fe2c6d07b7fab, 0xe546a8038efe4029, 0xbf8fdb78849a5f96, 0xde98520472bdd033,
+                0xef73d256a5c0f77c, 0x963e66858f6d4440, 0x95a8637627989aad, 0xdde7001379a44aa8,
+                0xbb127c53b17ec159, 0x5560c018580d5d52, 0xe9d71b689dde71af, 0xaab8f01e6e10b4a6,
+                0x9226712162ab070d, 0xcab3961304ca70e8, 0xb6b00d69bb55c8d1, 0x3d607b97c5fd0d22,
+                0xe45c10c42a2b3b05, 0x8cb89a7db77c506a, 0x8eb98a7a9a5b04e3, 0x77f3608e92adb242,
+                0xb267ed1940f1c61c, 0x55f038b237591ed3, 0xdf01e85f912e37a3, 0x6b6c46dec52f6688,
+                0x8b61313bbabce2c6, 0x2323ac4b3b3da015, 0xae397d8aa96c1b77, 0xabec975e0a0d081a,
+                0xd9c7dced53c72255, 0x96e7bd358c904a21, 0x881cea14545c7575, 0x7e50d64177da2e54,
+                0xaa242499697392d2, 0xdde50bd1d5d0b9e9, 0xd4ad2dbfc3d07787, 0x955e4ec64b44e864,
+                0x84ec3c97da624ab4, 0xbd5af13bef0b113e, 0xa6274bbdd0fadd61, 0xecb1ad8aeacdd58e,
+                0xcfb11ead453994ba, 0x67de18eda5814af2, 0x81ceb32c4b43fcf4, 0x80eacf948770ced7,
+                0xa2425ff75e14fc31, 0xa1258379a94d028d, 0xcad2f7f5359a3b3e, 0x096ee45813a04330,
+                0xfd87b5f28300ca0d, 0x8bca9d6e188853fc, 0x9e74d1b791e07e48, 0x775ea264cf55347e,
+                0xc612062576589dda, 0x95364afe032a819e, 0xf79687aed3eec551, 0x3a83ddbd83f52205,
+                0x9abe14cd44753b52, 0xc4926a9672793543, 0xc16d9a0095928a27, 0x75b7053c0f178294,
+                0xf1c90080baf72cb1, 0x5324c68b12dd6339, 0x971da05074da7bee, 0xd3f6fc16ebca5e04,
+                0xbce5086492111aea, 0x88f4bb1ca6bcf585, 0xec1e4a7db69561a5, 0x2b31e9e3d06c32e6,
+                0x9392ee8e921d5d07, 0x3aff322e62439fd0, 0xb877aa3236a4b449, 0x09befeb9fad487c3,
+                0xe69594bec44de15b, 0x4c2ebe687989a9b4, 0x901d7cf73ab0acd9, 0x0f9d37014bf60a11,
+                0xb424dc35095cd80f, 0x538484c19ef38c95, 0xe12e13424bb40e13, 0x2865a5f206b06fba,
+                0x8cbccc096f5088cb, 0xf93f87b7442e45d4, 0xafebff0bcb24aafe, 0xf78f69a51539d749,
+                0xdbe6fecebdedd5be, 0xb573440e5a884d1c, 0x89705f4136b4a597, 0x31680a88f8953031,
+                0xabcc77118461cefc, 0xfdc20d2b36ba7c3e, 0xd6bf94d5e57a42bc, 0x3d32907604691b4d,
+                0x8637bd05af6c69b5, 0xa63f9a49c2c1b110, 0xa7c5ac471b478423, 0x0fcf80dc33721d54,
+                0xd1b71758e219652b, 0xd3c36113404ea4a9, 0x83126e978d4fdf3b, 0x645a1cac083126ea,
+                0xa3d70a3d70a3d70a, 0x3d70a3d70a3d70a4, 0xcccccccccccccccc, 0xcccccccccccccccd,
+                0x8000000000000000, 0x0000000000000000, 0xa000000000000000, 0x0000000000000000,
+                0xc800000000000000, 0x0000000000000000, 0xfa00000000000000, 0x0000000000000000,
+                0x9c40000000000000, 0x0000000000000000, 0xc350000000000000, 0x0000000000000000,
+                0xf424000000000000, 0x0000000000000000, 0x9896800000000000, 0x0000000000000000,
+                0xbebc200000000000, 0x0000000000000000, 0xee6b280000000000, 0x0000000000000000,
+                0x9502f90000000000, 0x0000000000000000, 0xba43b74000000000, 0x0000000000000000,
+                0xe8d4a51000000000, 0x0000000000000000, 0x9184e72a00000000, 0x0000000000000000,
+                0xb5e620f480000000, 0x0000000000000000, 0xe35fa931a0000000, 0x0000000000000000,
+                0x8e1bc9bf04000000, 0x0000000000000000, 0xb1a2bc2ec5000000, 0x0000000000000000,
+                0xde0b6b3a76400000, 0x0000000000000000, 0x8ac7230489e80000, 0x0000000000000000,
+                0xad78ebc5ac620000, 0x0000000000000000, 0xd8d726b7177a8000, 0x0000000000000000,
+                0x878678326eac9000, 0x0000000000000000, 0xa968163f0a57b400, 0x0000000000000000,
+                0xd3c21bcecceda100, 0x0000000000000000, 0x84595161401484a0, 0x0000000000000000,
+                0xa56fa5b99019a5c8, 0x0000000000000000, 0xcecb8f27f4200f3a, 0x0000000000000000,
+                0x813f3978f8940984, 0x4000000000000000, 0xa18f07d736b90be5, 0x5000000000000000,
+                0xc9f2c9cd04674ede, 0xa400000000000000, 0xfc6f7c4045812296, 0x4d00000000000000,
+                0x9dc5ada82b70b59d, 0xf020000000000000, 0xc5371912364ce305, 0x6c28000000000000,
+                0xf684df56c3e01bc6, 0xc732000000000000, 0x9a130b963a6c115c, 0x3c7f400000000000,
+                0xc097ce7bc90715b3, 0x4b9f100000000000, 0xf0bdc21abb48db20, 0x1e86d40000000000,
+                0x96769950b50d88f4, 0x1314448000000000, 0xbc143fa4e250eb31, 0x17d955a000000000,
+                0xeb194f8e1ae525fd, 0x5dcfab0800000000, 0x92efd1b8d0cf37be, 0x5aa1cae500000000,
+                0xb7abc627050305ad, 0xf14a3d9e40000000, 0xe596b7b0c643c719, 0x6d9ccd05d0000000,
+                0x8f7e32ce7bea5c6f, 0xe4820023a2000000, 0xb35dbf821ae4f38b, 0xdda2802c8a800000,
+                0xe0352f62a19e306e, 0xd50b2037ad200000, 0x8c213d9da502de45, 0x4526f422cc340000,
+                0xaf298d050e4395d6, 0x9670b12b7f410000, 0xdaf3f04651d47b4c, 0x3c0cdd765f114000,
+                0x88d8762bf324cd0f, 0xa5880a69fb6ac800, 0xab0e93b6efee0053, 0x8eea0d047a457a00,
+                0xd5d238a4abe98068, 0x72a4904598d6d880, 0x85a36366eb71f041, 0x47a6da2b7f864750,
+                0xa70c3c40a64e6c51, 0x999090b65f67d924, 0xd0cf4b50cfe20765, 0xfff4b4e3f741cf6d,
+                0x82818f1281ed449f, 0xbff8f10e7a8921a4, 0xa321f2d7226895c7, 0xaff72d52192b6a0d,
+                0xcbea6f8ceb02bb39, 0x9bf4f8a69f764490, 0xfee50b7025c36a08, 0x02f236d04753d5b4,
+                0x9f4f2726179a2245, 0x01d762422c946590, 0xc722f0ef9d80aad6, 0x424d3ad2b7b97ef5,
+                0xf8ebad2b84e0d58b, 0xd2e0898765a7deb2, 0x9b934c3b330c8577, 0x63cc55f49f88eb2f,
+                0xc2781f49ffcfa6d5, 0x3cbf6b71c76b25fb, 0xf316271c7fc3908a, 0x8bef464e3945ef7a,
+                0x97edd871cfda3a56, 0x97758bf0e3cbb5ac, 0xbde94e8e43d0c8ec, 0x3d52eeed1cbea317,
+                0xed63a231d4c4fb27, 0x4ca7aaa863ee4bdd, 0x945e455f24fb1cf8, 0x8fe8caa93e74ef6a,
+                0xb975d6b6ee39e436, 0xb3e2fd538e122b44, 0xe7d34c64a9c85d44, 0x60dbbca87196b616,
+                0x90e40fbeea1d3a4a, 0xbc8955e946fe31cd, 0xb51d13aea4a488dd, 0x6babab6398bdbe41,
+                0xe264589a4dcdab14, 0xc696963c7eed2dd1, 0x8d7eb76070a08aec, 0xfc1e1de5cf543ca2,
+                0xb0de65388cc8ada8, 0x3b25a55f43294bcb, 0xdd15fe86affad912, 0x49ef0eb713f39ebe,
+                0x8a2dbf142dfcc7ab, 0x6e3569326c784337, 0xacb92ed9397bf996, 0x49c2c37f07965404,
+                0xd7e77a8f87daf7fb, 0xdc33745ec97be906, 0x86f0ac99b4e8dafd, 0x69a028bb3ded71a3,
+                0xa8acd7c0222311bc, 0xc40832ea0d68ce0c, 0xd2d80db02aabd62b, 0xf50a3fa490c30190,
+                0x83c7088e1aab65db, 0x792667c6da79e0fa, 0xa4b8cab1a1563f52, 0x577001b891185938,
+                0xcde6fd5e09abcf26, 0xed4c0226b55e6f86, 0x80b05e5ac60b6178, 0x544f8158315b05b4,
+                0xa0dc75f1778e39d6, 0x696361ae3db1c721, 0xc913936dd571c84c, 0x03bc3a19cd1e38e9,
+                0xfb5878494ace3a5f, 0x04ab48a04065c723, 0x9d174b2dcec0e47b, 0x62eb0d64283f9c76,
+                0xc45d1df942711d9a, 0x3ba5d0bd324f8394, 0xf5746577930d6500, 0xca8f44ec7ee36479,
+                0x9968bf6abbe85f20, 0x7e998b13cf4e1ecb, 0xbfc2ef456ae276e8, 0x9e3fedd8c321a67e,
+                0xefb3ab16c59b14a2, 0xc5cfe94ef3ea101e, 0x95d04aee3b80ece5, 0xbba1f1d158724a12,
+                0xbb445da9ca61281f, 0x2a8a6e45ae8edc97, 0xea1575143cf97226, 0xf52d09d71a3293bd,
+                0x924d692ca61be758, 0x593c2626705f9c56, 0xb6e0c377cfa2e12e, 0x6f8b2fb00c77836c,
+                0xe498f455c38b997a, 0x0b6dfb9c0f956447, 0x8edf98b59a373fec, 0x4724bd4189bd5eac,
+                0xb2977ee300c50fe7, 0x58edec91ec2cb657, 0xdf3d5e9bc0f653e1, 0x2f2967b66737e3ed,
+                0x8b865b215899f46c, 0xbd79e0d20082ee74, 0xae67f1e9aec07187, 0xecd8590680a3aa11,
+                0xda01ee641a708de9, 0xe80e6f4820cc9495, 0x884134fe908658b2, 0x3109058d147fdcdd,
+                0xaa51823e34a7eede, 0xbd4b46f0599fd415, 0xd4e5e2cdc1d1ea96, 0x6c9e18ac7007c91a,
+                0x850fadc09923329e, 0x03e2cf6bc604ddb0, 0xa6539930bf6bff45, 0x84db8346b786151c,
+                0xcfe87f7cef46ff16, 0xe612641865679a63, 0x81f14fae158c5f6e, 0x4fcb7e8f3f60c07e,
+                0xa26da3999aef7749, 0xe3be5e330f38f09d, 0xcb090c8001ab551c, 0x5cadf5bfd3072cc5,
+                0xfdcb4fa002162a63, 0x73d9732fc7c8f7f6, 0x9e9f11c4014dda7e, 0x2867e7fddcdd9afa,
+                0xc646d63501a1511d, 0xb281e1fd541501b8, 0xf7d88bc24209a565, 0x1f225a7ca91a4226,
+                0x9ae757596946075f, 0x3375788de9b06958, 0xc1a12d2fc3978937, 0x0052d6b1641c83ae,
+                0xf209787bb47d6b84, 0xc0678c5dbd23a49a, 0x9745eb4d50ce6332, 0xf840b7ba963646e0,
+                0xbd176620a501fbff, 0xb650e5a93bc3d898, 0xec5d3fa8ce427aff, 0xa3e51f138ab4cebe,
+                0x93ba47c980e98cdf, 0xc66f336c36b10137, 0xb8a8d9bbe123f017, 0xb80b0047445d4184,
+                0xe6d3102ad96cec1d, 0xa60dc059157491e5, 0x9043ea1ac7e41392, 0x87c89837ad68db2f,
+                0xb454e4a179dd1877, 0x29babe4598c311fb, 0xe16a1dc9d8545e94, 0xf4296dd6fef3d67a,
+                0x8ce2529e2734bb1d, 0x1899e4a65f58660c, 0xb01ae745b101e9e4, 0x5ec05dcff72e7f8f,
+                0xdc21a1171d42645d, 0x76707543f4fa1f73, 0x899504ae72497eba, 0x6a06494a791c53a8,
+                0xabfa45da0edbde69, 0x0487db9d17636892, 0xd6f8d7509292d603, 0x45a9d2845d3c42b6,
+                0x865b86925b9bc5c2, 0x0b8a2392ba45a9b2, 0xa7f26836f282b732, 0x8e6cac7768d7141e,
+                0xd1ef0244af2364ff, 0x3207d795430cd926, 0x8335616aed761f1f, 0x7f44e6bd49e807b8,
+                0xa402b9c5a8d3a6e7, 0x5f16206c9c6209a6, 0xcd036837130890a1, 0x36dba887c37a8c0f,
+                0x802221226be55a64, 0xc2494954da2c9789, 0xa02aa96b06deb0fd, 0xf2db9baa10b7bd6c,
+                0xc83553c5c8965d3d, 0x6f92829494e5acc7, 0xfa42a8b73abbf48c, 0xcb772339ba1f17f9,
+                0x9c69a97284b578d7, 0xff2a760414536efb, 0xc38413cf25e2d70d, 0xfef5138519684aba,
+                0xf46518c2ef5b8cd1, 0x7eb258665fc25d69, 0x98bf2f79d5993802, 0xef2f773ffbd97a61,
+                0xbeeefb584aff8603, 0xaafb550ffacfd8fa, 0xeeaaba2e5dbf6784, 0x95ba2a53f983cf38,
+                0x952ab45cfa97a0b2, 0xdd945a747bf26183, 0xba756174393d88df, 0x94f971119aeef9e4,
+                0xe912b9d1478ceb17, 0x7a37cd5601aab85d, 0x91abb422ccb812ee, 0xac62e055c10ab33a,
+                0xb616a12b7fe617aa, 0x577b986b314d6009, 0xe39c49765fdf9d94, 0xed5a7e85fda0b80b,
+                0x8e41ade9fbebc27d, 0x14588f13be847307, 0xb1d219647ae6b31c, 0x596eb2d8ae258fc8,
+                0xde469fbd99a05fe3, 0x6fca5f8ed9aef3bb, 0x8aec23d680043bee, 0x25de7bb9480d5854,
+                0xada72ccc20054ae9, 0xaf561aa79a10ae6a, 0xd910f7ff28069da4, 0x1b2ba1518094da04,
+                0x87aa9aff79042286, 0x90fb44d2f05d0842, 0xa99541bf57452b28, 0x353a1607ac744a53,
+                0xd3fa922f2d1675f2, 0x42889b8997915ce8, 0x847c9b5d7c2e09b7, 0x69956135febada11,
+                0xa59bc234db398c25, 0x43fab9837e699095, 0xcf02b2c21207ef2e, 0x94f967e45e03f4bb,
+                0x8161afb94b44f57d, 0x1d1be0eebac278f5, 0xa1ba1ba79e1632dc, 0x6462d92a69731732,
+                0xca28a291859bbf93, 0x7d7b8f7503cfdcfe, 0xfcb2cb35e702af78, 0x5cda735244c3d43e,
+                0x9defbf01b061adab, 0x3a0888136afa64a7, 0xc56baec21c7a1916, 0x088aaa1845b8fdd0,
+                0xf6c69a72a3989f5b, 0x8aad549e57273d45, 0x9a3c2087a63f6399, 0x36ac54e2f678864b,
+                0xc0cb28a98fcf3c7f, 0x84576a1bb416a7dd, 0xf0fdf2d3f3c30b9f, 0x656d44a2a11c51d5,
+                0x969eb7c47859e743, 0x9f644ae5a4b1b325, 0xbc4665b596706114, 0x873d5d9f0dde1fee,
+                0xeb57ff22fc0c7959, 0xa90cb506d155a7ea, 0x9316ff75dd87cbd8, 0x09a7f12442d588f2,
+                0xb7dcbf5354e9bece, 0x0c11ed6d538aeb2f, 0xe5d3ef282a242e81, 0x8f1668c8a86da5fa,
+                0x8fa475791a569d10, 0xf96e017d694487bc, 0xb38d92d760ec4455, 0x37c981dcc395a9ac,
+                0xe070f78d3927556a, 0x85bbe253f47b1417, 0x8c469ab843b89562, 0x93956d7478ccec8e,
+                0xaf58416654a6babb, 0x387ac8d1970027b2, 0xdb2e51bfe9d0696a, 0x06997b05fcc0319e,
+                0x88fcf317f22241e2, 0x441fece3bdf81f03, 0xab3c2fddeeaad25a, 0xd527e81cad7626c3,
+                0xd60b3bd56a5586f1, 0x8a71e223d8d3b074, 0x85c7056562757456, 0xf6872d5667844e49,
+                0xa738c6bebb12d16c, 0xb428f8ac016561db, 0xd106f86e69d785c7, 0xe13336d701beba52,
+                0x82a45b450226b39c, 0xecc0024661173473, 0xa34d721642b06084, 0x27f002d7f95d0190,
+                0xcc20ce9bd35c78a5, 0x31ec038df7b441f4, 0xff290242c83396ce, 0x7e67047175a15271,
+                0x9f79a169bd203e41, 0x0f0062c6e984d386, 0xc75809c42c684dd1, 0x52c07b78a3e60868,
+                0xf92e0c3537826145, 0xa7709a56ccdf8a82, 0x9bbcc7a142b17ccb, 0x88a66076400bb691,
+                0xc2abf989935ddbfe, 0x6acff893d00ea435, 0xf356f7ebf83552fe, 0x0583f6b8c4124d43,
+                0x98165af37b2153de, 0xc3727a337a8b704a, 0xbe1bf1b059e9a8d6, 0x744f18c0592e4c5c,
+                0xeda2ee1c7064130c, 0x1162def06f79df73, 0x9485d4d1c63e8be7, 0x8addcb5645ac2ba8,
+                0xb9a74a0637ce2ee1, 0x6d953e2bd7173692, 0xe8111c87c5c1ba99, 0xc8fa8db6ccdd0437,
+                0x910ab1d4db9914a0, 0x1d9c9892400a22a2, 0xb54d5e4a127f59c8, 0x2503beb6d00cab4b,
+                0xe2a0b5dc971f303a, 0x2e44ae64840fd61d, 0x8da471a9de737e24, 0x5ceaecfed289e5d2,
+                0xb10d8e1456105dad, 0x7425a83e872c5f47, 0xdd50f1996b947518, 0xd12f124e28f77719,
+                0x8a5296ffe33cc92f, 0x82bd6b70d99aaa6f, 0xace73cbfdc0bfb7b, 0x636cc64d1001550b,
+                0xd8210befd30efa5a, 0x3c47f7e05401aa4e, 0x8714a775e3e95c78, 0x65acfaec34810a71,
+                0xa8d9d1535ce3b396, 0x7f1839a741a14d0d, 0xd31045a8341ca07c, 0x1ede48111209a050,
+                0x83ea2b892091e44d, 0x934aed0aab460432, 0xa4e4b66b68b65d60, 0xf81da84d5617853f,
+                0xce1de40642e3f4b9, 0x36251260ab9d668e, 0x80d2ae83e9ce78f3, 0xc1d72b7c6b426019,
+                0xa1075a24e4421730, 0xb24cf65b8612f81f, 0xc94930ae1d529cfc, 0xdee033f26797b627,
+                0xfb9b7cd9a4a7443c, 0x169840ef017da3b1, 0x9d412e0806e88aa5, 0x8e1f289560ee864e,
+                0xc491798a08a2ad4e, 0xf1a6f2bab92a27e2, 0xf5b5d7ec8acb58a2, 0xae10af696774b1db,
+                0x9991a6f3d6bf1765, 0xacca6da1e0a8ef29, 0xbff610b0cc6edd3f, 0x17fd090a58d32af3,
+                0xeff394dcff8a948e, 0xddfc4b4cef07f5b0, 0x95f83d0a1fb69cd9, 0x4abdaf101564f98e,
+                0xbb764c4ca7a4440f, 0x9d6d1ad41abe37f1, 0xea53df5fd18d5513, 0x84c86189216dc5ed,
+                0x92746b9be2f8552c, 0x32fd3cf5b4e49bb4, 0xb7118682dbb66a77, 0x3fbc8c33221dc2a1,
+                0xe4d5e82392a40515, 0x0fabaf3feaa5334a, 0x8f05b1163ba6832d, 0x29cb4d87f2a7400e,
+                0xb2c71d5bca9023f8, 0x743e20e9ef511012, 0xdf78e4b2bd342cf6, 0x914da9246b255416,
+                0x8bab8eefb6409c1a, 0x1ad089b6c2f7548e, 0xae9672aba3d0c320, 0xa184ac2473b529b1,
+                0xda3c0f568cc4f3e8, 0xc9e5d72d90a2741e, 0x8865899617fb1871, 0x7e2fa67c7a658892,
+                0xaa7eebfb9df9de8d, 0xddbb901b98feeab7, 0xd51ea6fa85785631, 0x552a74227f3ea565,
+                0x8533285c936b35de, 0xd53a88958f87275f, 0xa67ff273b8460356, 0x8a892abaf368f137,
+                0xd01fef10a657842c, 0x2d2b7569b0432d85, 0x8213f56a67f6b29b, 0x9c3b29620e29fc73,
+                0xa298f2c501f45f42, 0x8349f3ba91b47b8f, 0xcb3f2f7642717713, 0x241c70a936219a73,
+                0xfe0efb53d30dd4d7, 0xed238cd383aa0110, 0x9ec95d1463e8a506, 0xf4363804324a40aa,
+                0xc67bb4597ce2ce48, 0xb143c6053edcd0d5, 0xf81aa16fdc1b81da, 0xdd94b7868e94050a,
+                0x9b10a4e5e9913128, 0xca7cf2b4191c8326, 0xc1d4ce1f63f57d72, 0xfd1c2f611f63a3f0,
+                0xf24a01a73cf2dccf, 0xbc633b39673c8cec, 0x976e41088617ca01, 0xd5be0503e085d813,
+                0xbd49d14aa79dbc82, 0x4b2d8644d8a74e18, 0xec9c459d51852ba2, 0xddf8e7d60ed1219e,
+                0x93e1ab8252f33b45, 0xcabb90e5c942b503, 0xb8da1662e7b00a17, 0x3d6a751f3b936243,
+                0xe7109bfba19c0c9d, 0x0cc512670a783ad4, 0x906a617d450187e2, 0x27fb2b80668b24c5,
+                0xb484f9dc9641e9da, 0xb1f9f660802dedf6, 0xe1a63853bbd26451, 0x5e7873f8a0396973,
+                0x8d07e33455637eb2, 0xdb0b487b6423e1e8, 0xb049dc016abc5e5f, 0x91ce1a9a3d2cda62,
+                0xdc5c5301c56b75f7, 0x7641a140cc7810fb, 0x89b9b3e11b6329ba, 0xa9e904c87fcb0a9d,
+                0xac2820d9623bf429, 0x546345fa9fbdcd44, 0xd732290fbacaf133, 0xa97c177947ad4095,
+                0x867f59a9d4bed6c0, 0x49ed8eabcccc485d, 0xa81f301449ee8c70, 0x5c68f256bfff5a74,
+                0xd226fc195c6a2f8c, 0x73832eec6fff3111, 0x83585d8fd9c25db7, 0xc831fd53c5ff7eab,
+                0xa42e74f3d032f525, 0xba3e7ca8b77f5e55, 0xcd3a1230c43fb26f, 0x28ce1bd2e55f35eb,
+                0x80444b5e7aa7cf85, 0x7980d163cf5b81b3, 0xa0555e361951c366, 0xd7e105bcc332621f,
+                0xc86ab5c39fa63440, 0x8dd9472bf3fefaa7, 0xfa856334878fc150, 0xb14f98f6f0feb951,
+                0x9c935e00d4b9d8d2, 0x6ed1bf9a569f33d3, 0xc3b8358109e84f07, 0x0a862f80ec4700c8,
+                0xf4a642e14c6262c8, 0xcd27bb612758c0fa, 0x98e7e9cccfbd7dbd, 0x8038d51cb897789c,
+                0xbf21e44003acdd2c, 0xe0470a63e6bd56c3, 0xeeea5d5004981478, 0x1858ccfce06cac74,
+                0x95527a5202df0ccb, 0x0f37801e0c43ebc8, 0xbaa718e68396cffd, 0xd30560258f54e6ba,
+                0xe950df20247c83fd, 0x47c6b82ef32a2069, 0x91d28b7416cdd27e, 0x4cdc331d57fa5441,
+                0xb6472e511c81471d, 0xe0133fe4adf8e952, 0xe3d8f9e563a198e5, 0x58180fddd97723a6,
+                0x8e679c2f5e44ff8f, 0x570f09eaa7ea7648
+            };
+
+            return table;
+        }
+
+        static double FromBits(const std::uint64_t bits)
+        {
+            double result;
+            std::memcpy(&result, &bits, sizeof(result));
+
+            return result;
+        }
+
+        // Clinger: both operands are exact doubles, so one IEEE operation
+        // rounds correctly.
+        static bool TryFastPath(const std::int64_t q, const std::uint64_t w, double &result)
+        {
+            static const double powersOfTen[] =
+            {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+            };
+
+            if( q < -22 || q > 22 || w > (std::uint64_t(1) << 53) )
+                return false;
+
+            result = static_cast<double>(w);
+            if( q < 0 )
+                result /= powersOfTen[-q];
+            else
+                result *= powersOfTen[q];
+
+            return true;
+        }
+
+        // Eisel-Lemire: computes the bits of w * 10^q, or returns false when
+        // the 128-bit product cannot decide the rounding.
+        static bool TryEiselLemire(const std::int64_t q, std::uint64_t w, std::uint64_t &bits)
+        {
+            const int mantissaBits = 52;
+            const std::uint64_t infinity = std::uint64_t(0x7FF) << mantissaBits;
+
+            if( w == 0 || q < -342 )
+            {
+                bits = 0;
+                return true;
+            }
+
+            if( q > 308 )
+            {
+                bits = infinity;
+                return true;
+            }
+
+            const int leadingZeros = CountLeadingZeros64(w);
+            w <<= leadingZeros;
+
+            const std::uint64_t *const pPower = PowersOfFive() + 2 * (q + 342);
+
+            std::uint64_t high, low;
+            Multiply64(w, pPower[0], high, low);
+
+            const std::uint64_t precisionMask = UINT64_MAX >> (mantissaBits + 3);
+            if( (high & precisionMask) == precisionMask )
+            {
+                std::uint64_t secondHigh, secondLow;
+                Multiply64(w, pPower[1], secondHigh, secondLow);
+
+                low += secondHigh;
+                if( secondHigh > low )
+                    ++high;
+
+                if( low == UINT64_MAX && (q < -27 || q > 55) )
+                    return false;
+            }
+
+            const int upperBit = static_cast<int>(high >> 63);
+            const int shift = upperBit + 64 - mantissaBits - 3;
+
+            std::uint64_t m = high >> shift;
+            std::int64_t power2 = (((152170 + 65536) * q) >> 16) + 63 + upperBit - leadingZeros + 1023;
+
+            if( power2 <= 0 )
+            {
+                if( -power2 + 1 >= 64 )
+                {
+                    bits = 0;
+                    return true;
+                }
+
+                m >>= -power2 + 1;
+                m += m & 1;
+                m >>= 1;
+
+                power2 = m < (std::uint64_t(1) << mantissaBits) ? 0 : 1;
+                bits = m | (static_cast<std::uint64_t>(power2) << mantissaBits);
+                return true;
+            }
+
+            // Exactly halfway between two doubles: round to even.
+            if( low <= 1 && q >= -4 && q <= 23 && (m & 3) == 1 && (m << shift) == high )
+                m &= ~std::uint64_t(1);
+
+            m += m & 1;
+            m >>= 1;
+
+            if( m >= (std::uint64_t(2) << mantissaBits) )
+            {
+                m = std::uint64_t(1) << mantissaBits;
+                ++power2;
+            }
+
+            m &= ~(std::uint64_t(1) << mantissaBits);
+
+            if( power2 >= 0x7FF )
+            {
+                bits = infinity;
+                return true;
+            }
+
+            bits = m | (static_cast<std::uint64_t>(power2) << mantissaBits);
+            return true;
+        }
+
+        // The digits and exponent contain no locale-dependent characters, so
+        // strtod's correctly rounded result can be used as is.
+        double SlowPath() const
+        {
+            std::string text = digits.empty() ? std::to_string(static_cast<unsigned long long>(mantissa)) : digits;
+            std::int64_t e = exponent - static_cast<std::int64_t>(text.size()) + mantissaDigits;
+
+            if( truncatedNonZero )
+            {
+                text.push_back('1');
+                --e;
+            }
+
+            text += "e" + std::to_string(static_cast<long long>(e));
+            return std::strtod(text.c_str(), nullptr);
+        }
+
+        double ToDouble() const
+        {
+            double result = 0;
+
+            if( mantissa != 0 )
+            {
+                std::uint64_t bits;
+
+                if( !digits.empty() )
+                {
+                    std::uint64_t bitsUpper;
+                    if( TryEiselLemire(exponent, mantissa, bits) && TryEiselLemire(exponent, mantissa + 1, bitsUpper) && bits == bitsUpper )
+                        result = FromBits(bits);
+                    else
+                        result = SlowPath();
+                }
+                else if( !TryFastPath(exponent, mantissa, result) )
+                {
+                    result = TryEiselLemire(exponent, mantissa, bits) ? FromBits(bits) : SlowPath();
+                }
+
+                if( result > DBL_MAX )
+                    throw std::runtime_error("number out of range");
+            }
+
+            return negative ? -result : result;
+        }
+
+        Value ToInteger(const std::uint64_t value) const
+        {
+            const std::uint64_t int64Limit = std::uint64_t(1) << 63;
+
+            if( !negative )
+            {
+                if( value < int64Limit )
+                    return Value::MakeInt64(static_cast<std::int64_t>(value));
+
+                return Value::MakeUInt64(value);
+            }
+
+            if( value == 0 )
+                return Value::MakeNumber(-0.0);
+
+            if( value == int64Limit )
+                return Value::MakeInt64(INT64_MIN);
+
+            if( value < int64Limit )
+                return Value::MakeInt64(-static_cast<std::int64_t>(value));
+
+            return Value::MakeNumber(ToDouble());
+        }
+
+    public:
+        explicit DecimalNumber(const bool negative_) :
+            negative(negative_),
+            integral(true),
+            mantissa(0),
+            mantissaDigits(0),
+            exponent(0),
+            truncatedNonZero(false)
+        {
+        }
+
+        void PushDigit(const char ch, const bool fraction)
+        {
+            const unsigned digit = static_cast<unsigned>(ch - '0');
+
+            if( mantissaDigits < MaxMantissaDigits )
+            {
+                if( fraction )
+                    --exponent;
+
+                if( mantissa != 0 || digit != 0 )
+                {
+                    mantissa = mantissa * 10 + digit;
+                    ++mantissaDigits;
+                }
+
+                return;
+            }
+
+            if( digits.empty() )
+                digits = std::to_string(static_cast<unsigned long long>(mantissa));
+
+            if( !fraction )
+                ++exponent;
+
+            if( digits.size() < MaxDigits )
+                digits.push_back(ch);
+            else if( digit != 0 )
+                truncatedNonZero = true;
+        }
+
+        void BeginFraction()
+        {
+            integral = false;
+        }
+
+        void AddExponent(const std::int64_t e)
+        {
+            integral = false;
+            exponent += e;
+        }
+
+        Value ToValue() const
+        {
+            if( integral )
+            {
+                if( digits.empty() )
+                    return ToInteger(mantissa);
+
+                const unsigned last = static_cast<unsigned>(digits.back() - '0');
+                if( digits.size() == static_cast<std::size_t>(MaxMantissaDigits) + 1 && mantissa <= (UINT64_MAX - last) / 10 )
+                    return ToInteger(mantissa * 10 + last);
+            }
+
+            return Value::MakeNumber(ToDouble());
+        }
+    };
+
+    // Default event handlers for Parse. Derive with CRTP and override the
+    // events of interest; integers are reported as Number unless Int64 or
+    // UInt64 are overridden.
+    template <class Derived>
+    struct HandlerBase
+    {
+        void Null() { }
+        void Bool(bool) { }
+        void Number(double) { }
+        void Int64(const std::int64_t value) { static_cast<Derived &>(*this).Number(static_cast<double>(value)); }
+        void UInt64(const std::uint64_t value) { static_cast<Derived &>(*this).Number(static_cast<double>(value)); }
+        void String(const StringView &, bool) { }
+        void Key(const StringView &, bool) { }
+        void StartArray() { }
+        void EndArray(std::size_t) { }
+        void StartObject() { }
+        void EndObject(std::size_t) { }
+    };
+
+    // Limits for parsing untrusted input. Exceeding one throws as soon as
+    // the offending value is reached.
+    struct ParseOptions
+    {
+        // Deepest nesting of arrays and objects; a top-level array is 1.
+        std::size_t maxDepth;
+
+        // Longest string or key in bytes, after unescaping.
+        std::size_t maxStringLength;
+
+        // Most values in the document, containers included.
+        std::size_t maxNodes;
+
+        // Largest input read for one document.
+        std::size_t maxInputBytes;
+
+        ParseOptions() :
+            maxDepth(1024),
+            maxStringLength(std::numeric_limits<std::size_t>::max()),
+            maxNodes(std::numeric_limits<std::size_t>::max()),
+            maxInputBytes(std::numeric_limits<std::size_t>::max())
+        {
+        }
+    };
+
+    // Open containers of the reader with their element counts. The first
+    // levels are stored inline, so typical documents need no allocation.
+    class ContainerStack
+    {
+    public:
+        struct Frame
+        {
+            std::size_t count;
+            bool object;
+        };
+
+    private:
+        static const std::size_t InlineCapacity = 32;
+
+        Frame inlineFrames[InlineCapacity];
+        std::vector<Frame> heapFrames;
+        Frame *pFrames;
+        std::size_t size;
+        std::size_t capacity;
+
+        void Grow()
+        {
+            std::vector<Frame> frames(capacity * 2);
+            std::copy(pFrames, pFrames + size, frames.begin());
+
+            heapFrames.swap(frames);
+            pFrames = heapFrames.data();
+            capacity = heapFrames.size();
+        }
+
+    public:
+        explicit ContainerStack() :
+            pFrames(inlineFrames),
+            size(0),
+            capacity(InlineCapacity)
+        {
+        }
+
+        ContainerStack(const ContainerStack &) =delete;
+        void operator =(const ContainerStack &) =delete;
+
+        bool Empty() const
+        {
+            return size == 0;
+        }
+
+        std::size_t Size() const
+        {
+            return size;
+        }
+
+        Frame &Top()
+        {
+            assert(size > 0);
+            return pFrames[size - 1];
+        }
+
+        void Push(const bool object)
+        {
+            if( size == capacity )
+                Grow();
+
+            Frame &frame = pFrames[size++];
+            frame.count = 0;
+            frame.object = object;
+        }
+
+        void Pop()
+        {
+            assert(size > 0);
+            --size;
+        }
+
+        void Clear()
+        {
+            size = 0;
+        }
+
+        // Bytes allocated beyond the inline frames.
+        std::size_t Capacity() const
+        {
+            return heapFrames.size() * sizeof(Frame);
+        }
+
+        void Release()
+        {
+            std::vector<Frame>().swap(heapFrames);
+            size = 0;
+            pFrames = inlineFrames;
+            capacity = InlineCapacity;
+        }
+    };
+
+    template <class Itr>
+    class Reader
+    {
+    protected:
+        static bool IsWhitespace(const char ch)
+        {
+            switch( ch )
+            {
+                case ' ':
+                case '\n':
+                case '\r':
+                case '\t':
+                    return true;
+            }
+
+            return false;
+        }
+
+        static bool IsDigit(const char ch)
+        {
+            return ch >= '0' && ch <= '9';
+        }
+
+        static void SkipWhitespace(Itr &itr)
+        {
+            while( IsWhitespace(*itr) )
+                ++itr;
+        }
+
+        template <std::size_t N>
+        static bool TryReadExpectedString(Itr &itr, const char(&pStr)[N])
+        {
+            static_assert(N > 0, "internal error: string not null-terminated");
+
+            for(std::size_t i = 0; i < (N - 1); ++i, ++itr)
+                if( *itr != pStr[i] )
+                    return false;
+
+            return true;
+        }
+
+        static void ExpectDigit(Itr &itr)
+        {
+            if( !IsDigit(*itr) )
+                throw std::runtime_error("digit expected");
+        }
+
+        static Value ReadNumber(Itr &itr)
+        {
+            const bool negative = *itr == '-';
+            if( negative )
+                ++itr;
+
+            ExpectDigit(itr);
+            DecimalNumber number(negative);
+
+            if( *itr == '0' )
+            {
+                number.PushDigit('0', false);
+                ++itr;
+
+                if( IsDigit(*itr) )
+                    throw std::runtime_error("leading zeros are not allowed");
+            }
+
+            for( char ch; IsDigit(ch = *itr); ++itr )
+                number.PushDigit(ch, false);
+
+            if( *itr == '.' )
+            {
+                ++itr;
+                ExpectDigit(itr);
+                number.BeginFraction();
+
+                for( char ch; IsDigit(ch = *itr); ++itr )
+                    number.PushDigit(ch, true);
+            }
+
+            const char exponent = *itr;
+            if( exponent == 'e' || exponent == 'E' )
+            {
+                ++itr;
+
+                bool eNegative = false;
+                const char eSign = *itr;
+                if( eSign == '+' )
+                {
+                    ++itr;
+                }
+                else if( eSign == '-' )
+                {
+                    eNegative = true;
+                    ++itr;
+                }
+
+                ExpectDigit(itr);
+
+                std::int64_t e = 0;
+                for( char ch; IsDigit(ch = *itr); ++itr )
+                    if( e < 1000000000 )
+                        e = e * 10 + (ch - '0');
+
+                number.AddExponent(eNegative ? -e : e);
+            }
+
+            return number.ToValue();
+        }
+
+        static void ReadExpectedChar(Itr &itr, const char ch)
+        {
+            if( *itr != ch )
+                throw std::runtime_error("'" + std::string(1, ch) + "' expected");
+
+            ++itr;
+        }
+
+        static StringView ReadString(Itr &itr, String &scratch)
+        {
+            return StringReader<Itr>::Read(itr, scratch);
+        }
+
+        static String ReadString(Itr &itr)
+        {
+            String scratch;
+            const auto str = ReadString(itr, scratch);
+
+            if( str.data() == scratch.data() )
+                return scratch;
+
+            return str.str();
+        }
+
+        template <class Handler>
+        static void ReadNumber(Itr &itr, Handler &handler)
+        {
+            const auto number = ReadNumber(itr);
+
+            if( number.IsInt64() )
+                handler.Int64(number.AsInt64());
+            else if( number.IsUInt64() )
+                handler.UInt64(number.AsUInt64());
+            else
+                handler.Number(number.AsNumber());
+        }
+
+        static void CheckLength(const StringView &str, const ParseOptions &options)
+        {
+            if( str.size() > options.maxStringLength )
+                throw std::runtime_error("string too long");
+        }
+
+        template <class Handler>
+        static void ReadKey(Itr &itr, Handler &handler, String &scratch, const ParseOptions &options)
+        {
+            SkipWhitespace(itr);
+
+            if( *itr != '"' )
+                throw std::runtime_error("string expected");
+
+            const auto key = ReadString(itr, scratch);
+            CheckLength(key, options);
+            handler.Key(key, key.data() == scratch.data());
+
+            SkipWhitespace(itr);
+            ReadExpectedChar(itr, ':');
+        }
+
+        static void CheckDepth(const ContainerStack &stack, const ParseOptions &options)
+        {
+            if( stack.Size() >= options.maxDepth )
+                throw std::runtime_error("nesting too deep");
+        }
+
+    public:
+        // Reads one value and reports it to handler as a sequence of events.
+        // Strings are passed as views; transient ones only live until the
+        // handler returns. Open containers are kept on an explicit stack, so
+        // nesting is bounded by options rather than by the thread's stack.
+        // Returns the number of values read, containers included.
+        template <class Handler>
+        static std::size_t ReadValue(Itr &itr, Handler &handler, String &scratch, const ParseOptions &options = ParseOptions())
+        {
+            ContainerStack stack;
+            return ReadValue(itr, handler, scratch, stack, options);
+        }
+
+        template <class Handler>
+        static std::size_t ReadValue(Itr &itr, Handler &handler, String &scratch, ContainerStack &stack, const ParseOptions &options)
+        {
+            itr.LimitInput(options.maxInputBytes);
+            stack.Clear();
+
+            std::size_t nodes = 0;
+
+            for( ;; )
+            {
+                SkipWhitespace(itr);
+
+                if( ++nodes > options.maxNodes )
+                    throw std::runtime_error("too many values");
+
+                switch( *itr )
+                {
+                    case '-':
+                    case TinyJson_Digits_0_9:
+                        ReadNumber(itr, handler);
+                        break;
+
+                    case '"':
+                    {
+                        const auto str = ReadString(itr, scratch);
+                        CheckLength(str, options);
+                        handler.String(str, str.data() == scratch.data());
+                    }
+                    break;
+
+                    case '[':
+                    {
+                        CheckDepth(stack, options);
+                        ++itr;
+                        handler.StartArray();
+
+                        SkipWhitespace(itr);
+                        if( *itr != ']' )
+                        {
+                            stack.Push(false);
+                            continue;
+                        }
+
+                        ++itr;
+                        handler.EndArray(0);
+                    }
+                    break;
+
+                    case '{':
+                    {
+                        CheckDepth(stack, options);
+                        ++itr;
+                        handler.StartObject();
+
+                        SkipWhitespace(itr);
+                        if( *itr != '}' )
+                        {
+                            stack.Push(true);
+                            ReadKey(itr, handler, scratch, options);
+                            continue;
+                        }
+
+                        ++itr;
+                        handler.EndObject(0);
+                    }
+                    break;
+
+                    case 't':
+                        if( !TryReadExpectedString(itr, "true") )
+                            throw std::runtime_error("Invalid format");
+
+                        handler.Bool(true);
+                        break;
+
+                    case 'f':
+                        if( !TryReadExpectedString(itr, "false") )
+                            throw std::runtime_error("Invalid format");
+
+                        handler.Bool(false);
+                        break;
+
+                    case 'n':
+                        if( !TryReadExpectedString(itr, "null") )
+                            throw std::runtime_error("Invalid format");
+
+                        handler.Null();
+                        break;
+
+                    default:
+                        throw std::runtime_error("Invalid format");
+                }
+
+                // A value is complete; close every container that ends here.
+                for( ;; )
+                {
+                    if( stack.Empty() )
+                        return nodes;
+
+                    ContainerStack::Frame &frame = stack.Top();
+                    ++frame.count;
+
+                    SkipWhitespace(itr);
+                    if( *itr == ',' )
+                    {
+                        ++itr;
+
+                        if( frame.object )
+                            ReadKey(itr, handler, scratch, options);
+
+                        break;
+                    }
+
+                    const std::size_t count = frame.count;
+                    const bool object = frame.object;
+                    stack.Pop();
+
+                    if( object )
+                    {
+                        ReadExpectedChar(itr, '}');
+                        handler.EndObject(count);
+                    }
+                    else
+                    {
+                        ReadExpectedChar(itr, ']');
+                        handler.EndArray(count);
+                    }
+                }
+            }
+        }
+
+        static ValuePtr ReadValue(Itr &itr, const ParseOptions &options = ParseOptions());
+
+        // Skips whitespace after the root value; anything else left in the
+        // input is an error.
+        static void ReadEnd(Itr &itr)
         {
             SkipWhitespace(itr);
 
-            if( *itr != '"' )
-                throw std::runtime_error("string expected");
+            if( !itr.AtEnd() )
+                throw std::runtime_error("unexpected trailing characters");
+        }
+    };
+
+    // Builds the ValuePtr tree returned by Read. As in DocumentBuilder,
+    // children are collected on scratch stacks and moved into their
+    // container once it closes, so each container is sized exactly once.
+    class ValueBuilder : public HandlerBase<ValueBuilder>
+    {
+        // Scratch capacity taken at the first container, so that small
+        // documents such as NDJSON lines never regrow the stacks.
+        static const std::size_t InitialCapacity = 16;
+
+        std::vector<ValuePtr> values;
+        std::vector<std::string> keys;
+        ValuePtr root;
+        std::size_t depth;
+
+        template <class T, class U>
+        static std::unique_ptr<T> CreateValue(U &&value)
+        {
+            static_assert(std::is_base_of<ValueBase, T>::value, "internal error: invalid type passed to CreateValue");
+
+            std::unique_ptr<T> ptr(new T());
+            ptr->value = std::move(value);
+
+            return ptr;
+        }
+
+        void Add(ValuePtr value)
+        {
+            if( depth == 0 )
+                root = std::move(value);
+            else
+                values.push_back(std::move(value));
+        }
+
+        void Open()
+        {
+            if( depth++ == 0 && values.capacity() == 0 )
+            {
+                values.reserve(InitialCapacity);
+                keys.reserve(InitialCapacity);
+            }
+        }
+
+    public:
+        explicit ValueBuilder() :
+            depth(0)
+        {
+        }
+
+        void Null()
+        {
+            Add(ValuePtr(new NullValue()));
+        }
+
+        void Bool(const bool value)
+        {
+            Add(CreateValue<BooleanValue>(value));
+        }
+
+        void Number(const double value)
+        {
+            Add(CreateValue<NumberValue>(value));
+        }
+
+        void Int64(const std::int64_t value)
+        {
+            NumberValue *const pNumber = new NumberValue();
+            ValuePtr ptr(pNumber);
+
+            pNumber->value = static_cast<double>(value);
+            pNumber->numberType = NumberType::Int64;
+            pNumber->int64Value = value;
+
+            Add(std::move(ptr));
+        }
+
+        void UInt64(const std::uint64_t value)
+        {
+            NumberValue *const pNumber = new NumberValue();
+            ValuePtr ptr(pNumber);
+
+            pNumber->value = static_cast<double>(value);
+            pNumber->numberType = NumberType::UInt64;
+            pNumber->uint64Value = value;
+
+            Add(std::move(ptr));
+        }
+
+        void String(const StringView &str, bool)
+        {
+            Add(CreateValue<StringValue>(str.str()));
+        }
+
+        void Key(const StringView &key, bool)
+        {
+            keys.push_back(key.str());
+        }
+
+        void StartArray()
+        {
+            Open();
+        }
+
+        void EndArray(const std::size_t count)
+        {
+            --depth;
+
+            const auto first = values.end() - static_cast<std::ptrdiff_t>(count);
+
+            std::unique_ptr<ArrayValue> pArray(new ArrayValue());
+            pArray->value.assign(std::make_move_iterator(first), std::make_move_iterator(values.end()));
+            values.erase(first, values.end());
+
+            Add(std::move(pArray));
+        }
+
+        void StartObject()
+        {
+            Open();
+        }
+
+        void EndObject(const std::size_t count)
+        {
+            --depth;
+
+            const std::size_t firstValue = values.size() - count;
+            const std::size_t firstKey = keys.size() - count;
+
+            std::unique_ptr<ObjectValue> pObject(new ObjectValue());
+            Object &obj = pObject->value;
+            obj.reserve(count);
+
+            for( std::size_t i = 0; i < count; ++i )
+            {
+                const auto result = obj.emplace(std::move(keys[firstKey + i]), std::move(values[firstValue + i]));
+                if( !result.second )
+                    throw std::runtime_error("duplicate key: " + result.first->first);
+            }
+
+            values.resize(firstValue);
+            keys.resize(firstKey);
+
+            Add(std::move(pObject));
+        }
+
+        ValuePtr TakeRoot()
+        {
+            return std::move(root);
+        }
+    };
+
+    template <class Itr>
+    ValuePtr Reader<Itr>::ReadValue(Itr &itr, const ParseOptions &options)
+    {
+        ValueBuilder builder;
+        String scratch;
+
+        ReadValue(itr, builder, scratch, options);
+        return builder.TakeRoot();
+    }
+
+    // Builds Document values inside an arena. Children are collected on
+    // scratch stacks and copied into the arena once their container closes.
+    class DocumentBuilder : public HandlerBase<DocumentBuilder>
+    {
+        static const std::size_t LinearDuplicateCheckLimit = 16;
+
+        Arena &arena;
+        bool referenceInput;
+        KeyPool *const pKeyPool;
+        std::vector<Value> values;
+        std::vector<Member> members;
+        std::vector<bool> inObject;
+        std::vector<StringView> keys;
+        Value root;
+
+        Value CreateString(const StringView &str, const bool transient)
+        {
+            if( referenceInput && !transient )
+                return Value::MakeString(str.data(), str.size());
+
+            return Value::MakeString(arena.CopyString(str.data(), str.size()), str.size());
+        }
+
+        void Add(const Value &value)
+        {
+            if( inObject.empty() )
+                root = value;
+            else if( inObject.back() )
+                members.back().value = value;
+            else
+                values.push_back(value);
+        }
+
+        void CheckDuplicateKeys(const std::size_t first)
+        {
+            const std::size_t count = members.size() - first;
+
+            if( count <= LinearDuplicateCheckLimit )
+            {
+                for( std::size_t i = first + 1; i < members.size(); ++i )
+                    for( std::size_t j = first; j < i; ++j )
+                        if( members[i].key.AsString() == members[j].key.AsString() )
+                            throw std::runtime_error("duplicate key: " + members[i].key.AsString().str());
+
+                return;
+            }
+
+            keys.clear();
+            for( std::size_t i = first; i < members.size(); ++i )
+                keys.push_back(members[i].key.AsString());
+
+            std::sort(keys.begin(), keys.end());
+
+            const auto itr = std::adjacent_find(keys.begin(), keys.end());
+            if( itr != keys.end() )
+                throw std::runtime_error("duplicate key: " + itr->str());
+        }
+
+    public:
+        explicit DocumentBuilder(Arena &arena_, const bool referenceInput_ = false, KeyPool *const pKeyPool_ = nullptr) :
+            arena(arena_),
+            referenceInput(referenceInput_),
+            pKeyPool(pKeyPool_),
+            root(Value::MakeNull())
+        {
+        }
+
+        void Null()
+        {
+            Add(Value::MakeNull());
+        }
+
+        void Bool(const bool value)
+        {
+            Add(Value::MakeBoolean(value));
+        }
+
+        void Number(const double value)
+        {
+            Add(Value::MakeNumber(value));
+        }
+
+        void Int64(const std::int64_t value)
+        {
+            Add(Value::MakeInt64(value));
+        }
+
+        void UInt64(const std::uint64_t value)
+        {
+            Add(Value::MakeUInt64(value));
+        }
+
+        void String(const StringView &str, const bool transient)
+        {
+            Add(CreateString(str, transient));
+        }
+
+        void Key(const StringView &key, const bool transient)
+        {
+            const char *const pPooled = pKeyPool ? pKeyPool->Intern(key) : nullptr;
+
+            Member member;
+            member.key = pPooled ? Value::MakeString(pPooled, key.size()) : CreateString(key, transient);
+            member.value = Value::MakeNull();
+
+            members.push_back(member);
+        }
+
+        void StartArray()
+        {
+            inObject.push_back(false);
+        }
+
+        void EndArray(const std::size_t count)
+        {
+            inObject.pop_back();
+
+            const std::size_t first = values.size() - count;
+
+            Value *const pItems = arena.AllocateArray<Value>(count);
+            std::copy(values.begin() + first, values.end(), pItems);
+            values.resize(first);
+
+            Add(Value::MakeArray(pItems, count));
+        }
+
+        void StartObject()
+        {
+            inObject.push_back(true);
+        }
+
+        void EndObject(const std::size_t count)
+        {
+            inObject.pop_back();
+
+            const std::size_t first = members.size() - count;
+            CheckDuplicateKeys(first);
+
+            Member *const pMembers = arena.AllocateArray<Member>(count);
+            std::copy(members.begin() + first, members.end(), pMembers);
+            members.resize(first);
+
+            Add(Value::MakeObject(pMembers, count));
+        }
+
+        const Value &Root() const
+        {
+            return root;
+        }
+
+        // Prepares for another document, keeping the capacity of the stacks.
+        void Reset(const bool referenceInput_)
+        {
+            referenceInput = referenceInput_;
+            values.clear();
+            members.clear();
+            inObject.clear();
+            keys.clear();
+            root = Value::MakeNull();
+        }
+
+        std::size_t Capacity() const
+        {
+            return values.capacity() * sizeof(Value) + members.capacity() * sizeof(Member) +
+                inObject.capacity() / 8 + keys.capacity() * sizeof(StringView);
+        }
+
+        void Release()
+        {
+            std::vector<Value>().swap(values);
+            std::vector<Member>().swap(members);
+            std::vector<bool>().swap(inObject);
+            std::vector<StringView>().swap(keys);
+        }
+    };
+
+    template <class Itr>
+    CharItr<Itr> MakeStream(const Itr &begin, const Itr &end)
+    {
+        return CharItr<Itr>(begin, end);
+    }
+
+    inline CharPtr MakeStream(const char *const pStr)
+    {
+        return CharPtr(pStr, pStr + std::strlen(pStr));
+    }
+
+    inline CharPtr MakeStream(const std::string &str)
+    {
+        return CharPtr(str.data(), str.data() + str.size());
+    }
+
+    template <class Itr>
+    ValuePtr Read(CharItr<Itr> &stream, const ParseOptions &options = ParseOptions())
+    {
+        return Reader<CharItr<Itr>>::ReadValue(stream, options);
+    }
+
+    inline ValuePtr Read(CharPtr &stream, const ParseOptions &options = ParseOptions())
+    {
+        return Reader<CharPtr>::ReadValue(stream, options);
+    }
+
+    // The stream overloads above read one value and leave the stream after
+    // it; the overloads below take the whole input and reject anything but
+    // whitespace after the value.
+    template <class Stream>
+    ValuePtr ReadAll(Stream &stream, const ParseOptions &options)
+    {
+        auto value = Read(stream, options);
+        Reader<Stream>::ReadEnd(stream);
+
+        return value;
+    }
+
+    template <class Itr>
+    ValuePtr Read(const Itr &begin, const Itr &end, const ParseOptions &options = ParseOptions())
+    {
+        auto stream = MakeStream(begin, end);
+        return ReadAll(stream, options);
+    }
+
+    inline ValuePtr Read(const char *const pStr, const ParseOptions &options = ParseOptions())
+    {
+        auto stream = MakeStream(pStr);
+        return ReadAll(stream, options);
+    }
+
+    inline ValuePtr Read(const std::string &str, const ParseOptions &options = ParseOptions())
+    {
+        auto stream = MakeStream(str);
+        return ReadAll(stream, options);
+    }
+
+    // The buffer is not known to be null-terminated, so it is copied once
+    // to take the CharPtr path rather than checking bounds on every character.
+    inline ValuePtr Read(const char *const pData, const std::size_t length, const ParseOptions &options = ParseOptions())
+    {
+        if( length > options.maxInputBytes )
+            throw std::runtime_error("input too large");
+
+        const std::string buffer(pData, length);
+        return Read(buffer, options);
+    }
+
+#ifdef TinyJson_HasStringView
+    inline ValuePtr Read(const std::string_view &str, const ParseOptions &options = ParseOptions())
+    {
+        return Read(str.data(), str.size(), options);
+    }
+#endif
+
+    // The contents of a file followed by a null terminator. Regular files are
+    // memory-mapped read-only; pipes, devices and files that cannot be mapped
+    // are read into a buffer. A mapped file must not be truncated while open.
+    class InputFile
+    {
+        const char *pData;
+        std::size_t length;
+        std::size_t mappedSize;
+        std::string buffer;
+
+        // Appends a chunk unless the input would outgrow maxBytes, so a
+        // stream without a known size is never read past the limit.
+        void Append(const char *const pChunk, const std::size_t count, const std::size_t maxBytes)
+        {
+            if( count > maxBytes - buffer.size() )
+                throw std::runtime_error("input too large");
+
+            buffer.append(pChunk, count);
+        }
+
+#ifdef _WIN32
+        void ReadAll(const std::string &path, const std::size_t maxBytes)
+        {
+            std::FILE *const pFile = std::fopen(path.c_str(), "rb");
+            if( !pFile )
+                throw std::runtime_error("failed to open file: " + path);
+
+            char chunk[65536];
+            std::size_t count;
+
+            try
+            {
+                while( (count = std::fread(chunk, 1, sizeof(chunk), pFile)) != 0 )
+                    Append(chunk, count, maxBytes);
+            }
+            catch( ... )
+            {
+                std::fclose(pFile);
+                throw;
+            }
+
+            const bool failed = std::ferror(pFile) != 0;
+            std::fclose(pFile);
+
+            if( failed )
+                throw std::runtime_error("failed to read file: " + path);
+        }
+#else
+        void ReadAll(const int fd, const std::string &path, const std::size_t maxBytes)
+        {
+            char chunk[65536];
+            for( ;; )
+            {
+                const ssize_t count = ::read(fd, chunk, sizeof(chunk));
+                if( count == 0 )
+                    break;
+
+                if( count < 0 )
+                {
+                    if( errno == EINTR )
+                        continue;
+
+                    throw std::runtime_error("failed to read file: " + path);
+                }
+
+                Append(chunk, static_cast<std::size_t>(count), maxBytes);
+            }
+        }
+
+        // Reserves one byte more than the file, rounded up to whole pages, and
+        // maps the file over the start, so the byte after the end reads as zero.
+        bool Map(const int fd, const std::size_t size)
+        {
+            const std::size_t pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+            const std::size_t total = (size + pageSize) / pageSize * pageSize;
+
+            void *const pBase = ::mmap(nullptr, total, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if( pBase == MAP_FAILED )
+                return false;
+
+            if( ::mmap(pBase, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED )
+            {
+                ::munmap(pBase, total);
+                return false;
+            }
+
+            ::madvise(pBase, size, MADV_SEQUENTIAL);
+
+            pData = static_cast<const char *>(pBase);
+            length = size;
+            mappedSize = total;
+
+            return true;
+        }
+#endif
+
+    public:
+        // Inputs larger than maxBytes throw "input too large" before they
+        // are mapped or, for pipes and other streams, read past the limit.
+        explicit InputFile(const std::string &path, const std::size_t maxBytes = std::numeric_limits<std::size_t>::max()) :
+            pData(nullptr),
+            length(0),
+            mappedSize(0)
+        {
+#ifdef _WIN32
+            ReadAll(path, maxBytes);
+#else
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if( fd < 0 )
+                throw std::runtime_error("failed to open file: " + path);
+
+            try
+            {
+                struct stat info;
+                const bool regular = ::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0;
+
+                if( regular && static_cast<std::uint64_t>(info.st_size) > maxBytes )
+                    throw std::runtime_error("input too large");
+
+                if( !regular || !Map(fd, static_cast<std::size_t>(info.st_size)) )
+                    ReadAll(fd, path, maxBytes);
+            }
+            catch( ... )
+            {
+                ::close(fd);
+                throw;
+            }
+
+            ::close(fd);
+#endif
+
+            if( !mappedSize )
+            {
+                pData = buffer.c_str();
+                length = buffer.size();
+            }
+        }
+
+        InputFile(const InputFile &) =delete;
+        void operator =(const InputFile &) =delete;
+
+        ~InputFile()
+        {
+#ifndef _WIN32
+            if( mappedSize )
+                ::munmap(const_cast<char *>(pData), mappedSize);
+#endif
+        }
+
+        const char *data() const
+        {
+            return pData;
+        }
+
+        std::size_t size() const
+        {
+            return length;
+        }
+
+        bool IsMapped() const
+        {
+            return mappedSize != 0;
+        }
+    };
+
+    inline ValuePtr ReadFile(const std::string &path, const ParseOptions &options = ParseOptions())
+    {
+        const InputFile file(path, options.maxInputBytes);
+        CharPtr stream(file.data(), file.data() + file.size());
+
+        return ReadAll(stream, options);
+    }
+
+    template <class Itr, class Handler>
+    void Parse(CharItr<Itr> &stream, Handler &handler, const ParseOptions &options = ParseOptions())
+    {
+        String scratch;
+        Reader<CharItr<Itr>>::ReadValue(stream, handler, scratch, options);
+    }
+
+    template <class Handler>
+    void Parse(CharPtr &stream, Handler &handler, const ParseOptions &options = ParseOptions())
+    {
+        String scratch;
+        Reader<CharPtr>::ReadValue(stream, handler, scratch, options);
+    }
+
+    template <class Itr, class Handler>
+    void Parse(const Itr &begin, const Itr &end, Handler &handler, const ParseOptions &options = ParseOptions())
+    {
+        auto stream = MakeStream(begin, end);
+        Parse(stream, handler, options);
+        Reader<CharItr<Itr>>::ReadEnd(stream);
+    }
+
+    template <class Handler>
+    void Parse(const char *const pStr, Handler &handler, const ParseOptions &options = ParseOptions())
+    {
+        auto stream = MakeStream(pStr);
+        Parse(stream, handler, options);
+        Reader<CharPtr>::ReadEnd(stream);
+    }
+
+    template <class Handler>
+    void Parse(const std::string &str, Handler &handler, const ParseOptions &options = ParseOptions())
+    {
+        auto stream = MakeStream(str);
+        Parse(stream, handler, options);
+        Reader<CharPtr>::ReadEnd(stream);
+    }
+
+    // Forwards events to handler with every string marked transient, for
+    // readers whose input is a temporary copy.
+    template <class Handler>
+    class TransientAdapter
+    {
+        Handler &handler;
+
+    public:
+        explicit TransientAdapter(Handler &handler_) :
+            handler(handler_)
+        {
+        }
+
+        void Null() { handler.Null(); }
+        void Bool(const bool value) { handler.Bool(value); }
+        void Number(const double value) { handler.Number(value); }
+        void Int64(const std::int64_t value) { handler.Int64(value); }
+        void UInt64(const std::uint64_t value) { handler.UInt64(value); }
+        void String(const StringView &str, bool) { handler.String(str, true); }
+        void Key(const StringView &key, bool) { handler.Key(key, true); }
+        void StartArray() { handler.StartArray(); }
+        void EndArray(const std::size_t count) { handler.EndArray(count); }
+        void StartObject() { handler.StartObject(); }
+        void EndObject(const std::size_t count) { handler.EndObject(count); }
+    };
+
+    // The buffer is copied to take the CharPtr path, so no string outlives
+    // the call: all of them are reported as transient.
+    template <class Handler>
+    void Parse(const char *const pData, const std::size_t length, Handler &handler, const ParseOptions &options = ParseOptions())
+    {
+        if( length > options.maxInputBytes )
+            throw std::runtime_error("input too large");
+
+        const std::string buffer(pData, length);
+        TransientAdapter<Handler> transient(handler);
+        Parse(buffer, transient, options);
+    }
+
+    // Parses a mutable buffer in place. Strings reach the handler as views
+    // of the buffer, never as transient ones, so they stay valid as long as
+    // it does. pData[length] must be the null terminator.
+    template <class Handler>
+    void ParseInSitu(InSituCharPtr &stream, Handler &handler, const ParseOptions &options = ParseOptions())
+    {
+        String scratch;
+        Reader<InSituCharPtr>::ReadValue(stream, handler, scratch, options);
+    }
+
+    template <class Handler>
+    void ParseInSitu(char *const pData, const std::size_t length, Handler &handler, const ParseOptions &options = ParseOptions())
+    {
+        InSituCharPtr stream(pData, pData + length);
+        ParseInSitu(stream, handler, options);
+        Reader<InSituCharPtr>::ReadEnd(stream);
+    }
+
+    template <class Handler>
+    void ParseInSitu(char *const pStr, Handler &handler, const ParseOptions &options = ParseOptions())
+    {
+        ParseInSitu(pStr, std::strlen(pStr), handler, options);
+    }
+
+    // Outcome of Validate. On failure, offset is the position of the first
+    // offending byte and pMessage a static description.
+    struct ValidateResult
+    {
+        bool ok;
+        std::size_t offset;
+        const char *pMessage;
+
+        explicit operator bool() const
+        {
+            return ok;
+        }
+    };
+
+    // Classifies input 64 bytes at a time into bit masks and finds the
+    // bytes inside strings, carrying escapes and open strings from one block
+    // to the next. Validate and the element index of ArrayDocument use it.
+    class BlockScanner
+    {
+    public:
+        // Bit i describes byte i of a 64-byte block.
+        struct Masks
+        {
+            std::uint64_t quote;
+            std::uint64_t backslash;
+            std::uint64_t structural;
+            std::uint64_t whitespace;
+            std::uint64_t control;
+            std::uint64_t nonAscii;
+            std::uint64_t digit;
+        };
+
+        using ClassifyFunc = void (*)(const char *, Masks &);
+
+    private:
+        std::uint64_t escapeCarry;
+        std::uint64_t stringCarry;
+
+        static void ClassifyScalar(const char *const pBlock, Masks &masks)
+        {
+            masks = Masks();
+
+            for( unsigned i = 0; i < 64; ++i )
+            {
+                const std::uint64_t bit = std::uint64_t(1) << i;
+                const unsigned char ch = static_cast<unsigned char>(pBlock[i]);
+
+                switch( ch )
+                {
+                    case '"': masks.quote |= bit; break;
+                    case '\\': masks.backslash |= bit; break;
+
+                    case '[': case ']': case '{': case '}': case ':': case ',':
+                        masks.structural |= bit;
+                        break;
+
+                    case ' ': case '\t': case '\n': case '\r':
+                        masks.whitespace |= bit;
+                        break;
+                }
+
+                if( ch < 0x20 )
+                    masks.control |= bit;
+                else if( ch >= 0x80 )
+                    masks.nonAscii |= bit;
+                else if( ch >= '0' && ch <= '9' )
+                    masks.digit |= bit;
+            }
+        }
+
+#ifdef TinyJson_X64
+        static std::uint64_t Mask(const __m128i bytes, const unsigned shift)
+        {
+            return static_cast<std::uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(bytes))) << shift;
+        }
+
+        static void ClassifySse2(const char *const pBlock, Masks &masks)
+        {
+            masks = Masks();
+
+            for( unsigned shift = 0; shift < 64; shift += 16 )
+            {
+                const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pBlock + shift));
+
+                // '[' and ']' differ from '{' and '}' only in bit 5.
+                const __m128i folded = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+                const __m128i brackets = _mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')), _mm_cmpeq_epi8(folded, _mm_set1_epi8('}')));
+                const __m128i separators = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(':')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')));
+
+                const __m128i space = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))),
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r'))));
+
+                masks.quote |= Mask(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')), shift);
+                masks.backslash |= Mask(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\')), shift);
+                masks.structural |= Mask(_mm_or_si128(brackets, separators), shift);
+                masks.whitespace |= Mask(space, shift);
+                masks.control |= Mask(_mm_cmpeq_epi8(_mm_min_epu8(chunk, _mm_set1_epi8(0x1F)), chunk), shift);
+                masks.nonAscii |= Mask(chunk, shift);
+
+                const __m128i digit = _mm_sub_epi8(chunk, _mm_set1_epi8('0'));
+                masks.digit |= Mask(_mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit), shift);
+            }
+        }
+
+        TinyJson_TargetAvx2 static std::uint64_t Mask(const __m256i bytes, const unsigned shift)
+        {
+            return static_cast<std::uint64_t>(static_cast<unsigned>(_mm256_movemask_epi8(bytes))) << shift;
+        }
+
+        TinyJson_TargetAvx2 static void ClassifyAvx2(const char *const pBlock, Masks &masks)
+        {
+            masks = Masks();
+
+            for( unsigned shift = 0; shift < 64; shift += 32 )
+            {
+                const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pBlock + shift));
+
+                const __m256i folded = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+                const __m256i brackets = _mm256_or_si256(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}')));
+                const __m256i separators = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(',')));
+
+                const __m256i space = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t'))),
+                    _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r'))));
+
+                masks.quote |= Mask(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"')), shift);
+                masks.backslash |= Mask(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\')), shift);
+                masks.structural |= Mask(_mm256_or_si256(brackets, separators), shift);
+                masks.whitespace |= Mask(space, shift);
+                masks.control |= Mask(_mm256_cmpeq_epi8(_mm256_min_epu8(chunk, _mm256_set1_epi8(0x1F)), chunk), shift);
+                masks.nonAscii |= Mask(chunk, shift);
+
+                const __m256i digit = _mm256_sub_epi8(chunk, _mm256_set1_epi8('0'));
+                masks.digit |= Mask(_mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit), shift);
+            }
+        }
+#endif
+
+    public:
+        static ClassifyFunc SelectClassify()
+        {
+#ifdef TinyJson_X64
+            if( CpuHasAvx2() )
+                return &ClassifyAvx2;
+
+            return &ClassifySse2;
+#else
+            return &ClassifyScalar;
+#endif
+        }
+
+        // Sets bit i when the quote at i or earlier opens a string that is
+        // still open at i.
+        static std::uint64_t PrefixXor(std::uint64_t bits)
+        {
+            bits ^= bits << 1;
+            bits ^= bits << 2;
+            bits ^= bits << 4;
+            bits ^= bits << 8;
+            bits ^= bits << 16;
+            bits ^= bits << 32;
+
+            return bits;
+        }
+
+        // Returns the bytes escaped by a backslash; escapes receives the
+        // backslashes that start an escape. Within a run of backslashes
+        // every other one escapes the next, which the subtraction resolves
+        // for all runs of the block at once.
+        std::uint64_t FindEscaped(const std::uint64_t backslash, std::uint64_t &escapes)
+        {
+            const std::uint64_t oddBits = 0xAAAAAAAAAAAAAAAAull;
+            const std::uint64_t potential = backslash & ~escapeCarry;
+            const std::uint64_t codes = (((potential << 1) | oddBits) - potential) ^ oddBits;
+
+            const std::uint64_t escaped = codes ^ (backslash | escapeCarry);
+            escapes = codes & backslash;
+            escapeCarry = escapes >> 63;
+
+            return escaped;
+        }
+
+        // Returns the bytes inside strings, opening quotes included; quotes
+        // receives the unescaped quotes.
+        std::uint64_t FindStrings(const Masks &masks, const std::uint64_t escaped, std::uint64_t &quotes)
+        {
+            quotes = masks.quote & ~escaped;
+
+            const std::uint64_t inString = PrefixXor(quotes) ^ stringCarry;
+            stringCarry = 0 - (inString >> 63);
+
+            return inString;
+        }
+
+        // Calls scan(pBlock, length, masks) for each block of [begin, end)
+        // until it returns false. The last partial block is classified
+        // padded with whitespace.
+        template <class Scan>
+        static bool ForEachBlock(const char *const begin, const char *const end, Scan scan)
+        {
+            static const ClassifyFunc classify = SelectClassify();
+            char tail[64];
+
+            for( const char *pBlock = begin; pBlock != end; )
+            {
+                const std::size_t length = std::min<std::size_t>(64, static_cast<std::size_t>(end - pBlock));
+
+                Masks masks;
+                if( length == 64 )
+                {
+                    classify(pBlock, masks);
+                }
+                else
+                {
+                    std::memset(tail, ' ', sizeof(tail));
+                    std::memcpy(tail, pBlock, length);
+                    classify(tail, masks);
+                }
+
+                if( !scan(pBlock, length, masks) )
+                    return false;
+
+                pBlock += length;
+            }
+
+            return true;
+        }
+
+        explicit BlockScanner() :
+            escapeCarry(0),
+            stringCarry(0)
+        {
+        }
+
+        void Reset()
+        {
+            escapeCarry = 0;
+            stringCarry = 0;
+        }
+
+        bool InString() const
+        {
+            return stringCarry != 0;
+        }
+    };
+
+    // Checks well-formedness without building anything or allocating. It
+    // follows the grammar Read implements and also requires strings to be
+    // valid UTF-8. Duplicate keys and numbers beyond the range of a double
+    // are not detected; they are only rejected when a tree is built.
+    //
+    // The input is classified 64 bytes at a time into bit masks, from which
+    // escapes, string interiors and token starts are derived without a
+    // per-byte branch. The grammar is then checked on the tokens only, with
+    // nesting tracked in a fixed bit stack of MaxDepth levels.
+    class Validator
+    {
+    public:
+        static const std::size_t MaxDepth = 1024;
+
+    private:
+        // What the next token may be.
+        enum class State : std::uint8_t
+        {
+            Value,
+            ArrayFirst,
+            ArrayValue,
+            ArrayNext,
+            ObjectFirst,
+            Key,
+            Colon,
+            ObjectValue,
+            ObjectNext,
+            Done
+        };
+
+        const char *const begin;
+        const char *const end;
+        const char *pError;
+        const char *pMessage;
+        State state;
+        std::size_t depth;
+        std::uint64_t objects[MaxDepth / 64];
+
+        // Carried from one block to the next
+        BlockScanner scanner;
+        std::uint64_t scalarCarry;
+        const char *pUtf8;
+        const char *pLowSurrogate;
+
+        static bool IsDigit(const char ch)
+        {
+            return ch >= '0' && ch <= '9';
+        }
+
+        static bool IsDelimiter(const char ch)
+        {
+            switch( ch )
+            {
+                case ' ': case '\t': case '\n': case '\r':
+                case '[': case ']': case '{': case '}': case ':': case ',':
+                case '"':
+                    return true;
+            }
+
+            return false;
+        }
+
+        bool Fail(const char *const pError_, const char *const pMessage_)
+        {
+            pError = pError_;
+            pMessage = pMessage_;
+            return false;
+        }
+
+        // Keeps the earliest error found while scanning a block.
+        void Defer(const char *const pError_, const char *const pMessage_)
+        {
+            if( !pError || pError_ < pError )
+            {
+                pError = pError_;
+                pMessage = pMessage_;
+            }
+        }
+
+        void CheckEscape(const char *ptr)
+        {
+            if( ++ptr == end )
+                return Defer(ptr, "'\"' expected");
+
+            switch( *ptr )
+            {
+                case '"':
+                case '\\':
+                case '/':
+                case 'b':
+                case 'f':
+                case 'n':
+                case 'r':
+                case 't':
+                    return;
+
+                case 'u':
+                {
+                    unsigned code;
+                    if( !ReadHexDigits(ptr, code) )
+                        return;
+
+                    if( code < 0xD800 || code > 0xDFFF )
+                        return;
+
+                    // The low half of a pair was checked with its high half.
+                    if( code >= 0xDC00 )
+                    {
+                        if( ptr - 5 != pLowSurrogate )
+                            Defer(ptr - 5, "unpaired surrogate in \\u escape");
+
+                        return;
+                    }
+
+                    const char *pLow = ptr + 2;
+                    unsigned low;
+                    if( end - ptr < 3 || ptr[1] != '\\' || *pLow != 'u' || !ReadHexDigits(pLow, low) || low < 0xDC00 || low > 0xDFFF )
+                        return Defer(ptr - 5, "unpaired surrogate in \\u escape");
+
+                    pLowSurrogate = ptr + 1;
+                    return;
+                }
+            }
+
+            Defer(ptr, "unrecognized character escape sequence");
+        }
+
+        // Reads the digits after the 'u' at ptr, leaving ptr on the last one.
+        bool ReadHexDigits(const char *&ptr, unsigned &code)
+        {
+            code = 0;
+            for( int i = 0; i < 4; ++i )
+            {
+                if( ++ptr == end || !std::isxdigit(static_cast<unsigned char>(*ptr)) )
+                {
+                    Defer(ptr, "hexadecimal digit expected");
+                    return false;
+                }
+
+                const char ch = static_cast<char>(*ptr | 0x20);
+                code = code << 4 | static_cast<unsigned>(ch <= '9' ? ch - '0' : ch - 'a' + 10);
+            }
+
+            return true;
+        }
+
+        bool ExpectDigit(const char *const ptr)
+        {
+            return (ptr != end && IsDigit(*ptr)) || Fail(ptr, "digit expected");
+        }
+
+        const char *SkipDigits(const char *ptr) const
+        {
+            while( ptr != end && IsDigit(*ptr) )
+                ++ptr;
+
+            return ptr;
+        }
+
+        bool EndScalar(const char *const ptr)
+        {
+            return ptr == end || IsDelimiter(*ptr) || Fail(ptr, "Invalid format");
+        }
+
+        bool ValidateNumber(const char *ptr)
+        {
+            if( *ptr == '-' )
+                ++ptr;
+
+            if( !ExpectDigit(ptr) )
+                return false;
+
+            if( *ptr == '0' )
+            {
+                if( ++ptr != end && IsDigit(*ptr) )
+                    return Fail(ptr, "leading zeros are not allowed");
+            }
+            else
+            {
+                ptr = SkipDigits(ptr);
+            }
+
+            if( ptr != end && *ptr == '.' )
+            {
+                if( !ExpectDigit(++ptr) )
+                    return false;
+
+                ptr = SkipDigits(ptr);
+            }
+
+            if( ptr != end && (*ptr == 'e' || *ptr == 'E') )
+            {
+                if( ++ptr != end && (*ptr == '+' || *ptr == '-') )
+                    ++ptr;
+
+                if( !ExpectDigit(ptr) )
+                    return false;
+
+                ptr = SkipDigits(ptr);
+            }
+
+            return EndScalar(ptr);
+        }
+
+        // Number of set bits from index upwards; a clear bit must follow.
+        static unsigned RunLength(const std::uint64_t bits, const unsigned index)
+        {
+            return CountTrailingZeros64(~bits >> index);
+        }
+
+        // Checks a number that ends before the end of its block with the
+        // digit mask, so runs of digits are skipped without a loop.
+        bool ValidateNumber(const char *const pBlock, unsigned index, const std::uint64_t digits, const unsigned last)
+        {
+            if( pBlock[index] == '-' )
+                ++index;
+
+            unsigned next = index + RunLength(digits, index);
+            if( next == index )
+                return Fail(pBlock + index, "digit expected");
+
+            if( pBlock[index] == '0' && next != index + 1 )
+                return Fail(pBlock + index + 1, "leading zeros are not allowed");
+
+            if( next != last && pBlock[next] == '.' )
+            {
+                index = next + 1;
+                next = index + RunLength(digits, index);
+                if( next == index )
+                    return Fail(pBlock + index, "digit expected");
+            }
+
+            if( next != last && (pBlock[next] == 'e' || pBlock[next] == 'E') )
+            {
+                index = next + 1;
+                if( index != last && (pBlock[index] == '+' || pBlock[index] == '-') )
+                    ++index;
+
+                next = index + RunLength(digits, index);
+                if( next == index )
+                    return Fail(pBlock + index, "digit expected");
+            }
+
+            return next == last || Fail(pBlock + next, "Invalid format");
+        }
+
+        template <std::size_t N>
+        bool ValidateLiteral(const char *ptr, const char(&pStr)[N])
+        {
+            for( std::size_t i = 0; i < N - 1; ++i, ++ptr )
+                if( ptr == end || *ptr != pStr[i] )
+                    return Fail(ptr, "Invalid format");
+
+            return EndScalar(ptr);
+        }
+
+        void Open(std::size_t &level, const bool object)
+        {
+            const std::uint64_t bit = std::uint64_t(1) << (level % 64);
+            if( object )
+                objects[level / 64] |= bit;
+            else
+                objects[level / 64] &= ~bit;
+
+            ++level;
+        }
+
+        State Close(std::size_t &level) const
+        {
+            if( --level == 0 )
+                return State::Done;
+
+            const bool object = (objects[(level - 1) / 64] >> ((level - 1) % 64) & 1) != 0;
+            return object ? State::ObjectNext : State::ArrayNext;
+        }
+
+        // Advances the grammar over the tokens of a block: structural
+        // characters, opening quotes of strings and first bytes of scalars.
+        bool ValidateTokens(const char *const pBlock, std::uint64_t tokens, const std::uint64_t scalar, const std::uint64_t digits)
+        {
+            State current = state;
+            std::size_t level = depth;
+
+            for( ; tokens != 0; tokens &= tokens - 1 )
+            {
+                const unsigned index = CountTrailingZeros64(tokens);
+                const char *const ptr = pBlock + index;
+                const char ch = *ptr;
+
+                State after;
+                switch( current )
+                {
+                    case State::Value:
+                        after = State::Done;
+                        break;
+
+                    case State::ArrayFirst:
+                        if( ch == ']' )
+                        {
+                            current = Close(level);
+                            continue;
+                        }
+
+                        after = State::ArrayNext;
+                        break;
+
+                    case State::ArrayValue:
+                        after = State::ArrayNext;
+                        break;
+
+                    case State::ArrayNext:
+                        if( ch == ',' )
+                        {
+                            current = State::ArrayValue;
+                            continue;
+                        }
+
+                        if( ch != ']' )
+                            return Fail(ptr, "']' expected");
+
+                        current = Close(level);
+                        continue;
+
+                    case State::ObjectFirst:
+                        if( ch == '}' )
+                        {
+                            current = Close(level);
+                            continue;
+                        }
+
+                        // fall through
+                    case State::Key:
+                        if( ch != '"' )
+                            return Fail(ptr, "string expected");
+
+                        current = State::Colon;
+                        continue;
+
+                    case State::Colon:
+                        if( ch != ':' )
+                            return Fail(ptr, "':' expected");
+
+                        current = State::ObjectValue;
+                        continue;
+
+                    case State::ObjectValue:
+                        after = State::ObjectNext;
+                        break;
+
+                    case State::ObjectNext:
+                        if( ch == ',' )
+                        {
+                            current = State::Key;
+                            continue;
+                        }
+
+                        if( ch != '}' )
+                            return Fail(ptr, "'}' expected");
+
+                        current = Close(level);
+                        continue;
+
+                    default:
+                        return Fail(ptr, "unexpected trailing characters");
+                }
+
+                // A value starts here.
+                switch( ch )
+                {
+                    case '"':
+                        break;
+
+                    case '[':
+                    case '{':
+                        if( level == MaxDepth )
+                            return Fail(ptr, "maximum nesting depth exceeded");
+
+                        Open(level, ch == '{');
+                        current = ch == '{' ? State::ObjectFirst : State::ArrayFirst;
+                        continue;
+
+                    case '-':
+                    case TinyJson_Digits_0_9:
+                    {
+                        // Numbers that run into the next block are checked
+                        // byte by byte.
+                        const std::uint64_t rest = ~scalar >> index;
+                        if( rest != 0 ? !ValidateNumber(pBlock, index, digits, index + CountTrailingZeros64(rest)) : !ValidateNumber(ptr) )
+                            return false;
+                    }
+                    break;
+
+                    case 't':
+                        if( !ValidateLiteral(ptr, "true") )
+                            return false;
+                        break;
+
+                    case 'f':
+                        if( !ValidateLiteral(ptr, "false") )
+                            return false;
+                        break;
+
+                    case 'n':
+                        if( !ValidateLiteral(ptr, "null") )
+                            return false;
+                        break;
+
+                    default:
+                        return Fail(ptr, "Invalid format");
+                }
+
+                current = after;
+            }
+
+            state = current;
+            depth = level;
+            return true;
+        }
+
+        bool ValidateBlock(const char *const pBlock, const std::size_t length, const BlockScanner::Masks &masks)
+        {
+            std::uint64_t escapes;
+            const std::uint64_t escaped = scanner.FindEscaped(masks.backslash, escapes);
+
+            std::uint64_t quotes;
+            const std::uint64_t inString = scanner.FindStrings(masks, escaped, quotes);
+
+            // Errors inside strings are collected first and reported unless
+            // the grammar fails on an earlier token.
+            pError = nullptr;
+
+            const std::uint64_t control = masks.control & inString;
+            if( control != 0 )
+                Defer(pBlock + CountTrailingZeros64(control), "invalid control character in string");
+
+            // \" and \\ are known valid from the masks; only the rest are looked at.
+            const std::uint64_t checked = escapes & inString & ~((masks.quote | masks.backslash) >> 1);
+            for( std::uint64_t bits = checked; bits != 0; bits &= bits - 1 )
+                CheckEscape(pBlock + CountTrailingZeros64(bits));
+
+            if( masks.nonAscii != 0 )
+            {
+                const char *ptr = std::max(pUtf8, pBlock);
+                if( !Utf8Validator::Check(ptr, pBlock + length, end) )
+                    Defer(ptr, "invalid UTF-8");
+
+                pUtf8 = ptr;
+            }
+
+            const std::uint64_t scalar = ~(masks.whitespace | masks.structural | quotes | inString);
+            std::uint64_t tokens = (masks.structural & ~inString) | (quotes & inString) | (scalar & ~(scalar << 1 | scalarCarry));
+            scalarCarry = scalar >> 63;
+
+            const char *const pDeferred = pError;
+            if( pDeferred && pDeferred - pBlock < 64 )
+                tokens &= (std::uint64_t(1) << (pDeferred - pBlock)) - 1;
+
+            if( !ValidateTokens(pBlock, tokens, scalar, masks.digit) )
+                return false;
+
+            return !pDeferred || Fail(pDeferred, pMessage);
+        }
+
+        bool Run()
+        {
+            const bool scanned = BlockScanner::ForEachBlock(begin, end, [this](const char *const pBlock, const std::size_t length, const BlockScanner::Masks &masks)
+            {
+                return ValidateBlock(pBlock, length, masks);
+            });
+
+            if( !scanned )
+                return false;
+
+            if( scanner.InString() )
+                return Fail(end, "'\"' expected");
+
+            return state == State::Done || Fail(end, "unexpected end of input");
+        }
+
+    public:
+        explicit Validator(const char *const begin_, const char *const end_) :
+            begin(begin_),
+            end(end_)
+        {
+        }
+
+        Validator(const Validator &) =delete;
+        Validator &operator =(const Validator &) =delete;
+
+        ValidateResult Validate()
+        {
+            pError = nullptr;
+            pMessage = nullptr;
+            state = State::Value;
+            depth = 0;
+            scanner.Reset();
+            scalarCarry = 0;
+            pUtf8 = begin;
+            pLowSurrogate = nullptr;
+
+            if( Run() )
+                return ValidateResult{ true, 0, nullptr };
+
+            return ValidateResult{ false, static_cast<std::size_t>(pError - begin), pMessage };
+        }
+    };
+
+    inline ValidateResult Validate(const char *const begin, const char *const end)
+    {
+        return Validator(begin, end).Validate();
+    }
+
+    inline ValidateResult Validate(const char *const pStr)
+    {
+        return Validate(pStr, pStr + std::strlen(pStr));
+    }
+
+    inline ValidateResult Validate(const std::string &str)
+    {
+        return Validate(str.data(), str.data() + str.size());
+    }
+
+#ifdef TinyJson_HasStringView
+    inline ValidateResult Validate(const std::string_view &str)
+    {
+        return Validate(str.data(), str.data() + str.size());
+    }
+#endif
+
+    enum class FeedResult
+    {
+        NeedMoreData,
+        Complete
+    };
+
+    // Incremental parser for input that arrives in chunks. All state lives
+    // in the object, so a token split across Feed calls resumes where it
+    // stopped. Every string is reported as transient. Limits in
+    // ParseOptions apply as in Read; a string is checked while it is
+    // buffered, so an over-long one fails before it is complete.
+    template <class Handler>
+    class PushParser : private Reader<CharPtr>
+    {
+        enum class State : std::uint8_t
+        {
+            Value,
+            ArrayFirst,
+            ObjectFirst,
+            ObjectKey,
+            Colon,
+            AfterValue,
+            String,
+            Escape,
+            Number,
+            Literal,
+            Done
+        };
+
+        Handler &handler;
+        ParseOptions options;
+        State state;
+        ContainerStack stack;
+        std::string token;
+        std::string escape;
+        bool stringIsKey;
+        char literal;
+        const char *pLiteral;
+        std::size_t nodes;
+        std::size_t inputBytes;
+
+        static bool IsNumberChar(const char ch)
+        {
+            return IsDigit(ch) || ch == '-' || ch == '+' || ch == '.' || ch == 'e' || ch == 'E';
+        }
+
+        void ValueDone()
+        {
+            if( stack.Empty() )
+            {
+                state = State::Done;
+                return;
+            }
+
+            ++stack.Top().count;
+            state = State::AfterValue;
+        }
+
+        void AppendEscape(const char *const pEscape, const std::size_t length)
+        {
+            CharItr<const char *> itr(pEscape, pEscape + length);
+            DecodeEscape(itr, token);
+            CheckLength(StringView(token), options);
+        }
+
+        void EndString(const StringView &str)
+        {
+            CheckLength(str, options);
+
+            if( !Utf8Validator::IsValid(str.data(), str.data() + str.size()) )
+                throw std::runtime_error("invalid UTF-8");
+
+            if( stringIsKey )
+            {
+                handler.Key(str, true);
+                state = State::Colon;
+                return;
+            }
+
+            handler.String(str, true);
+            ValueDone();
+        }
+
+        const char *BeginString(const bool isKey, const char *const ptr, const char *const end)
+        {
+            stringIsKey = isKey;
+
+            const char *const special = StringScanner::Find(ptr, end);
+            if( special != end && *special == '"' )
+            {
+                EndString(StringView(ptr, static_cast<std::size_t>(special - ptr)));
+                return special + 1;
+            }
+
+            token.clear();
+            state = State::String;
+
+            return ptr;
+        }
+
+        const char *ContinueString(const char *ptr, const char *const end)
+        {
+            for( ;; )
+            {
+                const char *const special = StringScanner::Find(ptr, end);
+                token.append(ptr, special);
+                CheckLength(StringView(token), options);
+
+                if( special == end )
+                    return end;
+
+                switch( *special )
+                {
+                    case '"':
+                        EndString(StringView(token));
+                        return special + 1;
+
+                    case '\\':
+                    {
+                        const char *const pEscape = special + 1;
+                        const std::size_t available = static_cast<std::size_t>(end - pEscape);
+                        const std::size_t length = EscapeLength(pEscape, available);
+
+                        if( available < length )
+                        {
+                            escape.assign(pEscape, end);
+                            state = State::Escape;
+                            return end;
+                        }
+
+                        AppendEscape(pEscape, length);
+                        ptr = pEscape + length;
+                        break;
+                    }
+
+                    default:
+                        throw std::runtime_error("invalid control character in string");
+                }
+            }
+        }
+
+        void FinishNumber()
+        {
+            CharPtr stream(token.data(), token.data() + token.size());
+            ReadNumber(stream, handler);
+
+            if( stream.Ptr() != stream.End() )
+                throw std::runtime_error("Invalid format");
+
+            ValueDone();
+        }
+
+        const char *ContinueNumber(const char *ptr, const char *const end)
+        {
+            const char *const start = ptr;
+            while( ptr != end && IsNumberChar(*ptr) )
+                ++ptr;
+
+            token.append(start, ptr);
+
+            if( ptr != end )
+                FinishNumber();
+
+            return ptr;
+        }
+
+        void FinishLiteral()
+        {
+            switch( literal )
+            {
+                case 't': handler.Bool(true); break;
+                case 'f': handler.Bool(false); break;
+                default: handler.Null(); break;
+            }
+
+            ValueDone();
+        }
+
+        void Close(const char ch)
+        {
+            const ContainerStack::Frame frame = stack.Top();
+            if( !frame.object && ch != ']' )
+                throw std::runtime_error("']' expected");
+
+            if( frame.object && ch != '}' )
+                throw std::runtime_error("'}' expected");
+
+            stack.Pop();
+
+            if( frame.object )
+                handler.EndObject(frame.count);
+            else
+                handler.EndArray(frame.count);
+
+            ValueDone();
+        }
+
+        const char *BeginValue(const char ch, const char *const ptr, const char *const end)
+        {
+            if( ++nodes > options.maxNodes )
+                throw std::runtime_error("too many values");
+
+            switch( ch )
+            {
+                case '"':
+                    return BeginString(false, ptr, end);
+
+                case '[':
+                    CheckDepth(stack, options);
+                    handler.StartArray();
+                    stack.Push(false);
+                    state = State::ArrayFirst;
+                    return ptr;
+
+                case '{':
+                    CheckDepth(stack, options);
+                    handler.StartObject();
+                    stack.Push(true);
+                    state = State::ObjectFirst;
+                    return ptr;
+
+                case '-':
+                case TinyJson_Digits_0_9:
+                    token.assign(1, ch);
+                    state = State::Number;
+                    return ptr;
+
+                case 't':
+                case 'f':
+                case 'n':
+                    literal = ch;
+                    pLiteral = ch == 't' ? "rue" : ch == 'f' ? "alse" : "ull";
+                    state = State::Literal;
+                    return ptr;
+            }
+
+            throw std::runtime_error("Invalid format");
+        }
+
+        const char *ReadStructural(const char ch, const char *const ptr, const char *const end)
+        {
+            switch( state )
+            {
+                case State::Value:
+                    return BeginValue(ch, ptr, end);
+
+                case State::ArrayFirst:
+                    if( ch == ']' )
+                    {
+                        Close(ch);
+                        return ptr;
+                    }
+
+                    return BeginValue(ch, ptr, end);
+
+                case State::ObjectFirst:
+                    if( ch == '}' )
+                    {
+                        Close(ch);
+                        return ptr;
+                    }
+
+                    if( ch != '"' )
+                        throw std::runtime_error("string expected");
+
+                    return BeginString(true, ptr, end);
+
+                case State::ObjectKey:
+                    if( ch != '"' )
+                        throw std::runtime_error("string expected");
+
+                    return BeginString(true, ptr, end);
+
+                case State::Colon:
+                    if( ch != ':' )
+                        throw std::runtime_error("':' expected");
+
+                    state = State::Value;
+                    return ptr;
+
+                case State::AfterValue:
+                    if( ch == ',' )
+                        state = stack.Top().object ? State::ObjectKey : State::Value;
+                    else
+                        Close(ch);
+
+                    return ptr;
+
+                default:
+                    throw std::runtime_error("unexpected trailing characters");
+            }
+        }
+
+    public:
+        explicit PushParser(Handler &handler_, const ParseOptions &options_ = ParseOptions()) :
+            handler(handler_),
+            options(options_),
+            state(State::Value),
+            stringIsKey(false),
+            literal(0),
+            pLiteral(nullptr),
+            nodes(0),
+            inputBytes(0)
+        {
+        }
+
+        PushParser(const PushParser &) =delete;
+        void operator =(const PushParser &) =delete;
+
+        FeedResult Feed(const char *const pData, const std::size_t length)
+        {
+            if( length > options.maxInputBytes - inputBytes )
+                throw std::runtime_error("input too large");
+
+            inputBytes += length;
+
+            const char *ptr = pData;
+            const char *const end = pData + length;
+
+            while( ptr != end )
+            {
+                switch( state )
+                {
+                    case State::String:
+                        ptr = ContinueString(ptr, end);
+                        break;
+
+                    case State::Escape:
+                        escape.push_back(*ptr++);
+                        if( escape.size() >= EscapeLength(escape.data(), escape.size()) )
+                        {
+                            AppendEscape(escape.data(), escape.size());
+                            state = State::String;
+                        }
+                        break;
+
+                    case State::Number:
+                        ptr = ContinueNumber(ptr, end);
+                        break;
+
+                    case State::Literal:
+                        if( *ptr++ != *pLiteral++ )
+                            throw std::runtime_error("Invalid format");
+
+                        if( *pLiteral == 0 )
+                            FinishLiteral();
+
+                        break;
+
+                    default:
+                    {
+                        const char ch = *ptr++;
+                        if( !IsWhitespace(ch) )
+                            ptr = ReadStructural(ch, ptr, end);
+                    }
+                    break;
+                }
+            }
+
+            return state == State::Done ? FeedResult::Complete : FeedResult::NeedMoreData;
+        }
+
+        // Signals the end of input; a trailing top-level number completes here.
+        void Finish()
+        {
+            if( state == State::Number && stack.Empty() )
+                FinishNumber();
+
+            if( state != State::Done )
+                throw std::runtime_error("unexpected end of input");
+        }
+
+        bool IsComplete() const
+        {
+            return state == State::Done;
+        }
+
+        void Reset()
+        {
+            state = State::Value;
+            stack.Clear();
+            token.clear();
+            nodes = 0;
+            inputBytes = 0;
+        }
+    };
+
+    // Owns every node, string and container of a parsed tree in a single
+    // arena, so the whole document is released in one step.
+    class Document
+    {
+        Arena arena;
+        Value root;
+        std::unique_ptr<InputFile> file;
+        std::shared_ptr<KeyPool> keyPool;
+        ParseOptions options;
+
+        template <class Stream>
+        void ParseStream(Stream &stream, const bool referenceInput = false)
+        {
+            root = Value::MakeNull();
+            arena.Clear();
+            file.reset();
+
+            DocumentBuilder builder(arena, referenceInput, keyPool.get());
+            String scratch;
+
+            Reader<Stream>::ReadValue(stream, builder, scratch, options);
+            Reader<Stream>::ReadEnd(stream);
+            root = builder.Root();
+        }
+
+    public:
+        explicit Document() :
+            root(Value::MakeNull())
+        {
+        }
+
+        Document(Document &&other) :
+            arena(std::move(other.arena)),
+            root(other.root),
+            file(std::move(other.file)),
+            keyPool(std::move(other.keyPool)),
+            options(other.options)
+        {
+            other.root = Value::MakeNull();
+        }
+
+        Document &operator =(Document &&other)
+        {
+            arena = std::move(other.arena);
+            root = other.root;
+            file = std::move(other.file);
+            keyPool = std::move(other.keyPool);
+            options = other.options;
+            other.root = Value::MakeNull();
+
+            return *this;
+        }
+
+        // Interns the object keys of later parses in the pool. The current
+        // contents are released, since their keys may live in the old pool.
+        void SetKeyPool(const std::shared_ptr<KeyPool> &keyPool_)
+        {
+            root = Value::MakeNull();
+            arena.Clear();
+            file.reset();
+
+            keyPool = keyPool_;
+        }
+
+        const std::shared_ptr<KeyPool> &GetKeyPool() const
+        {
+            return keyPool;
+        }
+
+        // Limits applied to later parses.
+        void SetParseOptions(const ParseOptions &options_)
+        {
+            options = options_;
+        }
+
+        const ParseOptions &GetParseOptions() const
+        {
+            return options;
+        }
+
+        template <class Itr>
+        void Parse(CharItr<Itr> &stream)
+        {
+            ParseStream(stream);
+        }
+
+        void Parse(CharPtr &stream)
+        {
+            ParseStream(stream);
+        }
+
+        template <class Itr>
+        void Parse(const Itr &begin, const Itr &end)
+        {
+            auto stream = MakeStream(begin, end);
+            Parse(stream);
+        }
+
+        void Parse(const char *const pStr)
+        {
+            auto stream = MakeStream(pStr);
+            Parse(stream);
+        }
+
+        void Parse(const std::string &str)
+        {
+            auto stream = MakeStream(str);
+            Parse(stream);
+        }
+
+        void Parse(const char *const pData, const std::size_t length)
+        {
+            if( length > options.maxInputBytes )
+                throw std::runtime_error("input too large");
+
+            const std::string buffer(pData, length);
+            Parse(buffer);
+        }
+
+        // Like Parse, but strings without escapes view the input instead of
+        // being copied. The input must outlive the document.
+        void ParseView(CharPtr &stream)
+        {
+            ParseStream(stream, true);
+        }
+
+        void ParseView(const char *const pStr)
+        {
+            auto stream = MakeStream(pStr);
+            ParseView(stream);
+        }
+
+        void ParseView(const std::string &str)
+        {
+            auto stream = MakeStream(str);
+            ParseView(stream);
+        }
+
+        void ParseView(std::string &&) =delete;
+
+        // Like ParseView, but escaped strings are decoded inside the buffer as
+        // well, so no string is copied. The buffer is overwritten, must be
+        // null-terminated at pData[length] and must outlive the document.
+        void ParseInSitu(InSituCharPtr &stream)
+        {
+            ParseStream(stream, true);
+        }
+
+        void ParseInSitu(char *const pData, const std::size_t length)
+        {
+            InSituCharPtr stream(pData, pData + length);
+            ParseInSitu(stream);
+        }
+
+        void ParseInSitu(char *const pStr)
+        {
+            ParseInSitu(pStr, std::strlen(pStr));
+        }
+
+        void ParseInSitu(std::string &str)
+        {
+            ParseInSitu(&str[0], str.size());
+        }
+
+        // Maps the file and parses it like ParseView; the document keeps the
+        // mapping alive, so unescaped strings point straight into it.
+        void ParseFile(const std::string &path)
+        {
+            std::unique_ptr<InputFile> input(new InputFile(path, options.maxInputBytes));
+            CharPtr stream(input->data(), input->data() + input->size());
+
+            ParseStream(stream, true);
+            file = std::move(input);
+        }
+
+        const Value &Root() const
+        {
+            return root;
+        }
+
+        // Bytes held by the arena.
+        std::size_t Capacity() const
+        {
+            return arena.Capacity();
+        }
+    };
+
+    // Counters of a DocumentCache since it was created or cleared.
+    struct CacheStats
+    {
+        std::size_t hits;
+        std::size_t misses;
+        std::size_t evictions;
+
+        // Documents held and the bytes charged for them.
+        std::size_t entries;
+        std::size_t bytes;
+
+        CacheStats() :
+            hits(0),
+            misses(0),
+            evictions(0),
+            entries(0),
+            bytes(0)
+        {
+        }
+    };
+
+    // Thread-safe cache of parsed documents, keyed by their input text.
+    // A repeated input costs a hash, a compare and a lookup, and every
+    // caller shares one immutable Document. Each entry keeps its input,
+    // which its document views like ParseView, and is charged for the
+    // input and the arena. The least recently used entries are evicted
+    // once the cache holds more than maxEntries or maxBytes; an input too
+    // large to fit on its own is parsed but not cached. Documents stay
+    // valid after eviction for as long as a caller holds them.
+    class DocumentCache
+    {
+        struct Parsed
+        {
+            std::string input;
+            Document document;
+        };
+
+        struct Entry
+        {
+            std::uint64_t hash;
+            std::size_t bytes;
+            std::shared_ptr<Parsed> parsed;
+        };
+
+        using List = std::list<Entry>;
+
+        mutable std::mutex mutex;
+
+        // Most recently used first.
+        List entries;
+        std::unordered_multimap<std::uint64_t, List::iterator> index;
+
+        std::size_t maxBytes;
+        std::size_t maxEntries;
+        ParseOptions options;
+        CacheStats stats;
+
+        // Bumped when the options change, so a parse that started under the
+        // old ones does not insert its document.
+        std::size_t generation;
+
+        static std::shared_ptr<const Document> Share(const std::shared_ptr<Parsed> &parsed)
+        {
+            return std::shared_ptr<const Document>(parsed, &parsed->document);
+        }
+
+        // Called with the mutex held.
+        List::iterator Find(const std::uint64_t hash, const char *const pData, const std::size_t length)
+        {
+            const auto range = index.equal_range(hash);
+
+            for( auto itr = range.first; itr != range.second; ++itr )
+            {
+                const std::string &input = itr->second->parsed->input;
+                if( input.size() == length && std::memcmp(input.data(), pData, length) == 0 )
+                    return itr->second;
+            }
+
+            return entries.end();
+        }
+
+        void Erase(const List::iterator entry)
+        {
+            const auto range = index.equal_range(entry->hash);
+
+            for( auto itr = range.first; itr != range.second; ++itr )
+            {
+                if( itr->second == entry )
+                {
+                    index.erase(itr);
+                    break;
+                }
+            }
+
+            stats.bytes -= entry->bytes;
+            --stats.entries;
+            entries.erase(entry);
+        }
+
+        void Evict()
+        {
+            while( !entries.empty() && (stats.bytes > maxBytes || stats.entries > maxEntries) )
+            {
+                Erase(std::prev(entries.end()));
+                ++stats.evictions;
+            }
+        }
+
+    public:
+        explicit DocumentCache(const std::size_t maxBytes_ = 64 * 1024 * 1024, const std::size_t maxEntries_ = std::numeric_limits<std::size_t>::max()) :
+            maxBytes(maxBytes_),
+            maxEntries(maxEntries_),
+            generation(0)
+        {
+        }
+
+        DocumentCache(const DocumentCache &) =delete;
+        void operator =(const DocumentCache &) =delete;
+
+        // Returns the cached document for the input, parsing it on a miss.
+        // Parsing runs without the lock, so other threads are not held up;
+        // when two threads miss on the same input, the first to finish
+        // inserts its document and both return that one.
+        std::shared_ptr<const Document> Parse(const char *const pData, const std::size_t length)
+        {
+            const std::uint64_t hash = HashBytes(pData, length);
+            ParseOptions parseOptions;
+            std::size_t parseGeneration;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                const auto entry = Find(hash, pData, length);
+                if( entry != entries.end() )
+                {
+                    ++stats.hits;
+                    entries.splice(entries.begin(), entries, entry);
+                    return Share(entry->parsed);
+                }
+
+                ++stats.misses;
+                parseOptions = options;
+                parseGeneration = generation;
+            }
+
+            if( length > parseOptions.maxInputBytes )
+                throw std::runtime_error("input too large");
+
+            const auto parsed = std::make_shared<Parsed>();
+            parsed->input.assign(pData, length);
+            parsed->document.SetParseOptions(parseOptions);
+            parsed->document.ParseView(parsed->input);
+
+            const std::size_t bytes = sizeof(Parsed) + parsed->input.capacity() + parsed->document.Capacity();
+
+            std::lock_guard<std::mutex> lock(mutex);
+
+            const auto entry = Find(hash, pData, length);
+            if( entry != entries.end() )
+            {
+                entries.splice(entries.begin(), entries, entry);
+                return Share(entry->parsed);
+            }
+
+            if( bytes <= maxBytes && maxEntries != 0 && parseGeneration == generation )
+            {
+                Entry added;
+                added.hash = hash;
+                added.bytes = bytes;
+                added.parsed = parsed;
+
+                entries.push_front(added);
+                index.emplace(hash, entries.begin());
+
+                stats.bytes += bytes;
+                ++stats.entries;
+                Evict();
+            }
+
+            return Share(parsed);
+        }
+
+        std::shared_ptr<const Document> Parse(const std::string &str)
+        {
+            return Parse(str.data(), str.size());
+        }
+
+        std::shared_ptr<const Document> Parse(const char *const pStr)
+        {
+            return Parse(pStr, std::strlen(pStr));
+        }
+
+#ifdef TinyJson_HasStringView
+        std::shared_ptr<const Document> Parse(const std::string_view &str)
+        {
+            return Parse(str.data(), str.size());
+        }
+#endif
+
+        // Limits applied to later parses. Cached documents are dropped, as
+        // they may break the new limits; the counters are kept.
+        void SetParseOptions(const ParseOptions &options_)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            options = options_;
+            ++generation;
+
+            entries.clear();
+            index.clear();
+            stats.bytes = 0;
+            stats.entries = 0;
+        }
+
+        ParseOptions GetParseOptions() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return options;
+        }
+
+        // Changes the budget, evicting entries at once if it shrinks.
+        void SetLimits(const std::size_t maxBytes_, const std::size_t maxEntries_)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            maxBytes = maxBytes_;
+            maxEntries = maxEntries_;
+            Evict();
+        }
+
+        CacheStats Stats() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return stats;
+        }
+
+        // Drops every entry and resets the counters.
+        void Clear()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            entries.clear();
+            index.clear();
+            stats = CacheStats();
+        }
+    };
+
+    // Tags of TapeDocument words. A word holds its tag in the top byte and a
+    // 56-bit payload below it.
+    enum class TapeTag : std::uint8_t
+    {
+        Null = 'n',
+        True = 't',
+        False = 'f',
+        Double = 'd',
+        Int64 = 'l',
+        UInt64 = 'u',
+        String = '"',
+        StartArray = '[',
+        EndArray = ']',
+        StartObject = '{',
+        EndObject = '}'
+    };
+
+    struct Tape
+    {
+        static const std::uint64_t PayloadMask = (std::uint64_t(1) << 56) - 1;
+
+        // Container counts above this are stored as this and counted on demand.
+        static const std::uint64_t MaxCount = (std::uint64_t(1) << 24) - 1;
+
+        static TapeTag Tag(const std::uint64_t word)
+        {
+            return static_cast<TapeTag>(word >> 56);
+        }
+
+        static std::uint64_t Payload(const std::uint64_t word)
+        {
+            return word & PayloadMask;
+        }
+
+        static std::uint64_t Word(const TapeTag tag, const std::uint64_t payload)
+        {
+            return static_cast<std::uint64_t>(tag) << 56 | payload;
+        }
+
+        // The index after the value at index; containers are skipped whole.
+        static std::size_t Next(const std::uint64_t *const pTape, const std::size_t index)
+        {
+            switch( Tag(pTape[index]) )
+            {
+                case TapeTag::Double:
+                case TapeTag::Int64:
+                case TapeTag::UInt64:
+                    return index + 2;
+
+                case TapeTag::StartArray:
+                case TapeTag::StartObject:
+                    return static_cast<std::size_t>(pTape[index] & 0xFFFFFFFF);
+
+                default:
+                    return index + 1;
+            }
+        }
+    };
+
+    class TapeArrayView;
+    class TapeObjectView;
+
+    // Read-only handle to a value on the tape of a TapeDocument.
+    class TapeValue
+    {
+        const std::uint64_t *pTape;
+        const char *pStrings;
+        std::size_t index;
+
+        TapeTag Tag() const
+        {
+            return Tape::Tag(pTape[index]);
+        }
+
+        template <class T>
+        T Bits() const
+        {
+            T value;
+            std::memcpy(&value, &pTape[index + 1], sizeof(value));
+            return value;
+        }
+
+    public:
+        explicit TapeValue(const std::uint64_t *const pTape_, const char *const pStrings_, const std::size_t index_) :
+            pTape(pTape_),
+            pStrings(pStrings_),
+            index(index_)
+        {
+        }
+
+        std::size_t Index() const
+        {
+            return index;
+        }
+
+        ValueType Type() const
+        {
+            switch( Tag() )
+            {
+                case TapeTag::True:
+                case TapeTag::False:
+                    return ValueType::Boolean;
+
+                case TapeTag::Double:
+                case TapeTag::Int64:
+                case TapeTag::UInt64:
+                    return ValueType::Number;
+
+                case TapeTag::String:
+                    return ValueType::String;
+
+                case TapeTag::StartArray:
+                    return ValueType::Array;
+
+                case TapeTag::StartObject:
+                    return ValueType::Object;
+
+                default:
+                    return ValueType::Null;
+            }
+        }
+
+        bool IsNull() const { return Tag() == TapeTag::Null; }
+        bool IsNumber() const { return Type() == ValueType::Number; }
+        bool IsString() const { return Tag() == TapeTag::String; }
+        bool IsArray() const { return Tag() == TapeTag::StartArray; }
+        bool IsObject() const { return Tag() == TapeTag::StartObject; }
+        bool IsBoolean() const { return Tag() == TapeTag::True || Tag() == TapeTag::False; }
+
+        bool IsInt64() const { return Tag() == TapeTag::Int64; }
+        bool IsUInt64() const { return Tag() == TapeTag::UInt64; }
+
+        Number AsNumber() const
+        {
+            switch( Tag() )
+            {
+                case TapeTag::Double: return Bits<double>();
+                case TapeTag::Int64: return static_cast<Number>(Bits<std::int64_t>());
+                case TapeTag::UInt64: return static_cast<Number>(Bits<std::uint64_t>());
+                default: throw std::runtime_error("value is not a number");
+            }
+        }
+
+        std::int64_t AsInt64() const
+        {
+            switch( Tag() )
+            {
+                case TapeTag::Double: return DoubleToInt64(Bits<double>());
+                case TapeTag::Int64: return Bits<std::int64_t>();
+                case TapeTag::UInt64: throw std::runtime_error("number is not a 64-bit integer");
+                default: throw std::runtime_error("value is not a number");
+            }
+        }
+
+        std::uint64_t AsUInt64() const
+        {
+            switch( Tag() )
+            {
+                case TapeTag::Double:
+                    return DoubleToUInt64(Bits<double>());
+
+                case TapeTag::Int64:
+                {
+                    const std::int64_t value = Bits<std::int64_t>();
+                    if( value < 0 )
+                        throw std::runtime_error("number is not an unsigned 64-bit integer");
+
+                    return static_cast<std::uint64_t>(value);
+                }
+
+                case TapeTag::UInt64:
+                    return Bits<std::uint64_t>();
+
+                default:
+                    throw std::runtime_error("value is not a number");
+            }
+        }
+
+        // Strings are stored as a 32-bit length followed by the bytes.
+        StringView AsString() const
+        {
+            if( !IsString() )
+                throw std::runtime_error("value is not a string");
+
+            const char *const pStr = pStrings + Tape::Payload(pTape[index]);
+
+            std::uint32_t length;
+            std::memcpy(&length, pStr, sizeof(length));
+
+            return StringView(pStr + sizeof(length), length);
+        }
+
+        TapeArrayView AsArray() const;
+        TapeObjectView AsObject() const;
+
+        Boolean AsBoolean() const
+        {
+            if( !IsBoolean() )
+                throw std::runtime_error("value is not a boolean");
+
+            return Tag() == TapeTag::True;
+        }
+    };
+
+    struct TapeMember
+    {
+        StringView key;
+        TapeValue value;
+    };
+
+    // The elements of a tape array. Iteration skips nested containers in
+    // constant time; indexing walks from the first element.
+    class TapeArrayView
+    {
+        const std::uint64_t *pTape;
+        const char *pStrings;
+        std::size_t first;
+        std::size_t last;
+
+    public:
+        class const_iterator
+        {
+            const std::uint64_t *pTape;
+            const char *pStrings;
+            std::size_t index;
+
+        public:
+            typedef std::input_iterator_tag iterator_category;
+            typedef TapeValue value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const TapeValue *pointer;
+            typedef TapeValue reference;
+
+            explicit const_iterator(const std::uint64_t *const pTape_, const char *const pStrings_, const std::size_t index_) :
+                pTape(pTape_),
+                pStrings(pStrings_),
+                index(index_)
+            {
+            }
+
+            TapeValue operator *() const
+            {
+                return TapeValue(pTape, pStrings, index);
+            }
+
+            const_iterator &operator ++()
+            {
+                index = Tape::Next(pTape, index);
+                return *this;
+            }
+
+            bool operator ==(const const_iterator &other) const { return index == other.index; }
+            bool operator !=(const const_iterator &other) const { return index != other.index; }
+        };
+
+        explicit TapeArrayView(const std::uint64_t *const pTape_, const char *const pStrings_, const std::size_t start) :
+            pTape(pTape_),
+            pStrings(pStrings_),
+            first(start + 1),
+            last(Tape::Next(pTape_, start) - 1)
+        {
+        }
+
+        const_iterator begin() const { return const_iterator(pTape, pStrings, first); }
+        const_iterator end() const { return const_iterator(pTape, pStrings, last); }
+
+        std::size_t size() const
+        {
+            const std::size_t count = static_cast<std::size_t>(Tape::Payload(pTape[first - 1]) >> 32);
+            if( count < Tape::MaxCount )
+                return count;
+
+            return static_cast<std::size_t>(std::distance(begin(), end()));
+        }
+
+        bool empty() const { return first == last; }
+
+        TapeValue operator [](const std::size_t index) const { return at(index); }
+
+        TapeValue at(std::size_t index) const
+        {
+            for( const TapeValue value: *this )
+            {
+                if( index-- == 0 )
+                    return value;
+            }
+
+            throw std::out_of_range("array index out of range");
+        }
+    };
+
+    // The members of a tape object in document order. Lookups compare keys
+    // while skipping values in constant time.
+    class TapeObjectView
+    {
+        const std::uint64_t *pTape;
+        const char *pStrings;
+        std::size_t first;
+        std::size_t last;
+
+    public:
+        class const_iterator
+        {
+            const std::uint64_t *pTape;
+            const char *pStrings;
+            std::size_t index;
+
+        public:
+            typedef std::input_iterator_tag iterator_category;
+            typedef TapeMember value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const TapeMember *pointer;
+            typedef TapeMember reference;
+
+            explicit const_iterator(const std::uint64_t *const pTape_, const char *const pStrings_, const std::size_t index_) :
+                pTape(pTape_),
+                pStrings(pStrings_),
+                index(index_)
+            {
+            }
+
+            TapeMember operator *() const
+            {
+                const TapeMember member = { TapeValue(pTape, pStrings, index).AsString(), TapeValue(pTape, pStrings, index + 1) };
+                return member;
+            }
+
+            const_iterator &operator ++()
+            {
+                index = Tape::Next(pTape, index + 1);
+                return *this;
+            }
+
+            bool operator ==(const const_iterator &other) const { return index == other.index; }
+            bool operator !=(const const_iterator &other) const { return index != other.index; }
+        };
+
+        explicit TapeObjectView(const std::uint64_t *const pTape_, const char *const pStrings_, const std::size_t start) :
+            pTape(pTape_),
+            pStrings(pStrings_),
+            first(start + 1),
+            last(Tape::Next(pTape_, start) - 1)
+        {
+        }
+
+        const_iterator begin() const { return const_iterator(pTape, pStrings, first); }
+        const_iterator end() const { return const_iterator(pTape, pStrings, last); }
+
+        std::size_t size() const
+        {
+            const std::size_t count = static_cast<std::size_t>(Tape::Payload(pTape[first - 1]) >> 32);
+            if( count < Tape::MaxCount )
+                return count;
+
+            return static_cast<std::size_t>(std::distance(begin(), end()));
+        }
+
+        bool empty() const { return first == last; }
+
+        // Duplicate keys are kept on the tape; the first one is found.
+        const_iterator find(const StringView &key) const
+        {
+            for( std::size_t index = first; index != last; index = Tape::Next(pTape, index + 1) )
+            {
+                if( TapeValue(pTape, pStrings, index).AsString() == key )
+                    return const_iterator(pTape, pStrings, index);
+            }
+
+            return end();
+        }
+
+        std::size_t count(const StringView &key) const
+        {
+            return find(key) != end() ? 1 : 0;
+        }
+
+        TapeValue at(const StringView &key) const
+        {
+            const auto itr = find(key);
+            if( itr == end() )
+                throw std::out_of_range("key not found: " + key.str());
+
+            return (*itr).value;
+        }
+    };
+
+    inline TapeArrayView TapeValue::AsArray() const
+    {
+        if( !IsArray() )
+            throw std::runtime_error("value is not an array");
+
+        return TapeArrayView(pTape, pStrings, index);
+    }
+
+    inline TapeObjectView TapeValue::AsObject() const
+    {
+        if( !IsObject() )
+            throw std::runtime_error("value is not an object");
+
+        return TapeObjectView(pTape, pStrings, index);
+    }
+
+    // Appends parse events to a tape and its string buffer. While a
+    // container is open its start word links to the enclosing one, so no
+    // other stack is needed; closing it stores the end index and count.
+    class TapeBuilder : public HandlerBase<TapeBuilder>
+    {
+        std::vector<std::uint64_t> &tape;
+        std::string &strings;
+        std::uint64_t open;
+
+        void Append(const TapeTag tag, const std::uint64_t payload)
+        {
+            tape.push_back(Tape::Word(tag, payload));
+        }
+
+        template <class T>
+        void AppendNumber(const TapeTag tag, const T value)
+        {
+            std::uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+
+            Append(tag, 0);
+            tape.push_back(bits);
+        }
+
+        void Start(const TapeTag tag)
+        {
+            if( tape.size() >= UINT32_MAX )
+                throw std::runtime_error("document too large");
+
+            Append(tag, open);
+            open = tape.size() - 1;
+        }
+
+        void End(const TapeTag tag, const std::size_t count)
+        {
+            const std::size_t start = static_cast<std::size_t>(open);
+            open = Tape::Payload(tape[start]);
+
+            Append(tag, start);
+
+            const std::uint64_t stored = count < Tape::MaxCount ? count : Tape::MaxCount;
+            tape[start] = Tape::Word(Tape::Tag(tape[start]), stored << 32 | tape.size());
+        }
+
+    public:
+        explicit TapeBuilder(std::vector<std::uint64_t> &tape_, std::string &strings_) :
+            tape(tape_),
+            strings(strings_),
+            open(Tape::PayloadMask)
+        {
+        }
+
+        void Null()
+        {
+            Append(TapeTag::Null, 0);
+        }
+
+        void Bool(const bool value)
+        {
+            Append(value ? TapeTag::True : TapeTag::False, 0);
+        }
+
+        void Number(const double value)
+        {
+            AppendNumber(TapeTag::Double, value);
+        }
+
+        void Int64(const std::int64_t value)
+        {
+            AppendNumber(TapeTag::Int64, value);
+        }
+
+        void UInt64(const std::uint64_t value)
+        {
+            AppendNumber(TapeTag::UInt64, value);
+        }
+
+        void String(const StringView &str, bool)
+        {
+            if( str.size() > UINT32_MAX )
+                throw std::runtime_error("value too large");
+
+            const std::uint32_t length = static_cast<std::uint32_t>(str.size());
+
+            Append(TapeTag::String, strings.size());
+            strings.append(reinterpret_cast<const char *>(&length), sizeof(length));
+            strings.append(str.data(), str.size());
+        }
+
+        void Key(const StringView &key, const bool transient)
+        {
+            String(key, transient);
+        }
+
+        void StartArray()
+        {
+            Start(TapeTag::StartArray);
+        }
+
+        void EndArray(const std::size_t count)
+        {
+            End(TapeTag::EndArray, count);
+        }
+
+        void StartObject()
+        {
+            Start(TapeTag::StartObject);
+        }
+
+        void EndObject(const std::size_t count)
+        {
+            End(TapeTag::EndObject, count);
+        }
+    };
+
+    // Immutable document stored as one tape of 64-bit words plus one string
+    // buffer, for read-mostly lookups. Values are laid out in document order
+    // and containers record where they end, so traversal is a sequential
+    // walk and siblings are skipped in constant time. Reparsing reuses both
+    // buffers.
+    class TapeDocument
+    {
+        std::vector<std::uint64_t> tape;
+        std::string strings;
+        ParseOptions options;
+
+        template <class Stream>
+        void ParseStream(Stream &stream)
+        {
+            tape.clear();
+            strings.clear();
+
+            try
+            {
+                TapeBuilder builder(tape, strings);
+                String scratch;
+
+                Reader<Stream>::ReadValue(stream, builder, scratch, options);
+                Reader<Stream>::ReadEnd(stream);
+            }
+            catch( ... )
+            {
+                tape.clear();
+                strings.clear();
+                throw;
+            }
+        }
+
+    public:
+        // Limits applied to later parses.
+        void SetParseOptions(const ParseOptions &options_)
+        {
+            options = options_;
+        }
+
+        const ParseOptions &GetParseOptions() const
+        {
+            return options;
+        }
+
+        template <class Itr>
+        void Parse(CharItr<Itr> &stream)
+        {
+            ParseStream(stream);
+        }
+
+        void Parse(CharPtr &stream)
+        {
+            ParseStream(stream);
+        }
+
+        template <class Itr>
+        void Parse(const Itr &begin, const Itr &end)
+        {
+            auto stream = MakeStream(begin, end);
+            Parse(stream);
+        }
+
+        void Parse(const char *const pStr)
+        {
+            auto stream = MakeStream(pStr);
+            Parse(stream);
+        }
+
+        void Parse(const std::string &str)
+        {
+            auto stream = MakeStream(str);
+            Parse(stream);
+        }
+
+        void Parse(const char *const pData, const std::size_t length)
+        {
+            if( length > options.maxInputBytes )
+                throw std::runtime_error("input too large");
+
+            const std::string buffer(pData, length);
+            Parse(buffer);
+        }
+
+        // Null until a parse succeeds.
+        TapeValue Root() const
+        {
+            static const std::uint64_t null = Tape::Word(TapeTag::Null, 0);
+
+            if( tape.empty() )
+                return TapeValue(&null, nullptr, 0);
+
+            return TapeValue(tape.data(), strings.data(), 0);
+        }
+
+        // Words on the tape and bytes in the string buffer.
+        std::size_t TapeSize() const
+        {
+            return tape.size();
+        }
+
+        std::size_t StringsSize() const
+        {
+            return strings.size();
+        }
+    };
+
+    // Parses document after document into the Value format of Document,
+    // keeping every buffer between calls: the arena, the builder's stacks,
+    // the string scratch and the container stack. Once they reach the
+    // working size of the input, parsing no longer allocates. The returned
+    // root stays valid until the next parse.
+    class Parser
+    {
+        Arena arena;
+        DocumentBuilder builder;
+        String scratch;
+        ContainerStack stack;
+        std::string buffer;
+        ParseOptions options;
+        std::size_t trimThreshold;
+
+        // Runs before the input is touched, since trimming frees the buffer.
+        void Prepare(const bool referenceInput)
+        {
+            if( RetainedBytes() > trimThreshold )
+                Trim();
+            else
+                arena.Rewind();
+
+            builder.Reset(referenceInput);
+        }
+
+        template <class Stream>
+        const Value &ParseStream(Stream &stream)
+        {
+            try
+            {
+                Reader<Stream>::ReadValue(stream, builder, scratch, stack, options);
+                Reader<Stream>::ReadEnd(stream);
+            }
+            catch( ... )
+            {
+                builder.Reset(false);
+                throw;
+            }
+
+            return builder.Root();
+        }
+
+    public:
+        explicit Parser() :
+            builder(arena),
+            trimThreshold(std::numeric_limits<std::size_t>::max())
+        {
+        }
+
+        Parser(const Parser &) =delete;
+        void operator =(const Parser &) =delete;
+
+        void SetParseOptions(const ParseOptions &options_)
+        {
+            options = options_;
+        }
+
+        const ParseOptions &GetParseOptions() const
+        {
+            return options;
+        }
+
+        // High-water mark for retained memory. When a document leaves more
+        // than this many bytes behind, they are released before the next
+        // parse, so one outsized message does not pin its memory forever.
+        void SetTrimThreshold(const std::size_t bytes)
+        {
+            trimThreshold = bytes;
+        }
+
+        std::size_t GetTrimThreshold() const
+        {
+            return trimThreshold;
+        }
+
+        // Bytes kept for reuse by the next parse.
+        std::size_t RetainedBytes() const
+        {
+            return arena.Capacity() + builder.Capacity() + scratch.capacity() + stack.Capacity() + buffer.capacity();
+        }
+
+        // Releases every retained buffer; the last root is invalidated.
+        void Trim()
+        {
+            arena.Clear();
+            builder.Reset(false);
+            builder.Release();
+            String().swap(scratch);
+            stack.Release();
+            std::string().swap(buffer);
+        }
+
+        template <class Itr>
+        const Value &Parse(CharItr<Itr> &stream)
+        {
+            Prepare(false);
+            return ParseStream(stream);
+        }
+
+        const Value &Parse(CharPtr &stream)
+        {
+            Prepare(false);
+            return ParseStream(stream);
+        }
+
+        template <class Itr>
+        const Value &Parse(const Itr &begin, const Itr &end)
+        {
+            auto stream = MakeStream(begin, end);
+            return Parse(stream);
+        }
+
+        const Value &Parse(const char *const pStr)
+        {
+            auto stream = MakeStream(pStr);
+            return Parse(stream);
+        }
+
+        const Value &Parse(const std::string &str)
+        {
+            auto stream = MakeStream(str);
+            return Parse(stream);
+        }
+
+        // The copy that adds the terminator is kept between calls as well.
+        const Value &Parse(const char *const pData, const std::size_t length)
+        {
+            if( length > options.maxInputBytes )
+                throw std::runtime_error("input too large");
+
+            Prepare(false);
+            buffer.assign(pData, length);
+
+            auto stream = MakeStream(buffer);
+            return ParseStream(stream);
+        }
+
+        // Like Parse, but strings without escapes view the input instead of
+        // being copied. The input must outlive the root.
+        const Value &ParseView(CharPtr &stream)
+        {
+            Prepare(true);
+            return ParseStream(stream);
+        }
+
+        const Value &ParseView(const char *const pStr)
+        {
+            auto stream = MakeStream(pStr);
+            return ParseView(stream);
+        }
+
+        const Value &ParseView(const std::string &str)
+        {
+            auto stream = MakeStream(str);
+            return ParseView(stream);
+        }
+
+        const Value &ParseView(std::string &&) =delete;
+
+        // Like ParseView, but escaped strings are decoded inside the buffer
+        // as well; see Document::ParseInSitu.
+        const Value &ParseInSitu(InSituCharPtr &stream)
+        {
+            Prepare(true);
+            return ParseStream(stream);
+        }
+
+        const Value &ParseInSitu(char *const pData, const std::size_t length)
+        {
+            InSituCharPtr stream(pData, pData + length);
+            return ParseInSitu(stream);
+        }
+
+        const Value &ParseInSitu(char *const pStr)
+        {
+            return ParseInSitu(pStr, std::strlen(pStr));
+        }
+
+        const Value &ParseInSitu(std::string &str)
+        {
+            return ParseInSitu(&str[0], str.size());
+        }
+
+        // The root of the last successful parse, or null.
+        const Value &Root() const
+        {
+            return builder.Root();
+        }
+    };
+
+    struct BatchOptions
+    {
+        // Zero uses std::thread::hardware_concurrency.
+        unsigned threadCount;
+
+        // Records parsed per window by LinesDocument::ParseEach.
+        std::size_t windowSize;
+
+        // Optional key pool; it must be frozen when more than one thread runs.
+        std::shared_ptr<KeyPool> keyPool;
+
+        // Limits for every record of LinesDocument. maxInputBytes bounds the
+        // whole input; ArrayDocument applies the limits to the array as one
+        // document, as Read does.
+        ParseOptions parseOptions;
+
+        BatchOptions() :
+            threadCount(0),
+            windowSize(65536)
+        {
+        }
+    };
+
+    // Runs fn(thread, i) for every i in [first, last) on up to threadCount
+    // threads, each taking tasks of taskSize consecutive indices. After a
+    // failure the remaining tasks are skipped, and the exception of the
+    // lowest failing index is rethrown.
+    template <class Fn>
+    void ParallelFor(const std::size_t threadCount, const std::size_t first, const std::size_t last, const std::size_t taskSize, Fn fn)
+    {
+        const std::size_t count = std::max<std::size_t>(1, std::min(threadCount, (last - first + taskSize - 1) / taskSize));
+
+        std::atomic<std::size_t> nextTask(first);
+        std::atomic<bool> failed(false);
+        std::vector<std::exception_ptr> errors(count);
+        std::vector<std::size_t> errorIndices(count, last);
+
+        auto run = [&](const std::size_t thread)
+        {
+            while( !failed.load(std::memory_order_relaxed) )
+            {
+                const std::size_t begin = nextTask.fetch_add(taskSize);
+                if( begin >= last )
+                    return;
+
+                const std::size_t end = std::min(last, begin + taskSize);
+                for( std::size_t i = begin; i < end; ++i )
+                {
+                    try
+                    {
+                        fn(thread, i);
+                    }
+                    catch( ... )
+                    {
+                        errors[thread] = std::current_exception();
+                        errorIndices[thread] = i;
+                        failed = true;
+                        return;
+                    }
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for( std::size_t i = 1; i < count; ++i )
+            threads.emplace_back(run, i);
+
+        run(0);
+
+        for( auto &thread : threads )
+            thread.join();
+
+        if( failed )
+        {
+            const std::size_t index = static_cast<std::size_t>(std::min_element(errorIndices.begin(), errorIndices.end()) - errorIndices.begin());
+            std::rethrow_exception(errors[index]);
+        }
+    }
+
+    // Per-thread state of the batch documents. Every worker owns an arena
+    // and a builder, so records are parsed without contending on the
+    // global allocator.
+    class BatchWorkers
+    {
+    public:
+        struct Worker
+        {
+            Arena arena;
+            DocumentBuilder builder;
+            std::string buffer;
+            String scratch;
+
+            explicit Worker(KeyPool *const pKeyPool) :
+                builder(arena, false, pKeyPool)
+            {
+            }
+        };
+
+    private:
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::shared_ptr<KeyPool> keyPool;
+        std::size_t threadCount;
+
+    public:
+        explicit BatchWorkers() :
+            threadCount(1)
+        {
+        }
+
+        // Readies one worker per thread for taskCount tasks, at most, and
+        // releases what the previous batch left in their arenas.
+        void Prepare(const BatchOptions &options, const std::size_t taskCount)
+        {
+            std::size_t count = options.threadCount ? options.threadCount : std::thread::hardware_concurrency();
+            if( count != 1 && options.keyPool && !options.keyPool->IsFrozen() )
+                throw std::runtime_error("key pool must be frozen to be shared between threads");
+
+            threadCount = std::max<std::size_t>(1, std::min(count, taskCount));
+
+            if( options.keyPool != keyPool )
+            {
+                workers.clear();
+                keyPool = options.keyPool;
+            }
+
+            while( workers.size() < threadCount )
+                workers.emplace_back(new Worker(keyPool.get()));
+
+            for( auto &pWorker : workers )
+                pWorker->arena.Reset();
+        }
+
+        // Runs fn(worker, i) for every i in [first, last) as ParallelFor does.
+        template <class Fn>
+        void Run(const std::size_t first, const std::size_t last, const std::size_t taskSize, Fn fn)
+        {
+            ParallelFor(threadCount, first, last, taskSize, [&](const std::size_t thread, const std::size_t i)
+            {
+                Worker &worker = *workers[thread];
+
+                try
+                {
+                    fn(worker, i);
+                }
+                catch( ... )
+                {
+                    // The builder may hold a partial tree
+                    worker.builder.Reset(false);
+                    throw;
+                }
+            });
+        }
+    };
+
+    // Parses newline-delimited JSON (JSON Lines) in parallel. Every worker
+    // thread owns an arena and a builder, so records are parsed without
+    // contending on the global allocator.
+    class LinesDocument
+    {
+        typedef std::pair<std::size_t, std::size_t> Line;
+
+        static const std::size_t LinesPerTask = 64;
+
+        BatchWorkers workers;
+        std::vector<Value> roots;
+
+        static bool IsBlank(const char *ptr, const char *const end)
+        {
+            for( ; ptr != end; ++ptr )
+                if( *ptr != ' ' && *ptr != '\t' && *ptr != '\r' )
+                    return false;
+
+            return true;
+        }
+
+        // A raw newline cannot appear inside a valid JSON string, so every
+        // newline byte is a record boundary.
+        static std::vector<Line> FindLines(const char *const pData, const std::size_t length)
+        {
+            std::vector<Line> lines;
+
+            const char *ptr = pData;
+            const char *const end = pData + length;
+            while( ptr != end )
+            {
+                const char *pNewline = static_cast<const char *>(std::memchr(ptr, '\n', static_cast<std::size_t>(end - ptr)));
+                if( !pNewline )
+                    pNewline = end;
+
+                if( !IsBlank(ptr, pNewline) )
+                    lines.push_back(Line(static_cast<std::size_t>(ptr - pData), static_cast<std::size_t>(pNewline - pData)));
+
+                ptr = pNewline == end ? end : pNewline + 1;
+            }
+
+            return lines;
+        }
+
+        static Value ParseLine(BatchWorkers::Worker &worker, const char *const pData, const Line &line, const ParseOptions &options)
+        {
+            worker.buffer.assign(pData + line.first, pData + line.second);
+
+            CharPtr stream(worker.buffer.data(), worker.buffer.data() + worker.buffer.size());
+            Reader<CharPtr>::ReadValue(stream, worker.builder, worker.scratch, options);
+
+            if( !IsBlank(stream.Ptr(), stream.End()) )
+                throw std::runtime_error("unexpected trailing characters");
+
+            return worker.builder.Root();
+        }
+
+        static std::size_t LineNumber(const char *const pData, const Line &line)
+        {
+            return 1 + static_cast<std::size_t>(std::count(pData, pData + line.first, '\n'));
+        }
+
+        // Parses lines [first, last) into roots[0, last - first); the first
+        // failing line is rethrown.
+        void ParseRange(const char *const pData, const std::vector<Line> &lines, const std::size_t first, const std::size_t last, const ParseOptions &options)
+        {
+            try
+            {
+                workers.Run(first, last, LinesPerTask, [&](BatchWorkers::Worker &worker, const std::size_t i)
+                {
+                    try
+                    {
+                        roots[i - first] = ParseLine(worker, pData, lines[i], options);
+                    }
+                    catch( const std::exception &e )
+                    {
+                        throw std::runtime_error("line " + std::to_string(LineNumber(pData, lines[i])) + ": " + e.what());
+                    }
+                });
+            }
+            catch( ... )
+            {
+                roots.clear();
+                throw;
+            }
+        }
+
+    public:
+        explicit LinesDocument()
+        {
+        }
+
+        LinesDocument(LinesDocument &&other) :
+            workers(std::move(other.workers)),
+            roots(std::move(other.roots))
+        {
+        }
+
+        LinesDocument &operator =(LinesDocument &&other)
+        {
+            workers = std::move(other.workers);
+            roots = std::move(other.roots);
+
+            return *this;
+        }
+
+        // Parses every non-blank line; the roots keep the input order.
+        void Parse(const char *const pData, const std::size_t length, const BatchOptions &options = BatchOptions())
+        {
+            roots.clear();
+
+            if( length > options.parseOptions.maxInputBytes )
+                throw std::runtime_error("input too large");
+
+            const std::vector<Line> lines = FindLines(pData, length);
+            workers.Prepare(options, (lines.size() + LinesPerTask - 1) / LinesPerTask);
+
+            roots.resize(lines.size());
+            ParseRange(pData, lines, 0, lines.size(), options.parseOptions);
+        }
+
+        void Parse(const std::string &str, const BatchOptions &options = BatchOptions())
+        {
+            Parse(str.data(), str.size(), options);
+        }
+
+        // Streams the records to callback(index, root) in input order on the
+        // calling thread. Records are parsed a window at a time and the
+        // arenas are reused, so memory stays bounded by the window size.
+        template <class Callback>
+        void ParseEach(const char *const pData, const std::size_t length, Callback callback, const BatchOptions &options = BatchOptions())
+        {
+            if( length > options.parseOptions.maxInputBytes )
+                throw std::runtime_error("input too large");
+
+            const std::vector<Line> lines = FindLines(pData, length);
+            const std::size_t windowSize = std::max<std::size_t>(1, options.windowSize);
+
+            for( std::size_t first = 0; first < lines.size(); first += windowSize )
+            {
+                const std::size_t last = std::min(lines.size(), first + windowSize);
+
+                roots.clear();
+                workers.Prepare(options, (last - first + LinesPerTask - 1) / LinesPerTask);
+
+                roots.resize(last - first);
+                ParseRange(pData, lines, first, last, options.parseOptions);
+
+                for( std::size_t i = first; i < last; ++i )
+                    callback(i, static_cast<const Value &>(roots[i - first]));
+            }
+
+            roots.clear();
+        }
+
+        template <class Callback>
+        void ParseEach(const std::string &str, Callback callback, const BatchOptions &options = BatchOptions())
+        {
+            ParseEach(str.data(), str.size(), callback, options);
+        }
+
+        std::size_t size() const
+        {
+            return roots.size();
+        }
+
+        bool empty() const
+        {
+            return roots.empty();
+        }
+
+        const Value &operator [](const std::size_t index) const
+        {
+            return roots[index];
+        }
+
+        const Value &at(const std::size_t index) const
+        {
+            return roots.at(index);
+        }
+
+        const Value *begin() const
+        {
+            return roots.data();
+        }
+
+        const Value *end() const
+        {
+            return roots.data() + roots.size();
+        }
+    };
+
+    // Parses one document holding a top-level array, such as a large
+    // export, with the elements spread over threads. A string-aware index of
+    // the element boundaries is built first from the structural bit masks;
+    // each worker then parses whole elements in place into its own arena,
+    // and the roots are stitched into one array in input order.
+    class ArrayDocument
+    {
+        static const std::size_t ElementsPerTask = 64;
+
+        BatchWorkers workers;
+        std::vector<Value> items;
+        std::string buffer;
+
+        static bool IsBlank(const char *ptr, const char *const end)
+        {
+            for( ; ptr != end; ++ptr )
+                if( *ptr != ' ' && *ptr != '\t' && *ptr != '\n' && *ptr != '\r' )
+                    return false;
+
+            return true;
+        }
+
+        // Returns the offsets of the opening '[', of every ',' between
+        // elements and of the closing ']'. Element i lies between bounds[i]
+        // and bounds[i + 1].
+        static std::vector<std::size_t> FindElements(const char *const pData, const std::size_t length)
+        {
+            const char *const end = pData + length;
+
+            const char *pStart = pData;
+            while( pStart != end && IsBlank(pStart, pStart + 1) )
+                ++pStart;
+
+            if( pStart == end || *pStart != '[' )
+                throw std::runtime_error("array expected");
+
+            std::vector<std::size_t> bounds;
+            std::size_t depth = 0;
+            const char *pClose = nullptr;
+
+            BlockScanner scanner;
+            BlockScanner::ForEachBlock(pStart, end, [&](const char *const pBlock, std::size_t, const BlockScanner::Masks &masks)
+            {
+                std::uint64_t escapes, quotes;
+                const std::uint64_t escaped = scanner.FindEscaped(masks.backslash, escapes);
+                const std::uint64_t inString = scanner.FindStrings(masks, escaped, quotes);
+
+                for( std::uint64_t bits = masks.structural & ~inString; bits != 0; bits &= bits - 1 )
+                {
+                    const char *const ptr = pBlock + CountTrailingZeros64(bits);
+
+                    switch( *ptr )
+                    {
+                        case '[':
+                        case '{':
+                            if( depth++ == 0 )
+                                bounds.push_back(static_cast<std::size_t>(ptr - pData));
+                            break;
+
+                        case ']':
+                        case '}':
+                            if( --depth == 0 )
+                            {
+                                bounds.push_back(static_cast<std::size_t>(ptr - pData));
+                                pClose = ptr;
+                                return false;
+                            }
+                            break;
+
+                        case ',':
+                            if( depth == 1 )
+                                bounds.push_back(static_cast<std::size_t>(ptr - pData));
+                            break;
+                    }
+                }
+
+                return true;
+            });
+
+            if( !pClose )
+                throw std::runtime_error(scanner.InString() ? "'\"' expected" : "']' expected");
+
+            if( *pClose != ']' )
+                throw std::runtime_error("']' expected");
+
+            if( !IsBlank(pClose + 1, end) )
+                throw std::runtime_error("unexpected trailing characters");
+
+            // [ ] holds no elements rather than one blank one
+            if( bounds.size() == 2 && IsBlank(pData + bounds[0] + 1, pClose) )
+                bounds.erase(bounds.begin());
+
+            return bounds;
+        }
+
+        // Parses element index from the input, which must be null-terminated
+        // at end; the value has to fill the element up to its boundary.
+        // nodes already holds one value per element, and the rest of this
+        // one is added to it.
+        static Value ParseElement(BatchWorkers::Worker &worker, const char *const pData, const char *const end, const std::vector<std::size_t> &bounds, const std::size_t index,
+            const ParseOptions &options, std::atomic<std::size_t> &nodes, const std::size_t maxNodes)
+        {
+            const char *const pBoundary = pData + bounds[index + 1];
+
+            CharPtr stream(pData + bounds[index] + 1, end);
+            const std::size_t extra = Reader<CharPtr>::ReadValue(stream, worker.builder, worker.scratch, options) - 1;
+
+            if( nodes.fetch_add(extra) + extra > maxNodes )
+                throw std::runtime_error("too many values");
+
+            if( stream.Ptr() > pBoundary || !IsBlank(stream.Ptr(), pBoundary) )
+                throw std::runtime_error("',' or ']' expected");
+
+            return worker.builder.Root();
+        }
+
+        // The input must be null-terminated at pData[length].
+        void ParseTerminated(const char *const pData, const std::size_t length, const BatchOptions &options)
+        {
+            items.clear();
+
+            if( length > options.parseOptions.maxInputBytes )
+                throw std::runtime_error("input too large");
+
+            // Elements are read one level below the enclosing array.
+            ParseOptions elementOptions = options.parseOptions;
+            if( elementOptions.maxDepth == 0 )
+                throw std::runtime_error("nesting too deep");
+
+            --elementOptions.maxDepth;
+
+            const std::vector<std::size_t> bounds = FindElements(pData, length);
+            const std::size_t count = bounds.size() - 1;
+
+            // The array and every element are one value at least, which
+            // bounds each element before the shared total is known.
+            const std::size_t maxNodes = elementOptions.maxNodes;
+            if( count >= maxNodes )
+                throw std::runtime_error("too many values");
+
+            elementOptions.maxNodes -= count;
+            std::atomic<std::size_t> nodes(count + 1);
+
+            workers.Prepare(options, (count + ElementsPerTask - 1) / ElementsPerTask);
+            items.resize(count);
+
+            try
+            {
+                workers.Run(0, count, ElementsPerTask, [&](BatchWorkers::Worker &worker, const std::size_t i)
+                {
+                    try
+                    {
+                        items[i] = ParseElement(worker, pData, pData + length, bounds, i, elementOptions, nodes, maxNodes);
+                    }
+                    catch( const std::exception &e )
+                    {
+                        throw std::runtime_error("element " + std::to_string(i) + ": " + e.what());
+                    }
+                });
+            }
+            catch( ... )
+            {
+                items.clear();
+                throw;
+            }
+        }
+
+    public:
+        explicit ArrayDocument()
+        {
+        }
+
+        ArrayDocument(ArrayDocument &&other) :
+            workers(std::move(other.workers)),
+            items(std::move(other.items)),
+            buffer(std::move(other.buffer))
+        {
+        }
+
+        ArrayDocument &operator =(ArrayDocument &&other)
+        {
+            workers = std::move(other.workers);
+            items = std::move(other.items);
+            buffer = std::move(other.buffer);
+
+            return *this;
+        }
+
+        void Parse(const std::string &str, const BatchOptions &options = BatchOptions())
+        {
+            ParseTerminated(str.c_str(), str.size(), options);
+        }
+
+        // Copies the input once to add the terminator the reader relies on.
+        void Parse(const char *const pData, const std::size_t length, const BatchOptions &options = BatchOptions())
+        {
+            if( length > options.parseOptions.maxInputBytes )
+                throw std::runtime_error("input too large");
+
+            buffer.assign(pData, length);
+            Parse(buffer, options);
+        }
+
+        // The elements as one array value.
+        Value Root() const
+        {
+            return Value::MakeArray(items.data(), items.size());
+        }
+
+        std::size_t size() const
+        {
+            return items.size();
+        }
+
+        bool empty() const
+        {
+            return items.empty();
+        }
+
+        const Value &operator [](const std::size_t index) const
+        {
+            return items[index];
+        }
+
+        const Value &at(const std::size_t index) const
+        {
+            return items.at(index);
+        }
+
+        const Value *begin() const
+        {
+            return items.data();
+        }
+
+        const Value *end() const
+        {
+            return items.data() + items.size();
+        }
+    };
+
+    template <class T>
+    struct ConvertTo;
+
+    template <class T>
+    T Convert(const ValuePtr &value);
+
+    template <class T>
+    T Convert(ValuePtr &&value);
+
+    template <class T>
+    T Convert(const Value &value);
+
+    // Mutable access for the rvalue conversions, which take over the
+    // strings and containers of a tree that is about to be released.
+    inline String &TakeString(ValuePtr &value)
+    {
+        if( !value->IsString() )
+            throw std::runtime_error("value is not a string");
+
+        return static_cast<StringValue &>(*value).value;
+    }
+
+    inline Array &TakeArray(ValuePtr &value)
+    {
+        if( !value->IsArray() )
+            throw std::runtime_error("value is not an array");
+
+        return static_cast<ArrayValue &>(*value).value;
+    }
+
+    inline Object &TakeObject(ValuePtr &value)
+    {
+        if( !value->IsObject() )
+            throw std::runtime_error("value is not an object");
+
+        return static_cast<ObjectValue &>(*value).value;
+    }
+
+    // Structs registered with TinyJson_Fields convert member by member;
+    // members without a matching key keep their default value.
+    template <class T>
+    struct ConvertTo
+    {
+        struct TreeFieldConverter
+        {
+            const Object &obj;
+
+            template <std::size_t N, class F>
+            void operator ()(const char (&name)[N], F &field) const
+            {
+                const auto itr = obj.find(StringView(name, N - 1));
+                if( itr != obj.end() )
+                    field = Convert<F>(itr->second);
+            }
+        };
+
+        struct MovingFieldConverter
+        {
+            Object &obj;
+
+            template <std::size_t N, class F>
+            void operator ()(const char (&name)[N], F &field) const
+            {
+                const auto itr = obj.find(StringView(name, N - 1));
+                if( itr != obj.end() )
+                    field = Convert<F>(std::move(itr->second));
+            }
+        };
+
+        struct FieldConverter
+        {
+            const ObjectView obj;
+
+            template <std::size_t N, class F>
+            void operator ()(const char (&name)[N], F &field) const
+            {
+                const auto itr = obj.find(StringView(name, N - 1));
+                if( itr != obj.end() )
+                    field = Convert<F>(itr->value);
+            }
+        };
+
+        static T From(const ValuePtr &value)
+        {
+            T result{};
+            const TreeFieldConverter converter = { value->AsObject() };
+            TinyJson_VisitFields(result, converter);
+
+            return result;
+        }
+
+        static T From(ValuePtr &&value)
+        {
+            T result{};
+            const MovingFieldConverter converter = { TakeObject(value) };
+            TinyJson_VisitFields(result, converter);
+
+            return result;
+        }
+
+        static T From(const Value &value)
+        {
+            T result{};
+            const FieldConverter converter = { value.AsObject() };
+            TinyJson_VisitFields(result, converter);
+
+            return result;
+        }
+    };
+
+    // Integral targets read integral literals through their exact 64-bit
+    // representation, so large IDs are not rounded through a double. Values
+    // the target cannot hold throw std::out_of_range instead of wrapping, and
+    // integral targets reject numbers with a fraction.
+    template <class T>
+    struct ConvertToNumber
+    {
+        typedef std::numeric_limits<T> Limits;
+
+        static T FromInt64(const std::int64_t value)
+        {
+            const bool fits = Limits::is_signed ?
+                value >= static_cast<std::int64_t>(Limits::min()) && value <= static_cast<std::int64_t>(Limits::max()) :
+                value >= 0 && static_cast<std::uint64_t>(value) <= static_cast<std::uint64_t>(Limits::max());
+
+            if( !fits )
+                throw std::out_of_range("number out of range");
+
+            return static_cast<T>(value);
+        }
+
+        static T FromUInt64(const std::uint64_t value)
+        {
+            if( value > static_cast<std::uint64_t>(Limits::max()) )
+                throw std::out_of_range("number out of range");
+
+            return static_cast<T>(value);
+        }
+
+        // Bounds are powers of two, which a double holds exactly.
+        static T FromDouble(const double value, std::true_type)
+        {
+            if( value != std::trunc(value) )
+                throw std::runtime_error("value is not an integer");
+
+            const double upper = std::ldexp(1.0, Limits::digits);
+            const double lower = Limits::is_signed ? -upper : 0.0;
+
+            if( !(value >= lower && value < upper) )
+                throw std::out_of_range("number out of range");
+
+            return static_cast<T>(value);
+        }
+
+        static T FromDouble(const double value, std::false_type)
+        {
+            if( std::isfinite(value) && std::fabs(value) > static_cast<double>(Limits::max()) )
+                throw std::out_of_range("number out of range");
+
+            return static_cast<T>(value);
+        }
+
+        template <class V>
+        static T FromNumber(const V &value, std::true_type)
+        {
+            if( value.IsInt64() )
+                return FromInt64(value.AsInt64());
+
+            if( value.IsUInt64() )
+                return FromUInt64(value.AsUInt64());
+
+            return FromDouble(value.AsNumber(), std::true_type());
+        }
+
+        template <class V>
+        static T FromNumber(const V &value, std::false_type)
+        {
+            return FromDouble(value.AsNumber(), std::false_type());
+        }
+
+        static T From(const ValuePtr &value)
+        {
+            return FromNumber(*value, std::is_integral<T>());
+        }
+
+        static T From(const Value &value)
+        {
+            return FromNumber(value, std::is_integral<T>());
+        }
+    };
+
+#define TinyJson_DefineConvertToNumber(X) \
+    template <> struct ConvertTo<X> : public ConvertToNumber<X> { }
+
+    TinyJson_DefineConvertToNumber(int);
+    TinyJson_DefineConvertToNumber(unsigned int);
+    TinyJson_DefineConvertToNumber(short);
+    TinyJson_DefineConvertToNumber(unsigned short);
+    TinyJson_DefineConvertToNumber(long);
+    TinyJson_DefineConvertToNumber(unsigned long);
+    TinyJson_DefineConvertToNumber(long long);
+    TinyJson_DefineConvertToNumber(unsigned long long);
+    TinyJson_DefineConvertToNumber(float);
+    TinyJson_DefineConvertToNumber(double);
+
+    template <>
+    struct ConvertTo<std::string>
+    {
+        static std::string From(const ValuePtr &value)
+        {
+            return value->AsString();
+        }
+
+        static std::string From(ValuePtr &&value)
+        {
+            return std::move(TakeString(value));
+        }
+
+        static std::string From(const Value &value)
+        {
+            return value.AsString().str();
+        }
+    };
+
+    template <>
+    struct ConvertTo<ValuePtr>
+    {
+        static ValuePtr From(ValuePtr &&value)
+        {
+            return std::move(value);
+        }
+    };
+
+    // Converting to the tree's own container types steals their storage.
+    template <>
+    struct ConvertTo<Array>
+    {
+        static Array From(ValuePtr &&value)
+        {
+            return std::move(TakeArray(value));
+        }
+    };
+
+    template <>
+    struct ConvertTo<Object>
+    {
+        static Object From(ValuePtr &&value)
+        {
+            return std::move(TakeObject(value));
+        }
+    };
+
+    template <class T, class Allocator>
+    void ReserveItems(std::vector<T, Allocator> &container, const std::size_t count)
+    {
+        container.reserve(count);
+    }
+
+    template <class Container>
+    void ReserveItems(Container &, const std::size_t)
+    {
+    }
+
+    template <class Container>
+    struct ConvertToSequenceContainer
+    {
+        template <class Items>
+        static Container FromItems(const Items &items)
+        {
+            Container result;
+            ReserveItems(result, items.size());
+
+            for( const auto &item: items )
+                result.push_back(Convert<typename Container::value_type>(item));
+
+            return result;
+        }
+
+        static Container From(const ValuePtr &value)
+        {
+            return FromItems(value->AsArray());
+        }
+
+        // Each item is released as soon as it has been converted.
+        static Container From(ValuePtr &&value)
+        {
+            auto &items = TakeArray(value);
+
+            Container result;
+            ReserveItems(result, items.size());
+
+            for( auto &item: items )
+                result.push_back(Convert<typename Container::value_type>(std::move(item)));
+
+            return result;
+        }
+
+        static Container From(const Value &value)
+        {
+            return FromItems(value.AsArray());
+        }
+    };
+
+#define TinyJson_DefineConvertToSequenceContainer(X) \
+    template <class T> struct ConvertTo<X<T>> : public ConvertToSequenceContainer<X<T>> { }
+
+    TinyJson_DefineConvertToSequenceContainer(std::vector);
+    TinyJson_DefineConvertToSequenceContainer(std::deque);
+    TinyJson_DefineConvertToSequenceContainer(std::list);
+
+    template <class Container>
+    struct ConvertToAssociativeContainer
+    {
+        static Container From(const ValuePtr &value)
+        {
+            Container result;
+
+            const auto &m = value->AsObject();
+            for( const auto &entry: m )
+                result.emplace(entry.first, Convert<typename Container::mapped_type>(entry.second));
+
+            return result;
+        }
+
+        static Container From(ValuePtr &&value)
+        {
+            Container result;
+
+            for( auto &entry: TakeObject(value) )
+                result.emplace(std::move(entry.first), Convert<typename Container::mapped_type>(std::move(entry.second)));
+
+            return result;
+        }
+
+        static Container From(const Value &value)
+        {
+            Container result;
+
+            for( const auto &member: value.AsObject() )
+                result.emplace(member.key.AsString().str(), Convert<typename Container::mapped_type>(member.value));
+
+            return result;
+        }
+    };
+
+#define TinyJson_DefineConvertToAssociativeContainer(X) \
+    template <class T> struct ConvertTo<X<std::string, T>> : public ConvertToAssociativeContainer<X<std::string, T>> { }
+
+    TinyJson_DefineConvertToAssociativeContainer(std::map);
+    TinyJson_DefineConvertToAssociativeContainer(std::unordered_map);
+
+    template <>
+    struct ConvertTo<bool>
+    {
+        static bool From(const ValuePtr &value)
+        {
+            return value->AsBoolean();
+        }
+
+        static bool From(const Value &value)
+        {
+            return value.AsBoolean();
+        }
+    };
+
+    template <class T, class U>
+    struct ConvertTo<std::pair<T, U>>
+    {
+        static std::pair<T, U> From(const ValuePtr &value)
+        {
+            const auto &arr = value->AsArray();
+            if( arr.size() != 2 )
+                throw std::runtime_error("pair must contain exactly two items");
+
+            return std::make_pair(Convert<T>(arr[0]), Convert<U>(arr[1]));
+        }
+
+        static std::pair<T, U> From(ValuePtr &&value)
+        {
+            auto &arr = TakeArray(value);
+            if( arr.size() != 2 )
+                throw std::runtime_error("pair must contain exactly two items");
+
+            return std::make_pair(Convert<T>(std::move(arr[0])), Convert<U>(std::move(arr[1])));
+        }
+
+        static std::pair<T, U> From(const Value &value)
+        {
+            const auto arr = value.AsArray();
+            if( arr.size() != 2 )
+                throw std::runtime_error("pair must contain exactly two items");
+
+            return std::make_pair(Convert<T>(arr[0]), Convert<U>(arr[1]));
+        }
+    };
+
+    template <class T>
+    T Convert(const ValuePtr &value)
+    {
+        return ConvertTo<T>::From(value);
+    }
+
+    // Moves strings and containers out of the tree instead of copying them,
+    // and releases it as soon as the conversion is done.
+    template <class T>
+    T Convert(ValuePtr &&value)
+    {
+        ValuePtr owned(std::move(value));
+        return ConvertTo<T>::From(std::move(owned));
+    }
+
+    template <class T>
+    T Convert(const Value &value)
+    {
+        return ConvertTo<T>::From(value);
+    }
+
+    template <class T>
+    struct ConvertArrayDocument;
+
+    // Each thread converts its own slice of the elements in place.
+    template <class T, class Allocator>
+    struct ConvertArrayDocument<std::vector<T, Allocator>>
+    {
+        static_assert(!std::is_same<T, bool>::value, "std::vector<bool> cannot be filled from several threads");
+
+        static std::vector<T, Allocator> From(const ArrayDocument &document, const BatchOptions &options)
+        {
+            std::vector<T, Allocator> result(document.size());
+
+            const std::size_t threadCount = options.threadCount ? options.threadCount : std::thread::hardware_concurrency();
+            ParallelFor(threadCount, 0, document.size(), 64, [&](std::size_t, const std::size_t i)
+            {
+                try
+                {
+                    result[i] = Convert<T>(document[i]);
+                }
+                catch( const std::exception &e )
+                {
+                    throw std::runtime_error("element " + std::to_string(i) + ": " + e.what());
+                }
+            });
+
+            return result;
+        }
+    };
+
+    // Converts a parsed ArrayDocument to a std::vector in parallel; the
+    // result equals Convert<T>(document.Root()).
+    template <class T>
+    T Convert(const ArrayDocument &document, const BatchOptions &options = BatchOptions())
+    {
+        return ConvertArrayDocument<T>::From(document, options);
+    }
+
+    // Cursor into unparsed JSON text. Indexing scans only the enclosing
+    // container, skipping the members it passes over with a bracket- and
+    // quote-aware scan, and Get<T> decodes just the value it points at.
+    // Nothing is validated beyond what is scanned or decoded.
+    class LazyValue : private Reader<CharPtr>
+    {
+        const char *ptr;
+        const char *end;
+
+        static const char *SkipSpace(const char *pos)
+        {
+            while( IsWhitespace(*pos) )
+                ++pos;
+
+            return pos;
+        }
+
+        static const char *SkipString(const char *pos, const char *const pEnd)
+        {
+            for( ++pos; ; )
+            {
+                pos = StringScanner::Find(pos, pEnd);
+
+                switch( *pos )
+                {
+                    case '"':
+                        return pos + 1;
+
+                    case '\\':
+                        if( pos + 1 == pEnd )
+                            throw std::runtime_error("'\"' expected");
+
+                        pos += 2;
+                        break;
+
+                    default:
+                        if( pos == pEnd )
+                            throw std::runtime_error("'\"' expected");
+
+                        throw std::runtime_error("invalid control character in string");
+                }
+            }
+        }
+
+        static const char *SkipValue(const char *pos, const char *const pEnd)
+        {
+            switch( *pos )
+            {
+                case '"':
+                    return SkipString(pos, pEnd);
+
+                case '[':
+                case '{':
+                {
+                    std::size_t depth = 0;
+                    for( ;; )
+                    {
+                        switch( *pos )
+                        {
+                            case '"':
+                                pos = SkipString(pos, pEnd);
+                                continue;
+
+                            case '[':
+                            case '{':
+                                ++depth;
+                                break;
+
+                            case ']':
+                            case '}':
+                                if( --depth == 0 )
+                                    return pos + 1;
+                                break;
+
+                            case 0:
+                                if( pos == pEnd )
+                                    throw std::runtime_error("unexpected end of input");
+                                break;
+                        }
+
+                        ++pos;
+                    }
+                }
+
+                default:
+                    while( pos != pEnd && *pos != ',' && *pos != ']' && *pos != '}' && !IsWhitespace(*pos) )
+                        ++pos;
+
+                    return pos;
+            }
+        }
+
+        // Moves past the separator after a member or item; false at the end.
+        static bool NextItem(const char *&pos, const char closing)
+        {
+            pos = SkipSpace(pos);
+
+            if( *pos == ',' )
+            {
+                pos = SkipSpace(pos + 1);
+                return true;
+            }
+
+            if( *pos != closing )
+                throw std::runtime_error(closing == ']' ? "']' expected" : "'}' expected");
+
+            return false;
+        }
+
+        const char *FindMember(const StringView &key) const
+        {
+            if( *ptr != '{' )
+                throw std::runtime_error("value is not an object");
+
+            String scratch;
+            const char *pos = SkipSpace(ptr + 1);
+            if( *pos == '}' )
+                return nullptr;
+
+            for( ;; )
+            {
+                if( *pos != '"' )
+                    throw std::runtime_error("string expected");
+
+                CharPtr stream(pos, end);
+                const StringView name = StringReader<CharPtr>::Read(stream, scratch);
+
+                pos = SkipSpace(stream.Ptr());
+                if( *pos != ':' )
+                    throw std::runtime_error("':' expected");
+
+                pos = SkipSpace(pos + 1);
+                if( name == key )
+                    return pos;
+
+                pos = SkipValue(pos, end);
+                if( !NextItem(pos, '}') )
+                    return nullptr;
+            }
+        }
+
+        const char *FindItem(std::size_t index) const
+        {
+            if( *ptr != '[' )
+                throw std::runtime_error("value is not an array");
+
+            const char *pos = SkipSpace(ptr + 1);
+            if( *pos == ']' )
+                return nullptr;
+
+            for( ; index != 0; --index )
+            {
+                pos = SkipValue(pos, end);
+                if( !NextItem(pos, ']') )
+                    return nullptr;
+            }
+
+            return pos;
+        }
+
+    public:
+        // The text from ptr_ to end_ must be followed by a null terminator.
+        explicit LazyValue(const char *const ptr_, const char *const end_) :
+            ptr(SkipSpace(ptr_)),
+            end(end_)
+        {
+            assert(*end == 0);
+        }
+
+        ValueType Type() const
+        {
+            switch( *ptr )
+            {
+                case '"': return ValueType::String;
+                case '[': return ValueType::Array;
+                case '{': return ValueType::Object;
+                case 't': case 'f': return ValueType::Boolean;
+                case 'n': return ValueType::Null;
+                case '-': case TinyJson_Digits_0_9: return ValueType::Number;
+            }
+
+            throw std::runtime_error("Invalid format");
+        }
+
+        bool IsNull() const { return Type() == ValueType::Null; }
+        bool IsNumber() const { return Type() == ValueType::Number; }
+        bool IsString() const { return Type() == ValueType::String; }
+        bool IsArray() const { return Type() == ValueType::Array; }
+        bool IsObject() const { return Type() == ValueType::Object; }
+        bool IsBoolean() const { return Type() == ValueType::Boolean; }
+
+        std::size_t count(const StringView &key) const
+        {
+            return FindMember(key) ? 1 : 0;
+        }
+
+        LazyValue at(const StringView &key) const
+        {
+            const char *const pos = FindMember(key);
+            if( !pos )
+                throw std::out_of_range("key not found: " + key.str());
+
+            return LazyValue(pos, end);
+        }
+
+        LazyValue at(const std::size_t index) const
+        {
+            const char *const pos = FindItem(index);
+            if( !pos )
+                throw std::out_of_range("array index out of range");
+
+            return LazyValue(pos, end);
+        }
+
+        LazyValue operator [](const StringView &key) const
+        {
+            return at(key);
+        }
+
+        LazyValue operator [](const std::size_t index) const
+        {
+            return at(index);
+        }
+
+        // The JSON text of this value, up to the end of its last character.
+        StringView Raw() const
+        {
+            return StringView(ptr, static_cast<std::size_t>(SkipValue(ptr, end) - ptr));
+        }
+
+        // Decodes this value alone and converts it with Convert<T>.
+        template <class T>
+        T Get() const
+        {
+            Arena arena;
+            DocumentBuilder builder(arena, true);
+            String scratch;
+
+            CharPtr stream(ptr, end);
+            Reader<CharPtr>::ReadValue(stream, builder, scratch);
+
+            return Convert<T>(builder.Root());
+        }
+    };
+
+    template <class T>
+    T Convert(const LazyValue &value)
+    {
+        return value.template Get<T>();
+    }
+
+    // Lazily parsed view of a JSON text that must outlive it.
+    class LazyDocument
+    {
+        LazyValue root;
+
+    public:
+        explicit LazyDocument(const char *const pStr) :
+            root(pStr, pStr + std::strlen(pStr))
+        {
+        }
+
+        explicit LazyDocument(const std::string &str) :
+            root(str.c_str(), str.c_str() + str.size())
+        {
+        }
+
+        explicit LazyDocument(std::string &&) =delete;
+
+        const LazyValue &Root() const
+        {
+            return root;
+        }
+
+        LazyValue operator [](const StringView &key) const
+        {
+            return root[key];
+        }
+
+        LazyValue operator [](const std::size_t index) const
+        {
+            return root[index];
+        }
+    };
+
+#define TinyJson_Expand(x) x
+
+#define TinyJson_ForEach1(M, x) M(x)
+#define TinyJson_ForEach2(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach1(M, __VA_ARGS__))
+#define TinyJson_ForEach3(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach2(M, __VA_ARGS__))
+#define TinyJson_ForEach4(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach3(M, __VA_ARGS__))
+#define TinyJson_ForEach5(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach4(M, __VA_ARGS__))
+#define TinyJson_ForEach6(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach5(M, __VA_ARGS__))
+#define TinyJson_ForEach7(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach6(M, __VA_ARGS__))
+#define TinyJson_ForEach8(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach7(M, __VA_ARGS__))
+#define TinyJson_ForEach9(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach8(M, __VA_ARGS__))
+#define TinyJson_ForEach10(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach9(M, __VA_ARGS__))
+#define TinyJson_ForEach11(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach10(M, __VA_ARGS__))
+#define TinyJson_ForEach12(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach11(M, __VA_ARGS__))
+#define TinyJson_ForEach13(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach12(M, __VA_ARGS__))
+#define TinyJson_ForEach14(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach13(M, __VA_ARGS__))
+#define TinyJson_ForEach15(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach14(M, __VA_ARGS__))
+#define TinyJson_ForEach16(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach15(M, __VA_ARGS__))
+#define TinyJson_ForEach17(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach16(M, __VA_ARGS__))
+#define TinyJson_ForEach18(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach17(M, __VA_ARGS__))
+#define TinyJson_ForEach19(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach18(M, __VA_ARGS__))
+#define TinyJson_ForEach20(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach19(M, __VA_ARGS__))
+#define TinyJson_ForEach21(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach20(M, __VA_ARGS__))
+#define TinyJson_ForEach22(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach21(M, __VA_ARGS__))
+#define TinyJson_ForEach23(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach22(M, __VA_ARGS__))
+#define TinyJson_ForEach24(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach23(M, __VA_ARGS__))
+#define TinyJson_ForEach25(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach24(M, __VA_ARGS__))
+#define TinyJson_ForEach26(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach25(M, __VA_ARGS__))
+#define TinyJson_ForEach27(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach26(M, __VA_ARGS__))
+#define TinyJson_ForEach28(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach27(M, __VA_ARGS__))
+#define TinyJson_ForEach29(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach28(M, __VA_ARGS__))
+#define TinyJson_ForEach30(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach29(M, __VA_ARGS__))
+#define TinyJson_ForEach31(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach30(M, __VA_ARGS__))
+#define TinyJson_ForEach32(M, x, ...) M(x) TinyJson_Expand(TinyJson_ForEach31(M, __VA_ARGS__))
+
+#define TinyJson_ForEachN( \
+    _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, \
+    _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, \
+    N, ...) N
+
+#define TinyJson_ForEach(M, ...) TinyJson_Expand(TinyJson_ForEachN(__VA_ARGS__, \
+    TinyJson_ForEach32, TinyJson_ForEach31, TinyJson_ForEach30, TinyJson_ForEach29, TinyJson_ForEach28, TinyJson_ForEach27, TinyJson_ForEach26, TinyJson_ForEach25, \
+    TinyJson_ForEach24, TinyJson_ForEach23, TinyJson_ForEach22, TinyJson_ForEach21, TinyJson_ForEach20, TinyJson_ForEach19, TinyJson_ForEach18, TinyJson_ForEach17, \
+    TinyJson_ForEach16, TinyJson_ForEach15, TinyJson_ForEach14, TinyJson_ForEach13, TinyJson_ForEach12, TinyJson_ForEach11, TinyJson_ForEach10, TinyJson_ForEach9, \
+    TinyJson_ForEach8, TinyJson_ForEach7, TinyJson_ForEach6, TinyJson_ForEach5, TinyJson_ForEach4, TinyJson_ForEach3, TinyJson_ForEach2, TinyJson_ForEach1)(M, __VA_ARGS__))
+
+#define TinyJson_VisitField(field) visitor(#field, value.field);
+
+    // Registers the members of a struct for ReadTo, Convert and Write. Use it
+    // at namespace scope, in the namespace of the struct:
+    //
+    //     struct Endpoint { std::string host; int port; };
+    //     TinyJson_Fields(Endpoint, host, port)
+    //
+    // Key names come from the member names, up to 32 members per struct.
+#define TinyJson_Fields(Type, ...) \
+    template <class Visitor> \
+    inline void TinyJson_VisitFields(Type &value, Visitor &visitor) { TinyJson_ForEach(TinyJson_VisitField, __VA_ARGS__) } \
+    template <class Visitor> \
+    inline void TinyJson_VisitFields(const Type &value, Visitor &visitor) { TinyJson_ForEach(TinyJson_VisitField, __VA_ARGS__) }
+
+    // Parses JSON straight into C++ values without building a tree.
+    // TypedReader<T>::Read fills a T from the next value of the stream.
+    template <class T, class Enable = void>
+    struct TypedReader;
+
+    class TypedReaderBase : protected Reader<CharPtr>
+    {
+        struct SkipHandler : public HandlerBase<SkipHandler>
+        {
+        };
+
+    public:
+        // State shared by the readers of one document. Containers are read
+        // by recursion, so depth bounds the native stack as maxDepth bounds
+        // the ContainerStack of Reader.
+        struct Context
+        {
+            String scratch;
+            const ParseOptions &options;
+            std::size_t depth;
+
+            // Keys of the members skipped in the open objects, for the
+            // duplicate check. They view the input, or escapedKeys when
+            // they were unescaped into scratch.
+            std::vector<StringView> skippedKeys;
+            std::deque<std::string> escapedKeys;
+
+            explicit Context(const ParseOptions &options_) :
+                options(options_),
+                depth(0)
+            {
+            }
+
+            Context(const Context &) =delete;
+            void operator =(const Context &) =delete;
+        };
+
+    protected:
+        // Options for a value handed to Reader from the current depth. The
+        // input size was checked for the whole document up front.
+        static ParseOptions NestedOptions(const Context &context)
+        {
+            ParseOptions options = context.options;
+            options.maxDepth -= context.depth;
+            options.maxInputBytes = std::numeric_limits<std::size_t>::max();
+
+            return options;
+        }
+
+        static StringView ReadString(CharPtr &stream, Context &context)
+        {
+            const StringView str = Reader<CharPtr>::ReadString(stream, context.scratch);
+            CheckLength(str, context.options);
+
+            return str;
+        }
+
+        // Calls readItem once per item between the open and close brackets.
+        template <class Func>
+        static void ReadItems(CharPtr &stream, Context &context, const char open, const char close, Func readItem)
+        {
+            SkipWhitespace(stream);
+            ReadExpectedChar(stream, open);
+
+            if( context.depth >= context.options.maxDepth )
+                throw std::runtime_error("nesting too deep");
+
+            ++context.depth;
+
+            SkipWhitespace(stream);
+            if( *stream != close )
+            {
+                for( ;; )
+                {
+                    readItem();
+
+                    SkipWhitespace(stream);
+                    if( *stream == ',' )
+                    {
+                        ++stream;
+                        continue;
+                    }
+
+                    break;
+                }
+            }
+
+            ReadExpectedChar(stream, close);
+            --context.depth;
+        }
+
+        // Calls readMember(key) with the stream at each member value. The key
+        // may live in scratch, so it is only valid until the value is read.
+        template <class Func>
+        static void ReadMembers(CharPtr &stream, Context &context, Func readMember)
+        {
+            ReadItems(stream, context, '{', '}', [&]
+            {
+                SkipWhitespace(stream);
+                if( *stream != '"' )
+                    throw std::runtime_error("string expected");
+
+                const StringView key = ReadString(stream, context);
+
+                SkipWhitespace(stream);
+                ReadExpectedChar(stream, ':');
+
+                readMember(key);
+            });
+        }
+
+        static void SkipValue(CharPtr &stream, Context &context)
+        {
+            SkipHandler handler;
+            ReadValue(stream, handler, context.scratch, NestedOptions(context));
+        }
+    };
+
+    // Structs registered with TinyJson_Fields. Members are matched by
+    // comparing against the compile-time key lengths first; unknown keys are
+    // skipped and missing ones leave the member untouched. Duplicate keys
+    // are rejected as Read rejects them.
+    template <class T, class Enable>
+    struct TypedReader : public TypedReaderBase
+    {
+        struct FieldReader
+        {
+            CharPtr &stream;
+            Context &context;
+            const StringView &key;
+
+            // One bit per field read so far; TinyJson_Fields takes at most 32.
+            std::uint32_t &seen;
+            std::uint32_t bit;
+            bool found;
+
+            template <std::size_t N, class F>
+            void operator ()(const char (&name)[N], F &field)
+            {
+                if( !found && key.size() == N - 1 && std::memcmp(key.data(), name, N - 1) == 0 )
+                {
+                    if( seen & bit )
+                        throw std::runtime_error("duplicate key: " + key.str());
+
+                    seen |= bit;
+                    found = true;
+                    TypedReader<F>::Read(stream, field, context);
+                }
+
+                bit <<= 1;
+            }
+        };
+
+        // One of 64 bits chosen by the length and end bytes of the key; the
+        // skipped keys are only searched when the bit was set before.
+        static std::uint64_t KeyBit(const StringView &key)
+        {
+            const std::size_t ends = key.empty() ? 0 : static_cast<unsigned char>(key[0]) * 7u + static_cast<unsigned char>(key[key.size() - 1]);
+            return std::uint64_t(1) << ((key.size() * 13 + ends) & 63);
+        }
+
+        static void SkipMember(CharPtr &stream, Context &context, const std::size_t firstSkipped, std::uint64_t &skippedBits, const StringView &key)
+        {
+            const std::uint64_t bit = KeyBit(key);
+
+            if( skippedBits & bit )
+            {
+                for( std::size_t i = firstSkipped; i < context.skippedKeys.size(); ++i )
+                    if( context.skippedKeys[i] == key )
+                        throw std::runtime_error("duplicate key: " + key.str());
+            }
+
+            skippedBits |= bit;
+
+            if( key.data() == context.scratch.data() )
+            {
+                context.escapedKeys.push_back(key.str());
+                context.skippedKeys.push_back(StringView(context.escapedKeys.back()));
+            }
+            else
+                context.skippedKeys.push_back(key);
+
+            SkipValue(stream, context);
+        }
+
+        static void Read(CharPtr &stream, T &value, Context &context)
+        {
+            std::uint32_t seen = 0;
+            std::uint64_t skippedBits = 0;
+            const std::size_t firstSkipped = context.skippedKeys.size();
+
+            ReadMembers(stream, context, [&](const StringView &key)
+            {
+                FieldReader reader = { stream, context, key, seen, 1, false };
+                TinyJson_VisitFields(value, reader);
+
+                if( !reader.found )
+                    SkipMember(stream, context, firstSkipped, skippedBits, key);
+            });
+
+            context.skippedKeys.resize(firstSkipped);
+        }
+    };
+
+    template <class T>
+    struct TypedReader<T, typename std::enable_if<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>::type> : public TypedReaderBase
+    {
+        static void Read(CharPtr &stream, T &value, Context &)
+        {
+            SkipWhitespace(stream);
+
+            const char ch = *stream;
+            if( ch != '-' && !IsDigit(ch) )
+                throw std::runtime_error("value is not a number");
+
+            value = ConvertTo<T>::From(ReadNumber(stream));
+        }
+    };
+
+    template <>
+    struct TypedReader<bool> : public TypedReaderBase
+    {
+        static void Read(CharPtr &stream, bool &value, Context &)
+        {
+            SkipWhitespace(stream);
+
+            if( *stream == 't' && TryReadExpectedString(stream, "true") )
+                value = true;
+            else if( *stream == 'f' && TryReadExpectedString(stream, "false") )
+                value = false;
+            else
+                throw std::runtime_error("value is not a boolean");
+        }
+    };
+
+    template <>
+    struct TypedReader<std::string> : public TypedReaderBase
+    {
+        static void Read(CharPtr &stream, std::string &value, Context &context)
+        {
+            SkipWhitespace(stream);
+            if( *stream != '"' )
+                throw std::runtime_error("value is not a string");
+
+            const StringView str = ReadString(stream, context);
+            value.assign(str.data(), str.size());
+        }
+    };
+
+    template <>
+    struct TypedReader<ValuePtr> : public TypedReaderBase
+    {
+        static void Read(CharPtr &stream, ValuePtr &value, Context &context)
+        {
+            value = ReadValue(stream, NestedOptions(context));
+        }
+    };
+
+    template <class Container>
+    struct TypedSequenceReader : public TypedReaderBase
+    {
+        static void Read(CharPtr &stream, Container &container, Context &context)
+        {
+            container.clear();
+
+            ReadItems(stream, context, '[', ']', [&]
+            {
+                typename Container::value_type item{};
+                TypedReader<typename Container::value_type>::Read(stream, item, context);
+                container.push_back(std::move(item));
+            });
+        }
+    };
+
+#define TinyJson_DefineTypedSequenceReader(X) \
+    template <class T> struct TypedReader<X<T>> : public TypedSequenceReader<X<T>> { }
+
+    TinyJson_DefineTypedSequenceReader(std::vector);
+    TinyJson_DefineTypedSequenceReader(std::deque);
+    TinyJson_DefineTypedSequenceReader(std::list);
+
+    template <class Container>
+    struct TypedAssociativeReader : public TypedReaderBase
+    {
+        static void Read(CharPtr &stream, Container &container, Context &context)
+        {
+            container.clear();
+
+            ReadMembers(stream, context, [&](const StringView &key)
+            {
+                const auto result = container.emplace(key.str(), typename Container::mapped_type());
+                if( !result.second )
+                    throw std::runtime_error("duplicate key: " + key.str());
+
+                TypedReader<typename Container::mapped_type>::Read(stream, result.first->second, context);
+            });
+        }
+    };
+
+#define TinyJson_DefineTypedAssociativeReader(X) \
+    template <class T> struct TypedReader<X<std::string, T>> : public TypedAssociativeReader<X<std::string, T>> { }
+
+    TinyJson_DefineTypedAssociativeReader(std::map);
+    TinyJson_DefineTypedAssociativeReader(std::unordered_map);
+
+    template <class T, class U>
+    struct TypedReader<std::pair<T, U>> : public TypedReaderBase
+    {
+        static void Read(CharPtr &stream, std::pair<T, U> &value, Context &context)
+        {
+            std::size_t count = 0;
+
+            ReadItems(stream, context, '[', ']', [&]
+            {
+                if( count == 0 )
+                    TypedReader<T>::Read(stream, value.first, context);
+                else if( count == 1 )
+                    TypedReader<U>::Read(stream, value.second, context);
+                else
+                    throw std::runtime_error("pair must contain exactly two items");
+
+                ++count;
+            });
+
+            if( count != 2 )
+                throw std::runtime_error("pair must contain exactly two items");
+        }
+    };
+
+    // Reads the next value of the stream into value. The limits of options
+    // apply as in Read, except maxNodes.
+    template <class T>
+    void ReadTo(CharPtr &stream, T &value, const ParseOptions &options = ParseOptions())
+    {
+        stream.LimitInput(options.maxInputBytes);
+
+        TypedReaderBase::Context context(options);
+        TypedReader<T>::Read(stream, value, context);
+    }
+
+    template <class T>
+    void ReadTo(const char *const pStr, T &value, const ParseOptions &options = ParseOptions())
+    {
+        auto stream = MakeStream(pStr);
+        ReadTo(stream, value, options);
+        Reader<CharPtr>::ReadEnd(stream);
+    }
+
+    template <class T>
+    void ReadTo(const std::string &str, T &value, const ParseOptions &options = ParseOptions())
+    {
+        auto stream = MakeStream(str);
+        ReadTo(stream, value, options);
+        Reader<CharPtr>::ReadEnd(stream);
+    }
+
+    template <class T>
+    T ReadAs(const char *const pStr, const ParseOptions &options = ParseOptions())
+    {
+        T value{};
+        ReadTo(pStr, value, options);
+
+        return value;
+    }
+
+    template <class T>
+    T ReadAs(const std::string &str, const ParseOptions &options = ParseOptions())
+    {
+        T value{};
+        ReadTo(str, value, options);
+
+        return value;
+    }
+
+    // Destination of serialized text. Writer buffers its output and hands
+    // it over in large blocks.
+    class Sink
+    {
+    public:
+        virtual ~Sink() =default;
+
+        virtual void Write(const char *pData, std::size_t length) =0;
+        virtual void Flush() { }
+    };
+
+    class StringSink : public Sink
+    {
+        std::string &str;
+
+    public:
+        explicit StringSink(std::string &str_) :
+            str(str_)
+        {
+        }
+
+        void Write(const char *const pData, const std::size_t length) override
+        {
+            str.append(pData, length);
+        }
+    };
+
+    // Writes into caller-owned memory and throws when the output does not fit.
+    class BufferSink : public Sink
+    {
+        char *pBuffer;
+        std::size_t capacity;
+        std::size_t length;
+
+    public:
+        explicit BufferSink(char *const pBuffer_, const std::size_t capacity_) :
+            pBuffer(pBuffer_),
+            capacity(capacity_),
+            length(0)
+        {
+        }
+
+        void Write(const char *const pData, const std::size_t size) override
+        {
+            if( size > capacity - length )
+                throw std::runtime_error("buffer too small");
+
+            std::memcpy(pBuffer + length, pData, size);
+            length += size;
+        }
+
+        const char *data() const
+        {
+            return pBuffer;
+        }
+
+        std::size_t size() const
+        {
+            return length;
+        }
+    };
+
+    class FileSink : public Sink
+    {
+        std::FILE *pFile;
+
+    public:
+        explicit FileSink(std::FILE *const pFile_) :
+            pFile(pFile_)
+        {
+        }
+
+        void Write(const char *const pData, const std::size_t length) override
+        {
+            if( std::fwrite(pData, 1, length, pFile) != length )
+                throw std::runtime_error("failed to write file");
+        }
+
+        void Flush() override
+        {
+            if( std::fflush(pFile) != 0 )
+                throw std::runtime_error("failed to write file");
+        }
+    };
+
+    class FdSink : public Sink
+    {
+        int fd;
+
+    public:
+        explicit FdSink(const int fd_) :
+            fd(fd_)
+        {
+        }
+
+        void Write(const char *pData, std::size_t length) override
+        {
+            while( length != 0 )
+            {
+#ifdef _WIN32
+                const int chunk = static_cast<int>(std::min<std::size_t>(length, 1 << 30));
+                const int written = ::_write(fd, pData, static_cast<unsigned int>(chunk));
+#else
+                const ssize_t written = ::write(fd, pData, length);
+#endif
+                if( written < 0 )
+                {
+                    if( errno == EINTR )
+                        continue;
+
+                    throw std::runtime_error("failed to write file descriptor");
+                }
+
+                pData += written;
+                length -= static_cast<std::size_t>(written);
+            }
+        }
+    };
+
+    // Output staged in front of a sink, so that small writes reach it in
+    // blocks of BufferSize bytes. Large writes bypass the buffer.
+    class SinkBuffer
+    {
+        static const std::size_t BufferSize = 4096;
+
+        Sink &sink;
+        char buffer[BufferSize];
+        std::size_t used;
+
+    public:
+        explicit SinkBuffer(Sink &sink_) :
+            sink(sink_),
+            used(0)
+        {
+        }
+
+        SinkBuffer(const SinkBuffer &) =delete;
+        void operator =(const SinkBuffer &) =delete;
+
+        void Put(const char ch)
+        {
+            if( used == BufferSize )
+                Flush();
+
+            buffer[used++] = ch;
+        }
+
+        void Append(const char *const pData, const std::size_t length)
+        {
+            if( length > BufferSize - used )
+            {
+                Flush();
+
+                if( length >= BufferSize )
+                {
+                    sink.Write(pData, length);
+                    return;
+                }
+            }
+
+            std::memcpy(buffer + used, pData, length);
+            used += length;
+        }
+
+        void Fill(const char ch, std::size_t count)
+        {
+            while( count != 0 )
+            {
+                if( used == BufferSize )
+                    Flush();
+
+                const std::size_t length = std::min(count, BufferSize - used);
+                std::memset(buffer + used, ch, length);
+                used += length;
+                count -= length;
+            }
+        }
+
+        // Room for length bytes, which must not exceed BufferSize; Commit
+        // then marks how many were written.
+        char *Reserve(const std::size_t length)
+        {
+            if( length > BufferSize - used )
+                Flush();
+
+            return buffer + used;
+        }
+
+        void Commit(const char *const pEnd)
+        {
+            used = static_cast<std::size_t>(pEnd - buffer);
+        }
+
+        // Drops the bytes not yet passed to the sink.
+        void Clear()
+        {
+            used = 0;
+        }
+
+        // Passes the buffered bytes to the sink without flushing the sink.
+        void Flush()
+        {
+            if( used != 0 )
+                sink.Write(buffer, used);
+
+            used = 0;
+        }
+
+        Sink &GetSink()
+        {
+            return sink;
+        }
+    };
+
+    // Origin of input that is read in chunks, such as a file too large to
+    // hold in memory.
+    class Source
+    {
+    public:
+        virtual ~Source() =default;
+
+        // Reads up to capacity bytes into pBuffer. Returns 0 only at the end
+        // of the input.
+        virtual std::size_t Read(char *pBuffer, std::size_t capacity) =0;
+    };
+
+    class FileSource : public Source
+    {
+        std::FILE *pFile;
+
+    public:
+        explicit FileSource(std::FILE *const pFile_) :
+            pFile(pFile_)
+        {
+        }
+
+        std::size_t Read(char *const pBuffer, const std::size_t capacity) override
+        {
+            const std::size_t length = std::fread(pBuffer, 1, capacity, pFile);
+            if( length == 0 && std::ferror(pFile) )
+                throw std::runtime_error("failed to read file");
+
+            return length;
+        }
+    };
+
+    class FdSource : public Source
+    {
+        int fd;
+
+    public:
+        explicit FdSource(const int fd_) :
+            fd(fd_)
+        {
+        }
+
+        std::size_t Read(char *const pBuffer, const std::size_t capacity) override
+        {
+            for( ;; )
+            {
+#ifdef _WIN32
+                const int chunk = static_cast<int>(std::min<std::size_t>(capacity, 1 << 30));
+                const int length = ::_read(fd, pBuffer, static_cast<unsigned int>(chunk));
+#else
+                const ssize_t length = ::read(fd, pBuffer, capacity);
+#endif
+                if( length >= 0 )
+                    return static_cast<std::size_t>(length);
+
+                if( errno != EINTR )
+                    throw std::runtime_error("failed to read file descriptor");
+            }
+        }
+    };
+
+    // Shortest decimal representation of a double or float that reads back
+    // to the same value, using Grisu2. A few rare values get one digit more
+    // than the optimum, but the output always round-trips.
+    class DoubleFormatter
+    {
+        struct DiyFp
+        {
+            std::uint64_t f;
+            int e;
+
+            DiyFp(const std::uint64_t f_, const int e_) :
+                f(f_),
+                e(e_)
+            {
+            }
+
+            DiyFp Normalize() const
+            {
+                const int shift = CountLeadingZeros64(f);
+                return DiyFp(f << shift, e - shift);
+            }
+
+            DiyFp operator -(const DiyFp &other) const
+            {
+                return DiyFp(f - other.f, e);
+            }
+
+            DiyFp operator *(const DiyFp &other) const
+            {
+                std::uint64_t high, low;
+                Multiply64(f, other.f, high, low);
+
+                return DiyFp(high + (low >> 63), e + other.e + 64);
+            }
+        };
+
+        static const std::uint64_t *PowersOfTen()
+        {
+            static const std::uint64_t table[] =
+            {
+                0xfa8fd5a0081c0288, 0xbaaee17fa23ebf76, 0x8b16fb203055ac76, 0xcf42894a5dce35ea,
+                0x9a6bb0aa55653b2d, 0xe61acf033d1a45df, 0xab70fe17c79ac6ca, 0xff77b1fcbebcdc4f,
+                0xbe5691ef416bd60c, 0x8dd01fad907ffc3c, 0xd3515c2831559a83, 0x9d71ac8fada6c9b5,
+                0xea9c227723ee8bcb, 0xaecc49914078536d, 0x823c12795db6ce57, 0xc21094364dfb5637,
+                0x9096ea6f3848984f, 0xd77485cb25823ac7, 0xa086cfcd97bf97f4, 0xef340a98172aace5,
+                0xb23867fb2a35b28e, 0x84c8d4dfd2c63f3b, 0xc5dd44271ad3cdba, 0x936b9fcebb25c996,
+                0xdbac6c247d62a584, 0xa3ab66580d5fdaf6, 0xf3e2f893dec3f126, 0xb5b5ada8aaff80b8,
+                0x87625f056c7c4a8b, 0xc9bcff6034c13053, 0x964e858c91ba2655, 0xdff9772470297ebd,
+                0xa6dfbd9fb8e5b88f, 0xf8a95fcf88747d94, 0xb94470938fa89bcf, 0x8a08f0f8bf0f156b,
+                0xcdb02555653131b6, 0x993fe2c6d07b7fac, 0xe45c10c42a2b3b06, 0xaa242499697392d3,
+                0xfd87b5f28300ca0e, 0xbce5086492111aeb, 0x8cbccc096f5088cc, 0xd1b71758e219652c,
+                0x9c40000000000000, 0xe8d4a51000000000, 0xad78ebc5ac620000, 0x813f3978f8940984,
+                0xc097ce7bc90715b3, 0x8f7e32ce7bea5c70, 0xd5d238a4abe98068, 0x9f4f2726179a2245,
+                0xed63a231d4c4fb27, 0xb0de65388cc8ada8, 0x83c7088e1aab65db, 0xc45d1df942711d9a,
+                0x924d692ca61be758, 0xda01ee641a708dea, 0xa26da3999aef774a, 0xf209787bb47d6b85,
+                0xb454e4a179dd1877, 0x865b86925b9bc5c2, 0xc83553c5c8965d3d, 0x952ab45cfa97a0b3,
+                0xde469fbd99a05fe3, 0xa59bc234db398c25, 0xf6c69a72a3989f5c, 0xb7dcbf5354e9bece,
+                0x88fcf317f22241e2, 0xcc20ce9bd35c78a5, 0x98165af37b2153df, 0xe2a0b5dc971f303a,
+                0xa8d9d1535ce3b396, 0xfb9b7cd9a4a7443c, 0xbb764c4ca7a44410, 0x8bab8eefb6409c1a,
+                0xd01fef10a657842c, 0x9b10a4e5e9913129, 0xe7109bfba19c0c9d, 0xac2820d9623bf429,
+                0x80444b5e7aa7cf85, 0xbf21e44003acdd2d, 0x8e679c2f5e44ff8f, 0xd433179d9c8cb841,
+                0x9e19db92b4e31ba9, 0xeb96bf6ebadf77d9, 0xaf87023b9bf0ee6b
+            };
+
+            return table;
+        }
+
+        // Binary exponents of 10^k for k = -348 + 8 * index.
+        static const std::int16_t *PowersOfTenExponents()
+        {
+            static const std::int16_t table[] =
+            {
+                -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+                -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+                -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+                -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+                56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+                375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+                694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+                1013, 1039, 1066
+            };
+
+            return table;
+        }
+
+        static std::uint64_t Pow10(const int exponent)
+        {
+            static const std::uint64_t table[] =
+            {
+                1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+                1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+                100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+                1000000000000000000ull, 10000000000000000000ull
+            };
+
+            return exponent < 20 ? table[exponent] : 0;
+        }
+
+        // Picks 10^-k so that the scaled value has a binary exponent in [-60, -32].
+        static DiyFp CachedPower(const int e, int &k)
+        {
+            const double dk = (-61 - e) * 0.30102999566398114 + 347;
+            int ik = static_cast<int>(dk);
+            if( dk - ik > 0.0 )
+                ++ik;
+
+            const int index = (ik >> 3) + 1;
+            k = -(-348 + index * 8);
+
+            return DiyFp(PowersOfTen()[index], PowersOfTenExponents()[index]);
+        }
+
+        static void Round(char *const pDigits, const int length, const std::uint64_t delta, std::uint64_t rest,
+            const std::uint64_t tenKappa, const std::uint64_t distance)
+        {
+            while( rest < distance && delta - rest >= tenKappa &&
+                (rest + tenKappa < distance || distance - rest > rest + tenKappa - distance) )
+            {
+                --pDigits[length - 1];
+                rest += tenKappa;
+            }
+        }
+
+        static int GenerateDigits(const DiyFp &w, const DiyFp &upper, std::uint64_t delta, char *const pDigits, int &k)
+        {
+            const DiyFp one(std::uint64_t(1) << -upper.e, upper.e);
+            const std::uint64_t distance = (upper - w).f;
+
+            std::uint32_t integral = static_cast<std::uint32_t>(upper.f >> -one.e);
+            std::uint64_t fraction = upper.f & (one.f - 1);
+
+            int kappa = 0;
+            while( kappa < 10 && integral >= Pow10(kappa) )
+                ++kappa;
+
+            int length = 0;
+            while( kappa > 0 )
+            {
+                const std::uint32_t divisor = static_cast<std::uint32_t>(Pow10(kappa - 1));
+                const std::uint32_t digit = integral / divisor;
+                integral %= divisor;
+
+                if( digit || length )
+                    pDigits[length++] = static_cast<char>('0' + digit);
+
+                --kappa;
+
+                const std::uint64_t rest = (static_cast<std::uint64_t>(integral) << -one.e) + fraction;
+                if( rest <= delta )
+                {
+                    k += kappa;
+                    Round(pDigits, length, delta, rest, Pow10(kappa) << -one.e, distance);
+                    return length;
+                }
+            }
+
+            for( ;; )
+            {
+                fraction *= 10;
+                delta *= 10;
+
+                const char digit = static_cast<char>(fraction >> -one.e);
+                if( digit || length )
+                    pDigits[length++] = static_cast<char>('0' + digit);
+
+                fraction &= one.f - 1;
+                --kappa;
+
+                if( fraction < delta )
+                {
+                    k += kappa;
+                    Round(pDigits, length, delta, fraction, one.f, distance * Pow10(-kappa));
+                    return length;
+                }
+            }
+        }
+
+        // Writes the digits of a positive finite value v, with a significand
+        // of the given width, and returns their count; the value is
+        // digits * 10^k. The digits stay within half a unit of v in that
+        // width, so a float gets the digits a float needs, not a double's.
+        static int Grisu2(const DiyFp &v, const int significandBits, char *const pDigits, int &k)
+        {
+            const DiyFp upper = DiyFp((v.f << 1) + 1, v.e - 1).Normalize();
+            DiyFp lower = v.f == (std::uint64_t(1) << significandBits) ? DiyFp((v.f << 2) - 1, v.e - 2) : DiyFp((v.f << 1) - 1, v.e - 1);
+            lower = DiyFp(lower.f << (lower.e - upper.e), upper.e);
+
+            const DiyFp power = CachedPower(upper.e, k);
+            const DiyFp w = v.Normalize() * power;
+            DiyFp scaledUpper = upper * power;
+            DiyFp scaledLower = lower * power;
+            ++scaledLower.f;
+            --scaledUpper.f;
+
+            return GenerateDigits(w, scaledUpper, scaledUpper.f - scaledLower.f, pDigits, k);
+        }
+
+        static int Grisu2(const double value, char *const pDigits, int &k)
+        {
+            std::uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+
+            const std::uint64_t fractionBits = bits & ((std::uint64_t(1) << 52) - 1);
+            const int biasedExponent = static_cast<int>(bits >> 52) & 0x7FF;
+
+            const DiyFp v = biasedExponent != 0
+                ? DiyFp(fractionBits | (std::uint64_t(1) << 52), biasedExponent - 1075)
+                : DiyFp(fractionBits, -1074);
+
+            return Grisu2(v, 52, pDigits, k);
+        }
+
+        static int Grisu2(const float value, char *const pDigits, int &k)
+        {
+            std::uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+
+            const std::uint32_t fractionBits = bits & ((std::uint32_t(1) << 23) - 1);
+            const int biasedExponent = static_cast<int>(bits >> 23) & 0xFF;
+
+            const DiyFp v = biasedExponent != 0
+                ? DiyFp(fractionBits | (std::uint32_t(1) << 23), biasedExponent - 150)
+                : DiyFp(fractionBits, -149);
+
+            return Grisu2(v, 23, pDigits, k);
+        }
+
+        static char *WriteExponent(int exponent, char *ptr)
+        {
+            *ptr++ = 'e';
+            if( exponent < 0 )
+            {
+                *ptr++ = '-';
+                exponent = -exponent;
+            }
+
+            if( exponent >= 100 )
+                *ptr++ = static_cast<char>('0' + exponent / 100);
+
+            if( exponent >= 10 )
+                *ptr++ = static_cast<char>('0' + exponent / 10 % 10);
+
+            *ptr++ = static_cast<char>('0' + exponent % 10);
+
+            return ptr;
+        }
+
+        template <class T>
+        static char *FormatValue(const T value, char *ptr)
+        {
+            if( !std::isfinite(value) )
+                throw std::runtime_error("cannot write a non-finite number");
+
+            if( std::signbit(value) )
+                *ptr++ = '-';
+
+            if( value == 0 )
+            {
+                std::memcpy(ptr, "0.0", 3);
+                return ptr + 3;
+            }
+
+            char digits[20];
+            int k;
+            const int length = Grisu2(std::fabs(value), digits, k);
+            const int point = length + k;
+
+            if( k >= 0 && point <= 21 )
+            {
+                std::memcpy(ptr, digits, static_cast<std::size_t>(length));
+                ptr += length;
+                std::memset(ptr, '0', static_cast<std::size_t>(k));
+                ptr += k;
+                std::memcpy(ptr, ".0", 2);
+                return ptr + 2;
+            }
+
+            if( point > 0 && point <= 21 )
+            {
+                std::memcpy(ptr, digits, static_cast<std::size_t>(point));
+                ptr += point;
+                *ptr++ = '.';
+                std::memcpy(ptr, digits + point, static_cast<std::size_t>(length - point));
+                return ptr + length - point;
+            }
+
+            if( point > -6 && point <= 0 )
+            {
+                *ptr++ = '0';
+                *ptr++ = '.';
+                std::memset(ptr, '0', static_cast<std::size_t>(-point));
+                ptr += -point;
+                std::memcpy(ptr, digits, static_cast<std::size_t>(length));
+                return ptr + length;
+            }
+
+            *ptr++ = digits[0];
+            if( length > 1 )
+            {
+                *ptr++ = '.';
+                std::memcpy(ptr, digits + 1, static_cast<std::size_t>(length - 1));
+                ptr += length - 1;
+            }
+
+            return WriteExponent(point - 1, ptr);
+        }
+
+    public:
+        // Longest output is "-1.2345678901234567e-308".
+        static const std::size_t MaxLength = 32;
+
+        // Writes at most MaxLength characters and returns the end. Integral
+        // values keep a ".0" so they read back as doubles.
+        static char *Format(const double value, char *ptr)
+        {
+            return FormatValue(value, ptr);
+        }
+
+        // Shortest digits that read back to the same float. Read as a
+        // double they give the nearest double to those digits, which
+        // converts back to the float.
+        static char *Format(const float value, char *ptr)
+        {
+            return FormatValue(value, ptr);
+        }
+    };
+
+    struct WriteOptions
+    {
+        bool pretty;
+
+        // Spaces per nesting level in pretty mode.
+        unsigned indent;
+
+        WriteOptions() :
+            pretty(false),
+            indent(4)
+        {
+        }
+    };
+
+    // Serializes events to a sink. It is itself a handler, so any reader can
+    // drive it. Output is buffered until Flush.
+    class Writer : public HandlerBase<Writer>
+    {
+        SinkBuffer out;
+        WriteOptions options;
+        std::vector<bool> hasItems;
+        bool afterKey;
+
+        void Put(const char ch)
+        {
+            out.Put(ch);
+        }
+
+        void Append(const char *const pData, const std::size_t length)
+        {
+            out.Append(pData, length);
+        }
+
+        void NewLine()
+        {
+            Put('\n');
+            out.Fill(' ', hasItems.size() * options.indent);
+        }
+
+        void BeginValue()
+        {
+            if( afterKey )
+            {
+                afterKey = false;
+                return;
+            }
+
+            if( hasItems.empty() )
+                return;
+
+            if( hasItems.back() )
+                Put(',');
+
+            hasItems.back() = true;
+
+            if( options.pretty )
+                NewLine();
+        }
+
+        // Strings must be well-formed UTF-8, as the reader requires; other
+        // bytes would produce output that no conforming reader accepts.
+        void WriteString(const StringView &str)
+        {
+            static const char hex[] = "0123456789abcdef";
+
+            const char *ptr = str.data();
+            const char *const end = ptr + str.size();
+
+            Put('"');
+
+            for( ;; )
+            {
+                const char *const special = Utf8Validator::FindInString(ptr, end);
+                if( !special )
+                    throw std::runtime_error("invalid UTF-8");
+
+                Append(ptr, static_cast<std::size_t>(special - ptr));
+
+                if( special == end )
+                    break;
+
+                const char ch = *special;
+                ptr = special + 1;
+
+                Put('\\');
+                switch( ch )
+                {
+                    case '"': Put('"'); break;
+                    case '\\': Put('\\'); break;
+                    case '\b': Put('b'); break;
+                    case '\f': Put('f'); break;
+                    case '\n': Put('n'); break;
+                    case '\r': Put('r'); break;
+                    case '\t': Put('t'); break;
+
+                    default:
+                        Append("u00", 3);
+                        Put(hex[static_cast<unsigned char>(ch) >> 4]);
+                        Put(hex[ch & 0xF]);
+                        break;
+                }
+            }
+
+            Put('"');
+        }
+
+        template <class T>
+        void WriteUnsigned(T value)
+        {
+            char digits[20];
+            char *const end = digits + sizeof(digits);
+            char *ptr = end;
+
+            do
+            {
+                *--ptr = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+            while( value != 0 );
+
+            Append(ptr, static_cast<std::size_t>(end - ptr));
+        }
+
+        void EndContainer(const char ch)
+        {
+            const bool items = hasItems.back();
+            hasItems.pop_back();
+
+            if( options.pretty && items )
+                NewLine();
+
+            Put(ch);
+        }
+
+    public:
+        explicit Writer(Sink &sink_, const WriteOptions &options_ = WriteOptions()) :
+            out(sink_),
+            options(options_),
+            afterKey(false)
+        {
+        }
+
+        Writer(const Writer &) =delete;
+        void operator =(const Writer &) =delete;
+
+        // Passes the buffered output to the sink and flushes it.
+        void Flush()
+        {
+            out.Flush();
+            out.GetSink().Flush();
+        }
+
+        void Null()
+        {
+            BeginValue();
+            Append("null", 4);
+        }
+
+        void Bool(const bool value)
+        {
+            BeginValue();
+
+            if( value )
+                Append("true", 4);
+            else
+                Append("false", 5);
+        }
+
+        void Number(const double value)
+        {
+            BeginValue();
+            out.Commit(DoubleFormatter::Format(value, out.Reserve(DoubleFormatter::MaxLength)));
+        }
+
+        // Writes the shortest form that reads back to the same float, which
+        // is usually shorter than the same value written as a double.
+        void Float(const float value)
+        {
+            BeginValue();
+            out.Commit(DoubleFormatter::Format(value, out.Reserve(DoubleFormatter::MaxLength)));
+        }
+
+        void Int64(const std::int64_t value)
+        {
+            BeginValue();
+
+            if( value < 0 )
+            {
+                Put('-');
+                WriteUnsigned(0 - static_cast<std::uint64_t>(value));
+            }
+            else
+                WriteUnsigned(static_cast<std::uint64_t>(value));
+        }
+
+        void UInt64(const std::uint64_t value)
+        {
+            BeginValue();
+            WriteUnsigned(value);
+        }
+
+        void String(const StringView &str, bool = false)
+        {
+            BeginValue();
+            WriteString(str);
+        }
+
+        void Key(const StringView &key, bool = false)
+        {
+            BeginValue();
+            WriteString(key);
+
+            Put(':');
+            if( options.pretty )
+                Put(' ');
+
+            afterKey = true;
+        }
+
+        void StartArray()
+        {
+            BeginValue();
+            Put('[');
+            hasItems.push_back(false);
+        }
+
+        void EndArray(std::size_t = 0)
+        {
+            EndContainer(']');
+        }
+
+        void StartObject()
+        {
+            BeginValue();
+            Put('{');
+            hasItems.push_back(false);
+        }
+
+        void EndObject(std::size_t = 0)
+        {
+            EndContainer('}');
+        }
+
+        void WriteValue(const ValuePtr &value)
+        {
+            switch( value->Type() )
+            {
+                case ValueType::Null:
+                    Null();
+                    break;
+
+                case ValueType::Number:
+                    if( value->IsInt64() )
+                        Int64(value->AsInt64());
+                    else if( value->IsUInt64() )
+                        UInt64(value->AsUInt64());
+                    else
+                        Number(value->AsNumber());
+                    break;
+
+                case ValueType::String:
+                    String(value->AsString());
+                    break;
+
+                case ValueType::Array:
+                    StartArray();
+                    for( const auto &item: value->AsArray() )
+                        WriteValue(item);
+                    EndArray();
+                    break;
+
+                case ValueType::Object:
+                    StartObject();
+                    for( const auto &entry: value->AsObject() )
+                    {
+                        Key(entry.first);
+                        WriteValue(entry.second);
+                    }
+                    EndObject();
+                    break;
+
+                case ValueType::Boolean:
+                    Bool(value->AsBoolean());
+                    break;
+            }
+        }
+
+        void WriteValue(const Value &value)
+        {
+            switch( value.Type() )
+            {
+                case ValueType::Null:
+                    Null();
+                    break;
+
+                case ValueType::Number:
+                    if( value.IsInt64() )
+                        Int64(value.AsInt64());
+                    else if( value.IsUInt64() )
+                        UInt64(value.AsUInt64());
+                    else
+                        Number(value.AsNumber());
+                    break;
+
+                case ValueType::String:
+                    String(value.AsString());
+                    break;
+
+                case ValueType::Array:
+                    StartArray();
+                    for( const auto &item: value.AsArray() )
+                        WriteValue(item);
+                    EndArray();
+                    break;
+
+                case ValueType::Object:
+                    StartObject();
+                    for( const auto &member: value.AsObject() )
+                    {
+                        Key(member.key.AsString());
+                        WriteValue(member.value);
+                    }
+                    EndObject();
+                    break;
+
+                case ValueType::Boolean:
+                    Bool(value.AsBoolean());
+                    break;
+            }
+        }
+    };
+
+    // The reverse of ConvertTo: ConvertFrom<T>::To(value, writer) emits a T
+    // without building a tree first. Structs registered with TinyJson_Fields
+    // are written as objects.
+    template <class T>
+    struct ConvertFrom
+    {
+        struct FieldWriter
+        {
+            Writer &writer;
+
+            template <std::size_t N, class F>
+            void operator ()(const char (&name)[N], const F &field) const
+            {
+                writer.Key(StringView(name, N - 1));
+                ConvertFrom<F>::To(field, writer);
+            }
+        };
+
+        static void To(const T &value, Writer &writer)
+        {
+            writer.StartObject();
+
+            const FieldWriter fieldWriter = { writer };
+            TinyJson_VisitFields(value, fieldWriter);
+
+            writer.EndObject();
+        }
+    };
+
+    template <class T>
+    struct ConvertFromNumber
+    {
+        static void ToNumber(const T &value, Writer &writer, std::true_type, std::true_type)
+        {
+            writer.Int64(static_cast<std::int64_t>(value));
+        }
+
+        static void ToNumber(const T &value, Writer &writer, std::true_type, std::false_type)
+        {
+            writer.UInt64(static_cast<std::uint64_t>(value));
+        }
+
+        template <class Signed>
+        static void ToNumber(const T &value, Writer &writer, std::false_type, Signed)
+        {
+            WriteFloating(value, writer);
+        }
+
+        static void WriteFloating(const float value, Writer &writer)
+        {
+            writer.Float(value);
+        }
+
+        static void WriteFloating(const double value, Writer &writer)
+        {
+            writer.Number(value);
+        }
+
+        static void To(const T &value, Writer &writer)
+        {
+            ToNumber(value, writer, std::is_integral<T>(), std::is_signed<T>());
+        }
+    };
+
+#define TinyJson_DefineConvertFromNumber(X) \
+    template <> struct ConvertFrom<X> : public ConvertFromNumber<X> { }
+
+    TinyJson_DefineConvertFromNumber(int);
+    TinyJson_DefineConvertFromNumber(unsigned int);
+    TinyJson_DefineConvertFromNumber(short);
+    TinyJson_DefineConvertFromNumber(unsigned short);
+    TinyJson_DefineConvertFromNumber(long);
+    TinyJson_DefineConvertFromNumber(unsigned long);
+    TinyJson_DefineConvertFromNumber(long long);
+    TinyJson_DefineConvertFromNumber(unsigned long long);
+    TinyJson_DefineConvertFromNumber(float);
+    TinyJson_DefineConvertFromNumber(double);
+
+    template <>
+    struct ConvertFrom<bool>
+    {
+        static void To(const bool value, Writer &writer)
+        {
+            writer.Bool(value);
+        }
+    };
+
+    template <>
+    struct ConvertFrom<std::string>
+    {
+        static void To(const std::string &value, Writer &writer)
+        {
+            writer.String(value);
+        }
+    };
+
+    template <>
+    struct ConvertFrom<StringView>
+    {
+        static void To(const StringView &value, Writer &writer)
+        {
+            writer.String(value);
+        }
+    };
+
+    template <>
+    struct ConvertFrom<const char *>
+    {
+        static void To(const char *const value, Writer &writer)
+        {
+            writer.String(value);
+        }
+    };
+
+    template <std::size_t N>
+    struct ConvertFrom<char[N]> : public ConvertFrom<const char *> { };
+
+    template <>
+    struct ConvertFrom<ValuePtr>
+    {
+        static void To(const ValuePtr &value, Writer &writer)
+        {
+            writer.WriteValue(value);
+        }
+    };
+
+    template <>
+    struct ConvertFrom<Value>
+    {
+        static void To(const Value &value, Writer &writer)
+        {
+            writer.WriteValue(value);
+        }
+    };
+
+    template <class Container>
+    struct ConvertFromSequenceContainer
+    {
+        static void To(const Container &container, Writer &writer)
+        {
+            writer.StartArray();
+
+            for( const auto &item: container )
+                ConvertFrom<typename Container::value_type>::To(item, writer);
+
+            writer.EndArray(container.size());
+        }
+    };
+
+#define TinyJson_DefineConvertFromSequenceContainer(X) \
+    template <class T> struct ConvertFrom<X<T>> : public ConvertFromSequenceContainer<X<T>> { }
+
+    TinyJson_DefineConvertFromSequenceContainer(std::vector);
+    TinyJson_DefineConvertFromSequenceContainer(std::deque);
+    TinyJson_DefineConvertFromSequenceContainer(std::list);
+
+    template <class Container>
+    struct ConvertFromAssociativeContainer
+    {
+        static void To(const Container &container, Writer &writer)
+        {
+            writer.StartObject();
+
+            for( const auto &entry: container )
+            {
+                writer.Key(entry.first);
+                ConvertFrom<typename Container::mapped_type>::To(entry.second, writer);
+            }
+
+            writer.EndObject(container.size());
+        }
+    };
+
+#define TinyJson_DefineConvertFromAssociativeContainer(X) \
+    template <class T> struct ConvertFrom<X<std::string, T>> : public ConvertFromAssociativeContainer<X<std::string, T>> { }
+
+    TinyJson_DefineConvertFromAssociativeContainer(std::map);
+    TinyJson_DefineConvertFromAssociativeContainer(std::unordered_map);
+
+    template <class T, class U>
+    struct ConvertFrom<std::pair<T, U>>
+    {
+        static void To(const std::pair<T, U> &value, Writer &writer)
+        {
+            writer.StartArray();
+            ConvertFrom<T>::To(value.first, writer);
+            ConvertFrom<U>::To(value.second, writer);
+            writer.EndArray(2);
+        }
+    };
+
+    template <class T>
+    void Write(const T &value, Sink &sink, const WriteOptions &options = WriteOptions())
+    {
+        Writer writer(sink, options);
+        ConvertFrom<T>::To(value, writer);
+        writer.Flush();
+    }
+
+    template <class T>
+    std::string ToString(const T &value, const WriteOptions &options = WriteOptions())
+    {
+        std::string str;
+        StringSink sink(str);
+        Write(value, sink, options);
+
+        return str;
+    }
+
+    // Rewrites JSON text with new whitespace in one pass, without building
+    // a tree: compact by default, indented as Writer does when
+    // options.pretty is set. Input is fed in chunks as with PushParser and
+    // checked as Validate does. Tokens are copied verbatim, so strings keep
+    // their escapes and numbers their digits, even beyond the range of a
+    // double. Memory is bounded by the nesting depth and the longest
+    // number, never by the input size. The maxDepth, maxNodes and
+    // maxInputBytes limits apply; strings are not decoded, so
+    // maxStringLength does not.
+    class Transcoder : private Reader<CharPtr>
+    {
+        enum class State : std::uint8_t
+        {
+            Value,
+            ArrayFirst,
+            ObjectFirst,
+            ObjectKey,
+            Colon,
+            AfterValue,
+            String,
+            Escape,
+            Sequence,
+            Number,
+            Literal,
+            Done
+        };
+
+        SinkBuffer out;
+        WriteOptions options;
+        ParseOptions parseOptions;
+        State state;
+        ContainerStack stack;
+
+        // The number or the escape being read when it spans Feed calls.
+        std::string token;
+        String scratch;
+
+        // Leading bytes of a multi-byte character split across Feed calls.
+        char sequence[4];
+        std::size_t sequenceLength;
+
+        bool stringIsKey;
+        const char *pLiteral;
+        const char *pExpected;
+        std::size_t nodes;
+        std::size_t inputBytes;
+
+        static bool IsNumberChar(const char ch)
+        {
+            return IsDigit(ch) || ch == '-' || ch == '+' || ch == '.' || ch == 'e' || ch == 'E';
+        }
+
+        static const char *SkipDigits(const char *ptr, const char *const end)
+        {
+            while( ptr != end && IsDigit(*ptr) )
+                ++ptr;
 
-            return ReadString(itr);
+            return ptr;
         }
 
-        static Object ReadObject(Itr &itr)
+        // True if [ptr, end) is one number token.
+        static bool IsNumber(const char *ptr, const char *const end)
         {
-            assert(*itr == '{');
-            ++itr;
+            if( ptr != end && *ptr == '-' )
+                ++ptr;
 
-            Object obj;
+            if( ptr == end || !IsDigit(*ptr) )
+                return false;
 
-            for( ;; )
+            ptr = *ptr == '0' ? ptr + 1 : SkipDigits(ptr, end);
+
+            if( ptr != end && *ptr == '.' )
             {
-                auto key = ReadKey(itr);
+                const char *const fraction = ++ptr;
+                if( (ptr = SkipDigits(ptr, end)) == fraction )
+                    return false;
+            }
 
-                SkipWhitespace(itr);
-                ReadExpectedChar(itr, ':');
+            if( ptr != end && (*ptr == 'e' || *ptr == 'E') )
+            {
+                if( ++ptr != end && (*ptr == '+' || *ptr == '-') )
+                    ++ptr;
 
-                auto value = ReadValue(itr);
+                const char *const exponent = ptr;
+                if( (ptr = SkipDigits(ptr, end)) == exponent )
+                    return false;
+            }
 
-                if( !obj.emplace(std::move(key), std::move(value)).second )
-                    throw std::runtime_error("duplicate key: " + key);
+            return ptr == end;
+        }
 
-                SkipWhitespace(itr);
-                if( *itr == ',' )
-                {
-                    ++itr;
+        static std::size_t SequenceLength(const unsigned char lead)
+        {
+            return lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+        }
+
+        // Start of a multi-byte character that the end of the chunk cuts
+        // off, or end if the last one is complete.
+        static const char *FindCutSequence(const char *const ptr, const char *const end)
+        {
+            for( std::ptrdiff_t back = 1; back <= 3 && back <= end - ptr; ++back )
+            {
+                const unsigned char ch = static_cast<unsigned char>(end[-back]);
+                if( (ch & 0xC0) == 0x80 )
                     continue;
-                }
 
-                ReadExpectedChar(itr, '}');
-                break;
+                return static_cast<std::ptrdiff_t>(SequenceLength(ch)) > back ? end - back : end;
             }
 
-            return obj;
+            return end;
         }
 
-    public:
-        static ValuePtr ReadValue(Itr &itr)
+        void NewLine()
         {
-            SkipWhitespace(itr);
+            out.Put('\n');
+            out.Fill(' ', stack.Size() * options.indent);
+        }
 
-            switch( *itr )
+        void ValueDone()
+        {
+            if( stack.Empty() )
             {
-                case '-':
-                case TinyJson_Digits_0_9:
-                    return CreateValue<NumberValue>(ReadNumber(itr));
+                state = State::Done;
+                return;
+            }
 
-                case '"':
-                    return CreateValue<StringValue>(ReadString(itr));
+            ++stack.Top().count;
+            state = State::AfterValue;
+        }
 
-                case '[':
-                    return CreateValue<ArrayValue>(ReadArray(itr));
+        void BeginString(const bool isKey)
+        {
+            out.Put('"');
+            stringIsKey = isKey;
+            state = State::String;
+        }
 
-                case '{':
-                    return CreateValue<ObjectValue>(ReadObject(itr));
+        void EndString()
+        {
+            out.Put('"');
 
-                case 't':
-                {
-                    if( TryReadExpectedString(itr, "true") )
-                        return CreateValue<BooleanValue>(true);
-                }
-                break;
+            if( stringIsKey )
+                state = State::Colon;
+            else
+                ValueDone();
+        }
 
-                case 'f':
+        // The escape is decoded only to check it; its text is copied.
+        void CopyEscape(const char *const pEscape, const std::size_t length)
+        {
+            CharItr<const char *> itr(pEscape, pEscape + length);
+            scratch.clear();
+            DecodeEscape(itr, scratch);
+
+            out.Put('\\');
+            out.Append(pEscape, length);
+        }
+
+        // Checks the text from a byte above ASCII up to the next special
+        // character and returns that character. If a character is cut off
+        // by the end of the chunk instead, its first byte is returned.
+        static const char *CheckMultiByte(const char *const ptr, const char *const end)
+        {
+            const char *const special = Utf8Validator::FindInString(ptr, end);
+            if( special != nullptr )
+                return special;
+
+            const char *const stop = StringScanner::Find(ptr, end);
+            const char *const cut = stop == end ? FindCutSequence(ptr, end) : stop;
+
+            if( cut == stop || !Utf8Validator::IsValid(ptr, cut) )
+                throw std::runtime_error("invalid UTF-8");
+
+            return cut;
+        }
+
+        const char *ContinueString(const char *ptr, const char *const end)
+        {
+            for( ;; )
+            {
+                const char *special = StringScanner::FindOrMultiByte(ptr, end);
+                if( special != end && static_cast<unsigned char>(*special) >= 0x80 )
+                    special = CheckMultiByte(special, end);
+
+                out.Append(ptr, static_cast<std::size_t>(special - ptr));
+
+                if( special == end )
+                    return end;
+
+                switch( *special )
                 {
-                    if( TryReadExpectedString(itr, "false") )
-                        return CreateValue<BooleanValue>(false);
+                    case '"':
+                        EndString();
+                        return special + 1;
+
+                    case '\\':
+                    {
+                        const char *const pEscape = special + 1;
+                        const std::size_t available = static_cast<std::size_t>(end - pEscape);
+                        const std::size_t length = EscapeLength(pEscape, available);
+
+                        if( available < length )
+                        {
+                            token.assign(pEscape, end);
+                            state = State::Escape;
+                            return end;
+                        }
+
+                        CopyEscape(pEscape, length);
+                        ptr = pEscape + length;
+                        break;
+                    }
+
+                    default:
+                        if( static_cast<unsigned char>(*special) < 0x80 )
+                            throw std::runtime_error("invalid control character in string");
+
+                        sequenceLength = static_cast<std::size_t>(end - special);
+                        std::memcpy(sequence, special, sequenceLength);
+                        state = State::Sequence;
+                        return end;
                 }
-                break;
+            }
+        }
+
+        void ContinueSequence(const char ch)
+        {
+            if( (static_cast<unsigned char>(ch) & 0xC0) != 0x80 )
+                throw std::runtime_error("invalid UTF-8");
+
+            sequence[sequenceLength++] = ch;
+            if( sequenceLength < SequenceLength(static_cast<unsigned char>(sequence[0])) )
+                return;
+
+            if( !Utf8Validator::IsValid(sequence, sequence + sequenceLength) )
+                throw std::runtime_error("invalid UTF-8");
+
+            out.Append(sequence, sequenceLength);
+            state = State::String;
+        }
+
+        void FinishNumber(const char *const ptr, const char *const end)
+        {
+            if( !IsNumber(ptr, end) )
+                throw std::runtime_error("Invalid format");
+
+            out.Append(ptr, static_cast<std::size_t>(end - ptr));
+            ValueDone();
+        }
+
+        // A number that ends inside the chunk is copied from it; only one
+        // split across chunks is collected in token.
+        const char *ContinueNumber(const char *ptr, const char *const end)
+        {
+            const char *const start = ptr;
+            while( ptr != end && IsNumberChar(*ptr) )
+                ++ptr;
+
+            if( ptr != end && token.empty() )
+            {
+                FinishNumber(start, ptr);
+                return ptr;
+            }
+
+            token.append(start, ptr);
+
+            if( ptr != end )
+                FinishNumber(token.data(), token.data() + token.size());
 
+            return ptr;
+        }
+
+        void Close(const char ch)
+        {
+            const ContainerStack::Frame &frame = stack.Top();
+            if( !frame.object && ch != ']' )
+                throw std::runtime_error("']' expected");
+
+            if( frame.object && ch != '}' )
+                throw std::runtime_error("'}' expected");
+
+            const bool items = frame.count != 0;
+            stack.Pop();
+
+            if( options.pretty && items )
+                NewLine();
+
+            out.Put(ch);
+            ValueDone();
+        }
+
+        const char *BeginValue(const char *const ptr, const char *const end)
+        {
+            const char ch = *ptr;
+
+            if( ++nodes > parseOptions.maxNodes )
+                throw std::runtime_error("too many values");
+
+            switch( ch )
+            {
+                case '"':
+                    BeginString(false);
+                    return ptr + 1;
+
+                case '[':
+                case '{':
+                    CheckDepth(stack, parseOptions);
+                    out.Put(ch);
+                    stack.Push(ch == '{');
+                    state = ch == '{' ? State::ObjectFirst : State::ArrayFirst;
+                    return ptr + 1;
+
+                case '-':
+                case TinyJson_Digits_0_9:
+                    token.clear();
+                    state = State::Number;
+                    return ContinueNumber(ptr, end);
+
+                case 't':
+                case 'f':
                 case 'n':
                 {
-                    if( TryReadExpectedString(itr, "null") )
-                        return std::unique_ptr<NullValue>(new NullValue());
+                    pLiteral = ch == 't' ? "true" : ch == 'f' ? "false" : "null";
+                    const std::size_t length = std::strlen(pLiteral);
+
+                    if( static_cast<std::size_t>(end - ptr) >= length )
+                    {
+                        if( std::memcmp(ptr, pLiteral, length) != 0 )
+                            throw std::runtime_error("Invalid format");
+
+                        out.Append(pLiteral, length);
+                        ValueDone();
+                        return ptr + length;
+                    }
+
+                    pExpected = pLiteral + 1;
+                    state = State::Literal;
+                    return ptr + 1;
                 }
-                break;
             }
 
             throw std::runtime_error("Invalid format");
         }
-    };
 
-    template <class Itr>
-    CharItr<Itr> MakeStream(const Itr &begin, const Itr &end)
-    {
-        return CharItr<Itr>(begin, end);
-    }
+        // Reads the token at ptr, which is not whitespace.
+        const char *ReadStructural(const char *const ptr, const char *const end)
+        {
+            const char ch = *ptr;
 
-    inline CharItr<const char *> MakeStream(const char *const pStr)
-    {
-        return MakeStream(pStr, pStr + std::strlen(pStr));
-    }
+            switch( state )
+            {
+                case State::Value:
+                    return BeginValue(ptr, end);
 
-    template <class Itr>
-    ValuePtr Read(CharItr<Itr> &stream)
-    {
-        return Reader<CharItr<Itr>>::ReadValue(stream);
-    }
+                case State::ArrayFirst:
+                    if( ch == ']' )
+                    {
+                        Close(ch);
+                        return ptr + 1;
+                    }
 
-    template <class Itr>
-    ValuePtr Read(const Itr &begin, const Itr &end)
-    {
-        auto stream = MakeStream(begin, end);
-        return Read(stream);
-    }
+                    if( options.pretty )
+                        NewLine();
 
-    inline ValuePtr Read(const char *const pStr)
-    {
-        auto stream = MakeStream(pStr);
-        return Read(stream);
-    }
+                    return BeginValue(ptr, end);
 
-    template <class T>
-    struct ConvertTo;
+                case State::ObjectFirst:
+                    if( ch == '}' )
+                    {
+                        Close(ch);
+                        return ptr + 1;
+                    }
 
-    template <class T>
-    struct ConvertToNumber
-    {
-        static T From(const ValuePtr &value)
-        {
-            return static_cast<T>(value->AsNumber());
-        }
-    };
+                    if( ch != '"' )
+                        throw std::runtime_error("string expected");
 
-#define TinyJson_DefineConvertToNumber(X) \
-    template <> struct ConvertTo<X> : public ConvertToNumber<X> { }
+                    if( options.pretty )
+                        NewLine();
 
-    TinyJson_DefineConvertToNumber(int);
-    TinyJson_DefineConvertToNumber(unsigned int);
-    TinyJson_DefineConvertToNumber(short);
-    TinyJson_DefineConvertToNumber(unsigned short);
-    TinyJson_DefineConvertToNumber(long);
-    TinyJson_DefineConvertToNumber(unsigned long);
-    TinyJson_DefineConvertToNumber(float);
-    TinyJson_DefineConvertToNumber(double);
+                    BeginString(true);
+                    return ptr + 1;
 
-    template <>
-    struct ConvertTo<std::string>
-    {
-        static std::string From(const ValuePtr &value)
+                case State::ObjectKey:
+                    if( ch != '"' )
+                        throw std::runtime_error("string expected");
+
+                    BeginString(true);
+                    return ptr + 1;
+
+                case State::Colon:
+                    if( ch != ':' )
+                        throw std::runtime_error("':' expected");
+
+                    out.Put(':');
+                    if( options.pretty )
+                        out.Put(' ');
+
+                    state = State::Value;
+                    return ptr + 1;
+
+                case State::AfterValue:
+                    if( ch != ',' )
+                    {
+                        Close(ch);
+                        return ptr + 1;
+                    }
+
+                    out.Put(',');
+                    if( options.pretty )
+                        NewLine();
+
+                    state = stack.Top().object ? State::ObjectKey : State::Value;
+                    return ptr + 1;
+
+                default:
+                    throw std::runtime_error("unexpected trailing characters");
+            }
+        }
+
+    public:
+        explicit Transcoder(Sink &sink, const WriteOptions &options_ = WriteOptions(), const ParseOptions &parseOptions_ = ParseOptions()) :
+            out(sink),
+            options(options_),
+            parseOptions(parseOptions_),
+            state(State::Value),
+            sequenceLength(0),
+            stringIsKey(false),
+            pLiteral(nullptr),
+            pExpected(nullptr),
+            nodes(0),
+            inputBytes(0)
         {
-            return value->AsString();
         }
-    };
 
-    template <class Container>
-    struct ConvertToSequenceContainer
-    {
-        static Container From(const ValuePtr &value)
+        Transcoder(const Transcoder &) =delete;
+        void operator =(const Transcoder &) =delete;
+
+        FeedResult Feed(const char *const pData, const std::size_t length)
         {
-            Container result;
+            if( length > parseOptions.maxInputBytes - inputBytes )
+                throw std::runtime_error("input too large");
 
-            const auto &arr = value->AsArray();
-            result.reserve(arr.size());
+            inputBytes += length;
 
-            for( const auto &item: arr )
-                result.push_back(Convert<Container::value_type>(item));
+            const char *ptr = pData;
+            const char *const end = pData + length;
 
-            return result;
-        }
-    };
+            while( ptr != end )
+            {
+                switch( state )
+                {
+                    case State::String:
+                        ptr = ContinueString(ptr, end);
+                        break;
 
-#define TinyJson_DefineConvertToSequenceContainer(X) \
-    template <class T> struct ConvertTo<X<T>> : public ConvertToSequenceContainer<X<T>> { }
+                    case State::Escape:
+                        token.push_back(*ptr++);
+                        if( token.size() >= EscapeLength(token.data(), token.size()) )
+                        {
+                            CopyEscape(token.data(), token.size());
+                            state = State::String;
+                        }
+                        break;
 
-    TinyJson_DefineConvertToSequenceContainer(std::vector);
-    TinyJson_DefineConvertToSequenceContainer(std::deque);
-    TinyJson_DefineConvertToSequenceContainer(std::list);
+                    case State::Sequence:
+                        ContinueSequence(*ptr++);
+                        break;
 
-    template <class Container>
-    struct ConvertToAssociativeContainer
-    {
-        static Container From(const ValuePtr &value)
-        {
-            Container result;
+                    case State::Number:
+                        ptr = ContinueNumber(ptr, end);
+                        break;
 
-            const auto &m = value->AsObject();
-            for( const auto &entry: m )
-                result.emplace(entry.first, Convert<Container::mapped_type>(entry.second));
+                    case State::Literal:
+                        if( *ptr++ != *pExpected++ )
+                            throw std::runtime_error("Invalid format");
 
-            return result;
-        }
-    };
+                        if( *pExpected == 0 )
+                        {
+                            out.Append(pLiteral, static_cast<std::size_t>(pExpected - pLiteral));
+                            ValueDone();
+                        }
+                        break;
 
-#define TinyJson_DefineConvertToAssociativeContainer(X) \
-    template <class T> struct ConvertTo<X<std::string, T>> : public ConvertToAssociativeContainer<X<std::string, T>> { }
+                    default:
+                        ptr = WhitespaceScanner::Skip(ptr, end);
+                        if( ptr != end )
+                            ptr = ReadStructural(ptr, end);
+                        break;
+                }
+            }
 
-    TinyJson_DefineConvertToAssociativeContainer(std::map);
-    TinyJson_DefineConvertToAssociativeContainer(std::unordered_map);
+            return state == State::Done ? FeedResult::Complete : FeedResult::NeedMoreData;
+        }
 
-    template <>
-    struct ConvertTo<bool>
-    {
-        static bool From(const ValuePtr &value)
+        // Signals the end of input and flushes the output to the sink; a
+        // trailing top-level number completes here.
+        void Finish()
         {
-            return value->AsBoolean();
+            if( state == State::Number && stack.Empty() )
+                FinishNumber(token.data(), token.data() + token.size());
+
+            if( state != State::Done )
+                throw std::runtime_error("unexpected end of input");
+
+            out.Flush();
+            out.GetSink().Flush();
         }
-    };
 
-    template <class T, class U>
-    struct ConvertTo<std::pair<T, U>>
-    {
-        static std::pair<T, U> From(const ValuePtr &value)
+        bool IsComplete() const
         {
-            const auto &arr = value->AsArray();
-            if( arr.size() != 2 )
-                throw std::runtime_error("pair must contain exactly two items");
+            return state == State::Done;
+        }
 
-            return std::make_pair(Convert<T>(arr[0]), Convert<U>(arr[1]));
+        // Starts a new document. Output of an unfinished one that is still
+        // buffered is dropped; what has reached the sink stays there.
+        void Reset()
+        {
+            out.Clear();
+            state = State::Value;
+            stack.Clear();
+            token.clear();
+            nodes = 0;
+            inputBytes = 0;
         }
     };
 
-    template <class T>
-    T Convert(const ValuePtr &value)
+    // Transcodes all of source into sink, holding one chunk of input at a
+    // time.
+    inline void Transcode(Source &source, Sink &sink, const WriteOptions &options = WriteOptions(), const ParseOptions &parseOptions = ParseOptions())
     {
-        return ConvertTo<T>::From(value);
+        static const std::size_t ChunkSize = 64 * 1024;
+
+        std::unique_ptr<char[]> chunk(new char[ChunkSize]);
+        Transcoder transcoder(sink, options, parseOptions);
+
+        for( std::size_t length; (length = source.Read(chunk.get(), ChunkSize)) != 0; )
+            transcoder.Feed(chunk.get(), length);
+
+        transcoder.Finish();
+    }
+
+    inline void Transcode(const char *const pData, const std::size_t length, Sink &sink, const WriteOptions &options = WriteOptions(), const ParseOptions &parseOptions = ParseOptions())
+    {
+        Transcoder transcoder(sink, options, parseOptions);
+        transcoder.Feed(pData, length);
+        transcoder.Finish();
+    }
+
+    inline std::string Transcode(const std::string &str, const WriteOptions &options = WriteOptions())
+    {
+        std::string result;
+        StringSink sink(result);
+        Transcode(str.data(), str.size(), sink, options);
+
+        return result;
     }
-}
+}
\ No newline at end of file